@@ -0,0 +1,76 @@
+#include "bench.hpp"
+
+#include "lib-optional/kernels.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+const char* kindName(AdaptiveValidity::Kind kind) {
+    switch (kind) {
+    case AdaptiveValidity::Kind::AllValid:
+        return "all-valid";
+    case AdaptiveValidity::Kind::AllNull:
+        return "all-null";
+    case AdaptiveValidity::Kind::Runs:
+        return "runs";
+    case AdaptiveValidity::Kind::Bitmap:
+        return "bitmap";
+    }
+    return "?";
+}
+
+void run(const std::vector<double>& values, double density, std::size_t rounds) {
+    const std::size_t rows = values.size();
+    std::vector<std::uint64_t> bitmap(detail::wordCount(rows));
+    std::mt19937_64 random(42);
+    std::bernoulli_distribution engaged(density);
+    for (std::size_t i = 0; i < rows; ++i) {
+        if (engaged(random)) {
+            detail::setBit(bitmap.data(), i);
+        }
+    }
+    const OptionalSpan<double> span(values.data(), bitmap.data(), rows);
+    const AdaptiveValidity validity = AdaptiveValidity::encode(span);
+
+    auto start = bench::Clock::now();
+    for (std::size_t round = 0; round < rounds; ++round) {
+        bench::doNotOptimize(sum(span, 0.0));
+    }
+    const double bitmapSeconds = bench::secondsSince(start) / double(rounds);
+    start = bench::Clock::now();
+    for (std::size_t round = 0; round < rounds; ++round) {
+        bench::doNotOptimize(sum(values.data(), validity, 0.0));
+    }
+    const double adaptiveSeconds = bench::secondsSince(start) / double(rounds);
+
+    std::printf("%8.3f%% %10s %12.1f %12.1f %14.3f %14.3f\n",
+                density * 100.0,
+                kindName(validity.kind()),
+                double(bitmap.size() * sizeof(std::uint64_t)) / 1024.0,
+                double(validity.byteSize()) / 1024.0,
+                bitmapSeconds * 1e9 / double(rows),
+                adaptiveSeconds * 1e9 / double(rows));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rows = bench::argument(argc, argv, "rows", 4000000);
+    const std::size_t rounds = bench::argument(argc, argv, "rounds", 20);
+    std::vector<double> values(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        values[i] = double(i % 1000) * 0.5;
+    }
+    std::printf("%zu rows, sum() per row\n", rows);
+    std::printf("%9s %10s %12s %12s %14s %14s\n", "density", "form", "bitmap KiB", "adaptive KiB",
+                "bitmap ns/row", "adaptive ns/row");
+    for (double density : { 0.0, 0.0001, 0.001, 0.01, 0.5, 0.99, 0.999, 0.9999, 1.0 }) {
+        run(values, density, rounds);
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "bench.hpp"
+
+#include "lib-optional/arrow.hpp"
+#include "lib-optional/kernels.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace libOptional;
+
+int main(int argc, char** argv) {
+    const std::size_t rows = bench::argument(argc, argv, "rows", 10000000);
+    std::vector<Optional<double>> optionals(rows);
+    std::vector<double> values(rows);
+    std::vector<std::uint64_t> validity(detail::wordCount(rows));
+    for (std::size_t i = 0; i < rows; ++i) {
+        if (i % 7 != 0) {
+            optionals[i] = double(i);
+            values[i] = double(i);
+            detail::setBit(validity.data(), i);
+        }
+    }
+    std::printf("%zu rows of Optional<double>\n", rows);
+
+    // Converting the interleaved vector<Optional<T>> layout has to build both buffers
+    auto start = bench::Clock::now();
+    ArrowArray converted;
+    exportArrow(optionals, &converted);
+    const double convertSeconds = bench::secondsSince(start);
+
+    // Values and bitmap are handed over as they are
+    start = bench::Clock::now();
+    ArrowArray moved;
+    exportArrow(std::move(values), std::move(validity), &moved);
+    const double exportSeconds = bench::secondsSince(start);
+
+    start = bench::Clock::now();
+    ImportedArrowArray<double> imported(&moved);
+    const double importSeconds = bench::secondsSince(start);
+    bench::doNotOptimize(sum(imported.span(), 0.0));
+    converted.release(&converted);
+
+    std::printf("vector<Optional<double>> conversion: %10.3f ms\n", convertSeconds * 1e3);
+    std::printf("zero-copy export (incl. null count): %9.3f ms\n", exportSeconds * 1e3);
+    std::printf("zero-copy import:                    %9.3f ms\n", importSeconds * 1e3);
+    return 0;
+}
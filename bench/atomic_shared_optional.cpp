@@ -0,0 +1,118 @@
+#include "bench.hpp"
+
+#include "lib-optional/atomic_shared_optional.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+using Payload = std::vector<std::uint64_t>;
+
+class HazardShared {
+public:
+    void store(Payload&& payload) { mShared.store(std::move(payload)); }
+
+    std::uint64_t read() const {
+        auto handle = mShared.load();
+        return handle ? handle->back() : 0;
+    }
+
+private:
+    AtomicSharedOptional<Payload> mShared;
+};
+
+/// The usual pattern: copy a shared_ptr under a mutex
+class MutexSharedPtr {
+public:
+    void store(Payload&& payload) {
+        std::shared_ptr<const Payload> next = std::make_shared<const Payload>(std::move(payload));
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShared.swap(next);
+    }
+
+    std::uint64_t read() const {
+        std::shared_ptr<const Payload> local;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            local = mShared;
+        }
+        return local ? local->back() : 0;
+    }
+
+private:
+    mutable std::mutex mMutex;
+    std::shared_ptr<const Payload> mShared;
+};
+
+/// std::atomic_load/std::atomic_store on a shared_ptr
+class AtomicSharedPtr {
+public:
+    void store(Payload&& payload) {
+        std::atomic_store(&mShared, std::make_shared<const Payload>(std::move(payload)));
+    }
+
+    std::uint64_t read() const {
+        std::shared_ptr<const Payload> local = std::atomic_load(&mShared);
+        return local ? local->back() : 0;
+    }
+
+private:
+    std::shared_ptr<const Payload> mShared;
+};
+
+/// Total reads per second of \p readers threads while one writer publishes every millisecond
+template <typename TShared>
+double run(std::size_t readers, std::size_t millis) {
+    TShared shared;
+    shared.store(Payload(4096, 1));
+    std::atomic<bool> done{ false };
+    std::atomic<std::uint64_t> reads{ 0 };
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < readers; ++i) {
+        threads.emplace_back([&] {
+            std::uint64_t count = 0;
+            std::uint64_t checksum = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                checksum += shared.read();
+                ++count;
+            }
+            bench::doNotOptimize(checksum);
+            reads += count;
+        });
+    }
+    const auto start = bench::Clock::now();
+    for (std::uint64_t version = 2; bench::secondsSince(start) * 1e3 < double(millis); ++version) {
+        shared.store(Payload(4096, version));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    done = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return double(reads.load()) / bench::secondsSince(start);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t maxReaders = bench::argument(argc, argv, "readers", 64);
+    const std::size_t millis = bench::argument(argc, argv, "millis", 300);
+    std::printf("%u hardware threads, 32 KiB payload, one writer publishing every 1 ms\n",
+                std::thread::hardware_concurrency());
+    std::printf("%8s %22s %22s %22s\n", "readers", "hazard Mreads/s", "mutex+shared_ptr", "atomic_load");
+    for (std::size_t readers = 1; readers <= maxReaders; readers *= 2) {
+        std::printf("%8zu %22.2f %22.2f %22.2f\n",
+                    readers,
+                    run<HazardShared>(readers, millis) / 1e6,
+                    run<MutexSharedPtr>(readers, millis) / 1e6,
+                    run<AtomicSharedPtr>(readers, millis) / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef UTILS_BENCH_HPP_
+#define UTILS_BENCH_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// Minimal helpers shared by the benchmark executables, so they don't need any dependency
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+inline double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+inline double nanosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+/// Value of the \p p-th percentile (0-100) of \p samples, the samples get sorted
+inline double percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    const std::size_t index = std::min(samples.size() - 1, std::size_t(p / 100.0 * double(samples.size())));
+    return samples[index];
+}
+
+/// Reads an unsigned integer passed as `--name=value`, returns \p fallback if missing
+inline std::size_t argument(int argc, char** argv, const char* name, std::size_t fallback) {
+    const std::string prefix = std::string("--") + name + "=";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], prefix.c_str(), prefix.size()) == 0) {
+            return std::strtoull(argv[i] + prefix.size(), nullptr, 10);
+        }
+    }
+    return fallback;
+}
+
+} // namespace bench
+
+#endif // UTILS_BENCH_HPP_
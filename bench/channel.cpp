@@ -0,0 +1,115 @@
+#include "bench.hpp"
+
+#include "lib-optional/channel.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+/// The baseline: a deque guarded by a mutex with a condition variable
+class MutexChannel {
+public:
+    explicit MutexChannel(std::size_t) {}
+
+    void send(std::uint64_t value) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mItems.push_back(value);
+        }
+        mCondition.notify_one();
+    }
+
+    Optional<std::uint64_t> receive() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this] { return !mItems.empty(); });
+        const std::uint64_t value = mItems.front();
+        mItems.pop_front();
+        return value;
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<std::uint64_t> mItems;
+};
+
+/// Round-trip times of \p rounds messages bounced between two threads
+template <typename TChannel>
+std::vector<double> pingPong(std::size_t rounds, std::size_t spinCount) {
+    TChannel ping(spinCount), pong(spinCount);
+    std::thread echo([&] {
+        for (std::size_t i = 0; i < rounds; ++i) {
+            pong.send(*ping.receive());
+        }
+    });
+    std::vector<double> samples;
+    samples.reserve(rounds);
+    for (std::size_t i = 0; i < rounds; ++i) {
+        const auto start = bench::Clock::now();
+        ping.send(i);
+        bench::doNotOptimize(*pong.receive());
+        samples.push_back(bench::nanosecondsSince(start));
+    }
+    echo.join();
+    return samples;
+}
+
+/// Messages per second of \p producers threads sending \p messages in total to one receiver
+template <typename TChannel>
+double throughput(std::size_t producers, std::size_t messages) {
+    TChannel channel(1000);
+    const std::size_t perProducer = messages / producers;
+    const auto start = bench::Clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&channel, perProducer] {
+            for (std::size_t i = 0; i < perProducer; ++i) {
+                channel.send(i);
+            }
+        });
+    }
+    for (std::size_t i = 0; i < producers * perProducer; ++i) {
+        bench::doNotOptimize(*channel.receive());
+    }
+    const double seconds = bench::secondsSince(start);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return double(producers * perProducer) / seconds;
+}
+
+void report(const char* name, std::vector<double> samples) {
+    std::printf("%-28s %10.0f %10.0f %10.0f\n",
+                name,
+                bench::percentile(samples, 50),
+                bench::percentile(samples, 99),
+                bench::percentile(samples, 99.9));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rounds = bench::argument(argc, argv, "rounds", 100000);
+    std::printf("%u hardware threads, %zu round trips\n", std::thread::hardware_concurrency(), rounds);
+    std::printf("%-28s %10s %10s %10s\n", "round trip ns", "p50", "p99", "p99.9");
+    report("Channel, spin then park", pingPong<Channel<std::uint64_t>>(rounds, 1000));
+    report("Channel, park immediately", pingPong<Channel<std::uint64_t>>(rounds, 0));
+    report("mutex + condition variable", pingPong<MutexChannel>(rounds, 0));
+
+    const std::size_t messages = bench::argument(argc, argv, "messages", 2000000);
+    std::printf("\n%-28s %10s %10s\n", "Mmsg/s, one receiver", "Channel", "mutex");
+    for (std::size_t producers = 1; producers <= 64; producers *= 2) {
+        std::printf("%3zu producers %24.2f %10.2f\n",
+                    producers,
+                    throughput<Channel<std::uint64_t>>(producers, messages) / 1e6,
+                    throughput<MutexChannel>(producers, messages) / 1e6);
+    }
+    return 0;
+}
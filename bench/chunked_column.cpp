@@ -0,0 +1,81 @@
+#include "bench.hpp"
+
+#include "lib-optional/chunked_column.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+/// Appends \p rows rows and returns the latency of every append in nanoseconds
+template <typename TAppend>
+std::vector<double> measure(std::size_t rows, TAppend&& append) {
+    std::vector<double> samples;
+    samples.reserve(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        const auto start = bench::Clock::now();
+        append(i);
+        samples.push_back(bench::nanosecondsSince(start));
+    }
+    return samples;
+}
+
+void report(const char* name, std::vector<double> samples) {
+    double total = 0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    const double mean = total / double(samples.size());
+    const double p50 = bench::percentile(samples, 50);
+    const double p99 = bench::percentile(samples, 99);
+    const double p9999 = bench::percentile(samples, 99.99);
+    const double worst = samples.back();
+    std::printf("%-34s mean %7.1f ns  p50 %7.1f ns  p99 %7.1f ns  p99.99 %10.1f ns  max %12.1f ns\n",
+                name,
+                mean,
+                p50,
+                p99,
+                p9999,
+                worst);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rows = bench::argument(argc, argv, "rows", 20000000);
+    std::printf("append latency, %zu rows, every 7th row is null\n", rows);
+
+    {
+        std::vector<Optional<std::int64_t>> column;
+        report("std::vector<Optional<int64_t>>", measure(rows, [&](std::size_t i) {
+                   column.push_back(i % 7 == 0 ? Optional<std::int64_t>() : Optional<std::int64_t>(i));
+               }));
+        bench::doNotOptimize(column.data());
+    }
+    {
+        ChunkedColumn<std::int64_t> column;
+        report("ChunkedColumn<int64_t>", measure(rows, [&](std::size_t i) {
+                   if (i % 7 == 0) {
+                       column.appendNull();
+                   } else {
+                       column.append(std::int64_t(i));
+                   }
+               }));
+        bench::doNotOptimize(column.size());
+    }
+    {
+        ChunkedColumn<std::int64_t> column;
+        column.reserve(rows);
+        report("ChunkedColumn<int64_t> (reserved)", measure(rows, [&](std::size_t i) {
+                   if (i % 7 == 0) {
+                       column.appendNull();
+                   } else {
+                       column.append(std::int64_t(i));
+                   }
+               }));
+        bench::doNotOptimize(column.size());
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "bench.hpp"
+
+#include "lib-optional/chunked_column.hpp"
+#include "lib-optional/column_file.hpp"
+#include "lib-optional/kernels.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace libOptional;
+
+int main(int argc, char** argv) {
+    const std::size_t rows = bench::argument(argc, argv, "rows", 50000000);
+    const std::string path = "lib-optional-bench.col";
+
+    {
+        ChunkedColumn<std::int64_t> column;
+        for (std::size_t i = 0; i < rows; ++i) {
+            column.append(i % 7 == 0 ? Optional<std::int64_t>() : Optional<std::int64_t>(i));
+        }
+        const auto start = bench::Clock::now();
+        writeColumnFile(path, column);
+        std::printf("write %zu rows: %.3f s\n", rows, bench::secondsSince(start));
+    }
+
+    {
+        // Baseline: materialize the whole file into a vector of Optionals
+        const auto start = bench::Clock::now();
+        MappedColumn<std::int64_t> mapped(path);
+        std::vector<Optional<std::int64_t>> vector;
+        vector.reserve(mapped.size());
+        for (std::size_t i = 0; i < mapped.size(); ++i) {
+            vector.push_back(mapped.span()[i]);
+        }
+        const double loaded = bench::secondsSince(start);
+        std::int64_t total = 0;
+        for (const Optional<std::int64_t>& value : vector) {
+            total += value.valueOr(0);
+        }
+        std::printf("vector<Optional<int64_t>>: ready after %.3f s, ready + sum %.3f s (sum %lld)\n",
+                    loaded,
+                    bench::secondsSince(start),
+                    static_cast<long long>(total));
+    }
+
+    {
+        const auto start = bench::Clock::now();
+        MappedColumn<std::int64_t> mapped(path);
+        const double opened = bench::secondsSince(start);
+        const std::int64_t total = sum(mapped.span());
+        const double summed = bench::secondsSince(start);
+        const bool valid = mapped.verify();
+        std::printf("MappedColumn<int64_t>:     ready after %.6f s, ready + sum %.3f s (sum %lld), "
+                    "verify %.3f s (%s)\n",
+                    opened,
+                    summed,
+                    static_cast<long long>(total),
+                    bench::secondsSince(start) - summed,
+                    valid ? "ok" : "corrupted");
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "bench.hpp"
+
+#include "lib-optional/chunked_column.hpp"
+#include "lib-optional/column_stream.hpp"
+#include "lib-optional/kernels.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace libOptional;
+
+namespace {
+
+double peakMegabytes() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return double(usage.ru_maxrss) / 1024.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rows = bench::argument(argc, argv, "rows", 100000000);
+    const std::size_t blockRows = bench::argument(argc, argv, "block", 1 << 16);
+    const std::string path = "lib-optional-bench-stream.col";
+
+    // The file is generated by a child process, so its memory doesn't count towards our peak RSS
+    const pid_t child = ::fork();
+    if (child == 0) {
+        ChunkedColumn<std::int64_t> column;
+        for (std::size_t i = 0; i < rows; ++i) {
+            column.append(i % 7 == 0 ? Optional<std::int64_t>() : Optional<std::int64_t>(i));
+        }
+        writeColumnFile(path, column, blockRows);
+        std::_Exit(0);
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    if (child < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::fprintf(stderr, "Failed to generate %s\n", path.c_str());
+        return 1;
+    }
+    // Peak RSS only grows, so the constant-memory reader has to go first
+    const double baseline = peakMegabytes();
+    std::printf("%zu rows, %zu rows per block, initial peak RSS %.1f MB\n", rows, blockRows, baseline);
+
+    {
+        const auto start = bench::Clock::now();
+        ColumnFileStream<std::int64_t> stream(path);
+        std::int64_t total = 0;
+        while (Optional<OptionalSpan<std::int64_t>> block = stream.next()) {
+            total += sum(*block);
+        }
+        std::printf("ColumnFileStream:          %.3f s, sum %lld, peak RSS +%.1f MB\n",
+                    bench::secondsSince(start),
+                    static_cast<long long>(total),
+                    peakMegabytes() - baseline);
+    }
+
+    {
+        const auto start = bench::Clock::now();
+        ColumnFileStream<std::int64_t> stream(path);
+        std::vector<Optional<std::int64_t>> vector;
+        vector.reserve(stream.size());
+        while (Optional<OptionalSpan<std::int64_t>> block = stream.next()) {
+            for (std::size_t i = 0; i < block->size(); ++i) {
+                vector.push_back((*block)[i]);
+            }
+        }
+        std::int64_t total = 0;
+        for (const Optional<std::int64_t>& value : vector) {
+            total += value.valueOr(0);
+        }
+        std::printf("vector<Optional<int64_t>>: %.3f s, sum %lld, peak RSS +%.1f MB\n",
+                    bench::secondsSince(start),
+                    static_cast<long long>(total),
+                    peakMegabytes() - baseline);
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
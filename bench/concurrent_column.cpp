@@ -0,0 +1,70 @@
+#include "bench.hpp"
+
+#include "lib-optional/concurrent_column.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+/// Runs \p producers threads calling \p produce(thread, batch) \p batches times and returns rows/s
+template <typename TProduce>
+double run(std::size_t producers, std::size_t batches, std::size_t batchSize, TProduce&& produce) {
+    std::vector<std::thread> threads;
+    const auto start = bench::Clock::now();
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::vector<Optional<std::int64_t>> rows(batchSize);
+            for (std::size_t i = 0; i < batchSize; ++i) {
+                rows[i] = i % 7 == 0 ? Optional<std::int64_t>() : Optional<std::int64_t>(i + p);
+            }
+            for (std::size_t b = 0; b < batches; ++b) {
+                produce(rows);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return double(producers * batches * batchSize) / bench::secondsSince(start);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rows = bench::argument(argc, argv, "rows", 1 << 24);
+    const std::size_t batchSize = bench::argument(argc, argv, "batch", 16);
+    const std::size_t maxProducers = bench::argument(argc, argv, "producers", 64);
+    std::printf("%zu rows appended in batches of %zu rows, hardware threads: %u\n",
+                rows,
+                batchSize,
+                std::thread::hardware_concurrency());
+    std::printf("%10s %24s %24s\n", "producers", "mutex+vector [Mrows/s]", "ConcurrentColumn [Mrows/s]");
+
+    for (std::size_t producers = 1; producers <= maxProducers; producers *= 2) {
+        const std::size_t batches = rows / batchSize / producers;
+
+        std::vector<Optional<std::int64_t>> vector;
+        vector.reserve(rows);
+        std::mutex mutex;
+        const double locked =
+            run(producers, batches, batchSize, [&](const std::vector<Optional<std::int64_t>>& batch) {
+                std::lock_guard<std::mutex> lock(mutex);
+                vector.insert(vector.end(), batch.begin(), batch.end());
+            });
+
+        ConcurrentColumn<std::int64_t> column(rows);
+        const double lockFree =
+            run(producers, batches, batchSize, [&](const std::vector<Optional<std::int64_t>>& batch) {
+                column.append(batch.begin(), batch.end());
+            });
+        bench::doNotOptimize(column.size());
+
+        std::printf("%10zu %24.1f %24.1f\n", producers, locked / 1e6, lockFree / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "bench.hpp"
+
+#include "lib-optional/csv_reader.hpp"
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+std::string makeCsv(std::size_t rows, double density) {
+    std::mt19937_64 random(42);
+    std::bernoulli_distribution engaged(density);
+    std::uniform_int_distribution<std::int64_t> ids(0, 1LL << 40);
+    std::uniform_int_distribution<int> cents(0, 10000000);
+    std::string text = "id,price,quantity\n";
+    char field[32];
+    for (std::size_t i = 0; i < rows; ++i) {
+        if (engaged(random)) {
+            text += std::to_string(ids(random));
+        }
+        text += ',';
+        if (engaged(random)) {
+            const int value = cents(random);
+            std::snprintf(field, sizeof(field), "%d.%02d", value / 100, value % 100);
+            text += field;
+        }
+        text += ',';
+        if (engaged(random)) {
+            text += std::to_string(cents(random) % 1000);
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+/// Line by line with std::getline, std::stoll/std::stod per field and a branch for empty fields
+double naive(const std::string& text,
+             ChunkedColumn<std::int64_t>& ids,
+             ChunkedColumn<double>& prices,
+             ChunkedColumn<std::int64_t>& quantities) {
+    const auto start = bench::Clock::now();
+    std::istringstream input(text);
+    std::string line, field;
+    std::getline(input, line);
+    while (std::getline(input, line)) {
+        std::istringstream fields(line);
+        std::getline(fields, field, ',');
+        field.empty() ? ids.appendNull() : ids.append(std::int64_t(std::stoll(field)));
+        std::getline(fields, field, ',');
+        field.empty() ? prices.appendNull() : prices.append(std::stod(field));
+        std::getline(fields, field, ',');
+        field.empty() ? quantities.appendNull() : quantities.append(std::int64_t(std::stoll(field)));
+    }
+    return bench::secondsSince(start);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rows = bench::argument(argc, argv, "rows", 2000000);
+    std::printf("%zu rows of id,price,quantity, single thread\n", rows);
+    std::printf("%9s %10s %16s %16s\n", "density", "MB", "naive MB/s", "loadCsv MB/s");
+    for (double density : { 0.1, 0.5, 0.9, 1.0 }) {
+        const std::string text = makeCsv(rows, density);
+
+        ChunkedColumn<std::int64_t> ids, quantities;
+        ChunkedColumn<double> prices;
+        const double naiveSeconds = naive(text, ids, prices, quantities);
+
+        ChunkedColumn<std::int64_t> fastIds, fastQuantities;
+        ChunkedColumn<double> fastPrices;
+        std::vector<CsvColumn> columns = { CsvColumn::int64(fastIds),
+                                           CsvColumn::float64(fastPrices),
+                                           CsvColumn::int64(fastQuantities) };
+        const CsvStats stats = loadCsv(text.data(), text.size(), columns);
+        if (stats.rows != rows || fastPrices.size() != prices.size()) {
+            std::printf("row count mismatch\n");
+            return 1;
+        }
+
+        std::printf("%8.0f%% %10.1f %16.1f %16.1f\n",
+                    density * 100.0,
+                    double(text.size()) / 1e6,
+                    double(text.size()) / naiveSeconds / 1e6,
+                    stats.megabytesPerSecond());
+    }
+    return 0;
+}
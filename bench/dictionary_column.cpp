@@ -0,0 +1,74 @@
+#include "bench.hpp"
+
+#include "lib-optional/dictionary_column.hpp"
+
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace libOptional;
+
+int main(int argc, char** argv) {
+    const std::size_t rows = bench::argument(argc, argv, "rows", 5000000);
+    const std::vector<std::string> venues = {
+        "XNAS", "XNYS", "ARCX", "BATS", "IEXG", "EDGX", "MEMX", "XCHI"
+    };
+    std::mt19937 random(7);
+
+    std::vector<Optional<std::string>> plain;
+    plain.reserve(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        const std::size_t pick = random() % (venues.size() + 1);
+        if (pick == venues.size()) {
+            plain.push_back(Optional<std::string>());
+        } else {
+            plain.push_back(venues[pick] + "-primary-venue");
+        }
+    }
+    auto start = bench::Clock::now();
+    DictionaryColumn column(plain.begin(), plain.end());
+    std::printf("%zu rows, %zu distinct values, encoded in %.3f s\n",
+                rows,
+                column.dictionarySize(),
+                bench::secondsSince(start));
+    std::printf("row storage: vector<Optional<string>> %.1f MB + heap, DictionaryColumn %.1f MB\n",
+                double(rows * sizeof(Optional<std::string>)) / 1e6,
+                double(rows * sizeof(DictionaryColumn::Code)) / 1e6);
+
+    std::vector<std::uint64_t> selection(detail::wordCount(rows));
+    start = bench::Clock::now();
+    std::size_t plainMatches = 0;
+    for (const Optional<std::string>& value : plain) {
+        plainMatches += value && *value == "XNAS-primary-venue" ? 1 : 0;
+    }
+    const double plainFilter = bench::secondsSince(start);
+    start = bench::Clock::now();
+    const std::size_t codeMatches = column.filterEqual("XNAS-primary-venue", selection.data());
+    const double codeFilter = bench::secondsSince(start);
+    std::printf("filter == value: Optional<string> %.2f ns/row, codes %.2f ns/row (%zu / %zu matches)\n",
+                plainFilter * 1e9 / double(rows),
+                codeFilter * 1e9 / double(rows),
+                plainMatches,
+                codeMatches);
+
+    start = bench::Clock::now();
+    std::unordered_map<std::string, std::size_t> plainGroups;
+    for (const Optional<std::string>& value : plain) {
+        if (value) {
+            ++plainGroups[*value];
+        }
+    }
+    const double plainGroupBy = bench::secondsSince(start);
+    start = bench::Clock::now();
+    const std::vector<std::size_t> counts = column.countByCode();
+    const double codeGroupBy = bench::secondsSince(start);
+    bench::doNotOptimize(counts.data());
+    std::printf("group-by count:  Optional<string> %.2f ns/row, codes %.2f ns/row (%zu / %zu groups)\n",
+                plainGroupBy * 1e9 / double(rows),
+                codeGroupBy * 1e9 / double(rows),
+                plainGroups.size(),
+                counts.size());
+    return 0;
+}
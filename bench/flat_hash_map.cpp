@@ -0,0 +1,107 @@
+#include "bench.hpp"
+
+#include "lib-optional/flat_hash_map.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+/// The baseline: std::unordered_map looked up through find() and end()
+class UnorderedMapAdapter {
+public:
+    void insert(std::uint64_t key, std::uint64_t value) { mMap.emplace(key, value); }
+
+    Optional<std::uint64_t&> find(std::uint64_t key) {
+        const auto it = mMap.find(key);
+        if (it == mMap.end()) {
+            return NullOptional;
+        }
+        return it->second;
+    }
+
+    void erase(std::uint64_t key) { mMap.erase(key); }
+
+private:
+    std::unordered_map<std::uint64_t, std::uint64_t> mMap;
+};
+
+class FlatHashMapAdapter {
+public:
+    void insert(std::uint64_t key, std::uint64_t value) { mMap.tryEmplace(key, value); }
+
+    Optional<std::uint64_t&> find(std::uint64_t key) { return mMap.find(key); }
+
+    void erase(std::uint64_t key) { mMap.erase(key); }
+
+private:
+    FlatHashMap<std::uint64_t, std::uint64_t> mMap;
+};
+
+template <typename TMap>
+void run(const char* name, const std::vector<std::uint64_t>& keys, const std::vector<std::uint64_t>& probes) {
+    const std::size_t count = keys.size() / 2;
+    TMap map;
+    auto start = bench::Clock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+        map.insert(keys[i], i);
+    }
+    const double insertNs = bench::nanosecondsSince(start) / double(count);
+
+    // Probes of present keys, then of absent ones from the second half of the keys
+    std::uint64_t sum = 0;
+    start = bench::Clock::now();
+    for (const std::uint64_t probe : probes) {
+        Optional<std::uint64_t&> value = map.find(keys[probe % count]);
+        sum += value ? *value : 0;
+    }
+    const double hitNs = bench::nanosecondsSince(start) / double(probes.size());
+
+    start = bench::Clock::now();
+    for (const std::uint64_t probe : probes) {
+        sum += map.find(keys[count + probe % count]) ? 1 : 0;
+    }
+    const double missNs = bench::nanosecondsSince(start) / double(probes.size());
+
+    start = bench::Clock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+        map.erase(keys[i]);
+    }
+    const double eraseNs = bench::nanosecondsSince(start) / double(count);
+    bench::doNotOptimize(sum);
+
+    std::printf("%-14s %9zu entries  insert %6.1f ns  find hit %6.1f ns  find miss %6.1f ns"
+                "  erase %6.1f ns\n",
+                name,
+                count,
+                insertNs,
+                hitNs,
+                missNs,
+                eraseNs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t maxCount = bench::argument(argc, argv, "max", 10000000);
+    const std::size_t probeCount = bench::argument(argc, argv, "probes", 2000000);
+    std::mt19937_64 random(42);
+    std::vector<std::uint64_t> probes(probeCount);
+    for (std::uint64_t& probe : probes) {
+        probe = random();
+    }
+    for (std::size_t count = 1000; count <= maxCount; count *= 10) {
+        std::vector<std::uint64_t> keys(2 * count);
+        for (std::uint64_t& key : keys) {
+            key = random();
+        }
+        run<UnorderedMapAdapter>("unordered_map", keys, probes);
+        run<FlatHashMapAdapter>("FlatHashMap", keys, probes);
+    }
+    return 0;
+}
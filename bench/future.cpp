@@ -0,0 +1,73 @@
+#include "bench.hpp"
+
+#include "lib-optional/future.hpp"
+
+#include <cstdint>
+#include <future>
+
+using namespace libOptional;
+
+namespace {
+
+void report(const char* name, double seconds, std::size_t count, std::uint64_t checksum) {
+    std::printf("%-32s %8.3f s %8.1f ns/completion  (checksum %llu)\n",
+                name,
+                seconds,
+                seconds * 1e9 / double(count),
+                static_cast<unsigned long long>(checksum));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = bench::argument(argc, argv, "count", 10000000);
+    std::printf("%zu completions\n", count);
+
+    {
+        std::uint64_t sum = 0;
+        const auto start = bench::Clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            std::promise<std::uint64_t> promise;
+            std::future<std::uint64_t> future = promise.get_future();
+            promise.set_value(i);
+            sum += future.get();
+        }
+        report("std::promise + get", bench::secondsSince(start), count, sum);
+    }
+    {
+        std::uint64_t sum = 0;
+        const auto start = bench::Clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            Promise<std::uint64_t> promise;
+            Future<std::uint64_t> future = promise.getFuture();
+            bench::doNotOptimize(promise);
+            promise.setValue(i);
+            sum += *future.tryGet();
+        }
+        report("Promise + tryGet", bench::secondsSince(start), count, sum);
+    }
+    {
+        std::uint64_t sum = 0;
+        const auto start = bench::Clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            Promise<std::uint64_t> promise;
+            promise.getFuture().then([&sum](std::uint64_t& value) { sum += value; });
+            promise.setValue(i);
+        }
+        report("Promise + continuation", bench::secondsSince(start), count, sum);
+    }
+    {
+        std::uint64_t sum = 0;
+        const auto start = bench::Clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            Promise<std::uint64_t> first;
+            Promise<std::uint64_t> second;
+            Future<std::uint64_t> future =
+                first.getFuture().then(second, [](std::uint64_t& value) { return value * 2; });
+            first.setValue(i);
+            sum += *future.tryGet();
+        }
+        report("Promise + chained continuation", bench::secondsSince(start), count, sum);
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "bench.hpp"
+
+#include "lib-optional/lru_cache.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Session {
+    std::uint64_t user;
+    std::uint64_t expires;
+    double limits[6];
+};
+
+/// The baseline: a std::list in recency order and an unordered_map of iterators into it, two
+/// allocations per insert and a copy per hit
+class ListMapLru {
+public:
+    explicit ListMapLru(std::size_t capacity)
+        : mCapacity(capacity) {
+        mMap.reserve(capacity);
+    }
+
+    Optional<Session> get(std::uint64_t key) {
+        const auto it = mMap.find(key);
+        if (it == mMap.end()) {
+            return NullOptional;
+        }
+        mOrder.splice(mOrder.begin(), mOrder, it->second);
+        return it->second->second;
+    }
+
+    void put(std::uint64_t key, const Session& value) {
+        if (mMap.size() == mCapacity) {
+            mMap.erase(mOrder.back().first);
+            mOrder.pop_back();
+        }
+        mOrder.emplace_front(key, value);
+        mMap[key] = mOrder.begin();
+    }
+
+private:
+    using Order = std::list<std::pair<std::uint64_t, Session>>;
+
+    std::size_t mCapacity;
+    Order mOrder;
+    std::unordered_map<std::uint64_t, Order::iterator> mMap;
+};
+
+template <typename TCache>
+void run(const char* name, std::size_t capacity, const std::vector<std::uint64_t>& keys) {
+    TCache cache(capacity);
+    std::size_t hits = 0;
+    double checksum = 0;
+    const auto start = bench::Clock::now();
+    for (std::uint64_t key : keys) {
+        const auto session = cache.get(key);
+        if (session) {
+            ++hits;
+            checksum += session->limits[0];
+        } else {
+            Session fresh = Session();
+            fresh.user = key;
+            fresh.limits[0] = double(key);
+            cache.put(key, fresh);
+        }
+    }
+    const double seconds = bench::secondsSince(start);
+    std::printf("%-18s %9zu entries %7.1f ns/op  hit rate %6.2f%%  (checksum %.0f)\n",
+                name,
+                capacity,
+                seconds * 1e9 / double(keys.size()),
+                100.0 * double(hits) / double(keys.size()),
+                checksum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t universe = bench::argument(argc, argv, "keys", 10000000);
+    const std::size_t operations = bench::argument(argc, argv, "operations", 10000000);
+
+    // Log-uniform, a few keys are hot and most are cold
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<std::uint64_t> keys(operations);
+    for (std::uint64_t& key : keys) {
+        key = std::uint64_t(std::exp(uniform(random) * std::log(double(universe))));
+    }
+
+    std::printf("%zu keys, %zu get-or-put operations\n", universe, operations);
+    for (std::size_t capacity = 1024; capacity <= 1024 * 1024; capacity *= 32) {
+        run<ListMapLru>("list + map", capacity, keys);
+        run<LruCache<std::uint64_t, Session>>("LruCache", capacity, keys);
+    }
+    return 0;
+}
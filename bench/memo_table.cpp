@@ -0,0 +1,102 @@
+#include "bench.hpp"
+
+#include "lib-optional/memo_table.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+std::atomic<std::uint64_t> computations{ 0 };
+
+/// Stand-in for a pure function that is worth memoizing
+double price(std::uint64_t key) {
+    computations.fetch_add(1, std::memory_order_relaxed);
+    double value = double(key);
+    for (int i = 0; i < 200; ++i) {
+        value = value * 1.0000001 + 0.5;
+    }
+    return value;
+}
+
+/// The baseline: an unordered_map of optionals behind one mutex, computing under the lock
+class MutexMemo {
+public:
+    explicit MutexMemo(std::size_t capacity) { mMap.reserve(capacity); }
+
+    double getOrCompute(std::uint64_t key) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Optional<double>& slot = mMap[key];
+        if (!slot) {
+            slot = price(key);
+        }
+        return *slot;
+    }
+
+private:
+    std::mutex mMutex;
+    std::unordered_map<std::uint64_t, Optional<double>> mMap;
+};
+
+class LockFreeMemo {
+public:
+    explicit LockFreeMemo(std::size_t capacity)
+        : mTable(capacity) {}
+
+    double getOrCompute(std::uint64_t key) { return mTable.getOrCompute(key, &price); }
+
+private:
+    MemoTable<std::uint64_t, double> mTable;
+};
+
+template <typename TMemo>
+void run(const char* name, std::size_t threadCount, std::size_t keys, std::size_t lookups) {
+    TMemo memo(2 * keys);
+    computations = 0;
+    std::vector<std::thread> threads;
+    const auto start = bench::Clock::now();
+    for (std::size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&memo, t, keys, lookups] {
+            std::uint64_t state = 0x9e3779b97f4a7c15ULL * (t + 1);
+            double sum = 0;
+            for (std::size_t i = 0; i < lookups; ++i) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                sum += memo.getOrCompute(state % keys);
+            }
+            bench::doNotOptimize(sum);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double seconds = bench::secondsSince(start);
+    std::printf("%-22s %2zu threads %8.2f Mlookups/s  %llu computations\n",
+                name,
+                threadCount,
+                double(threadCount * lookups) / seconds / 1e6,
+                static_cast<unsigned long long>(computations.load()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t keys = bench::argument(argc, argv, "keys", 1 << 16);
+    const std::size_t lookups = bench::argument(argc, argv, "lookups", 2000000);
+    std::printf("%u hardware threads, %zu keys, %zu lookups per thread\n",
+                std::thread::hardware_concurrency(),
+                keys,
+                lookups);
+    for (std::size_t threads = 1; threads <= 8; threads *= 2) {
+        run<MutexMemo>("mutex + unordered_map", threads, keys, lookups);
+        run<LockFreeMemo>("MemoTable", threads, keys, lookups);
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "bench.hpp"
+
+#include "lib-optional/mpmc_queue.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+/// Push time in nanoseconds since the start of the run
+struct Item {
+    std::uint64_t pushed;
+};
+
+class MutexQueue {
+public:
+    explicit MutexQueue(std::size_t capacity)
+        : mCapacity(capacity) {}
+
+    bool tryPush(const Item& item) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mItems.size() == mCapacity) {
+            return false;
+        }
+        mItems.push_back(item);
+        return true;
+    }
+
+    Optional<Item> tryPop() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mItems.empty()) {
+            return NullOptional;
+        }
+        Item item = mItems.front();
+        mItems.pop_front();
+        return item;
+    }
+
+private:
+    std::size_t mCapacity;
+    std::mutex mMutex;
+    std::deque<Item> mItems;
+};
+
+struct Result {
+    double seconds;
+    double p50;
+    double p99;
+};
+
+template <typename TQueue>
+Result run(std::size_t pairs, std::size_t items) {
+    TQueue queue(1024);
+    const std::size_t perProducer = items / pairs;
+    const std::size_t total = perProducer * pairs;
+    std::atomic<std::size_t> popped{ 0 };
+    std::vector<std::vector<double>> latencies(pairs);
+    std::vector<std::thread> threads;
+    const auto start = bench::Clock::now();
+    for (std::size_t p = 0; p < pairs; ++p) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i < perProducer; ++i) {
+                const Item item{ std::uint64_t(bench::nanosecondsSince(start)) };
+                while (!queue.tryPush(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&, p] {
+            std::vector<double>& samples = latencies[p];
+            std::size_t count = 0;
+            while (popped.load(std::memory_order_relaxed) < total) {
+                Optional<Item> item = queue.tryPop();
+                if (!item) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (++count % 16 == 0) {
+                    samples.push_back(bench::nanosecondsSince(start) - double(item->pushed));
+                }
+                popped.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double seconds = bench::secondsSince(start);
+    std::vector<double> all;
+    for (const std::vector<double>& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    return Result{ seconds / double(total), bench::percentile(all, 50), bench::percentile(all, 99) };
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t items = bench::argument(argc, argv, "items", 1000000);
+    const std::size_t maxPairs = bench::argument(argc, argv, "pairs", 32);
+    std::printf("%u hardware threads, %zu items, capacity 1024\n",
+                std::thread::hardware_concurrency(),
+                items);
+    std::printf("%6s | %10s %12s %12s | %10s %12s %12s\n",
+                "pairs", "MpmcQueue", "p50 ns", "p99 ns", "mutex", "p50 ns", "p99 ns");
+    for (std::size_t pairs = 1; pairs <= maxPairs; pairs *= 2) {
+        const Result queue = run<MpmcQueue<Item>>(pairs, items);
+        const Result mutex = run<MutexQueue>(pairs, items);
+        std::printf("%6zu | %6.1f ns/op %12.0f %12.0f | %6.1f ns/op %12.0f %12.0f\n",
+                    pairs,
+                    queue.seconds * 1e9,
+                    queue.p50,
+                    queue.p99,
+                    mutex.seconds * 1e9,
+                    mutex.p50,
+                    mutex.p99);
+    }
+    return 0;
+}
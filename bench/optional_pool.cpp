@@ -0,0 +1,93 @@
+#include "bench.hpp"
+
+#include "lib-optional/optional_pool.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Order {
+    explicit Order(std::uint64_t id)
+        : id(id) {}
+
+    std::uint64_t id;
+    char payload[248];
+};
+
+const std::size_t Capacity = 1 << 14;
+const std::size_t Held = 64;
+
+using Pool = OptionalPool<Order, Capacity>;
+
+struct HeapAllocator {
+    explicit HeapAllocator(Pool&) {}
+
+    Optional<Order&> acquire(std::uint64_t id) { return *new Order(id); }
+
+    void release(Order& order) { delete &order; }
+};
+
+struct SharedPool {
+    explicit SharedPool(Pool& pool)
+        : pool(pool) {}
+
+    Optional<Order&> acquire(std::uint64_t id) { return pool.acquire(id); }
+
+    void release(Order& order) { pool.release(order); }
+
+    Pool& pool;
+};
+
+/// Every thread repeatedly acquires a batch of objects and releases them again
+template <typename TAllocator>
+void run(const char* name, std::size_t threadCount, std::size_t rounds) {
+    std::unique_ptr<Pool> pool(new Pool());
+    std::vector<std::thread> threads;
+    const auto start = bench::Clock::now();
+    for (std::size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&pool, rounds] {
+            TAllocator allocator(*pool);
+            Order* held[Held];
+            std::uint64_t sum = 0;
+            for (std::size_t round = 0; round < rounds; ++round) {
+                for (std::size_t i = 0; i < Held; ++i) {
+                    held[i] = &*allocator.acquire(round + i);
+                }
+                for (std::size_t i = 0; i < Held; ++i) {
+                    sum += held[i]->id;
+                    allocator.release(*held[i]);
+                }
+            }
+            bench::doNotOptimize(sum);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double seconds = bench::secondsSince(start);
+    std::printf("%-26s %2zu threads %7.1f ns per acquire+release\n",
+                name,
+                threadCount,
+                seconds * 1e9 / double(rounds * Held));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rounds = bench::argument(argc, argv, "rounds", 100000);
+    std::printf("%u hardware threads, %zu-byte objects, %zu held at a time per thread\n",
+                std::thread::hardware_concurrency(),
+                sizeof(Order),
+                Held);
+    for (std::size_t threads = 1; threads <= 4; threads *= 2) {
+        run<HeapAllocator>("new/delete", threads, rounds);
+        run<SharedPool>("OptionalPool", threads, rounds);
+        run<Pool::ThreadCache>("OptionalPool::ThreadCache", threads, rounds);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "bench.hpp"
+
+#include "lib-optional/packed_int_column.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Dataset {
+    const char* name;
+    std::vector<std::int64_t> values;
+    std::vector<std::uint64_t> validity;
+};
+
+template <typename TGenerate>
+Dataset makeDataset(const char* name, std::size_t rows, double density, TGenerate&& generate) {
+    std::mt19937_64 random(42);
+    std::bernoulli_distribution engaged(density);
+    Dataset dataset{
+        name, std::vector<std::int64_t>(rows), std::vector<std::uint64_t>(detail::wordCount(rows))
+    };
+    for (std::size_t i = 0; i < rows; ++i) {
+        if (engaged(random)) {
+            dataset.values[i] = generate(i, random);
+            detail::setBit(dataset.validity.data(), i);
+        }
+    }
+    return dataset;
+}
+
+void run(const Dataset& dataset, std::size_t rounds) {
+    const std::size_t rows = dataset.values.size();
+    const OptionalSpan<std::int64_t> span(dataset.values.data(), dataset.validity.data(), rows);
+
+    auto start = bench::Clock::now();
+    const PackedInt64Column packed = PackedInt64Column::encode(span);
+    const double encodeSeconds = bench::secondsSince(start);
+
+    std::vector<std::int64_t> values(rows);
+    std::vector<std::uint64_t> validity(detail::wordCount(rows));
+    start = bench::Clock::now();
+    for (std::size_t round = 0; round < rounds; ++round) {
+        packed.decode(values.data(), validity.data());
+        bench::doNotOptimize(values.data());
+    }
+    const double decodeSeconds = bench::secondsSince(start) / double(rounds);
+
+    const double decodedBytes = double(rows * sizeof(std::int64_t) + validity.size() * sizeof(std::uint64_t));
+    std::printf("%-26s %6.2f bits/row  ratio vs Optional<int64_t> %7.1fx  vs values+bitmap %6.1fx  "
+                "encode %5.2f GB/s  decode %5.2f GB/s\n",
+                dataset.name,
+                double(packed.byteSize()) * 8 / double(rows),
+                double(rows * sizeof(Optional<std::int64_t>)) / double(packed.byteSize()),
+                decodedBytes / double(packed.byteSize()),
+                decodedBytes / encodeSeconds / 1e9,
+                decodedBytes / decodeSeconds / 1e9);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rows = bench::argument(argc, argv, "rows", 10000000);
+    const std::size_t rounds = bench::argument(argc, argv, "rounds", 10);
+    std::printf("%zu rows\n", rows);
+
+    const auto timestamp = [](std::size_t i, std::mt19937_64& random) {
+        return 1600000000000000000LL + std::int64_t(i) * 1000000 + std::int64_t(random() % 1000);
+    };
+    const auto counter = [](std::size_t, std::mt19937_64& random) { return std::int64_t(random() % 5000); };
+    const auto wide = [](std::size_t, std::mt19937_64& random) { return std::int64_t(random() >> 20); };
+
+    run(makeDataset("dense timestamps", rows, 1.0, timestamp), rounds);
+    run(makeDataset("dense counters", rows, 0.95, counter), rounds);
+    run(makeDataset("sparse timestamps (10%)", rows, 0.1, timestamp), rounds);
+    run(makeDataset("sparse counters (1%)", rows, 0.01, counter), rounds);
+    run(makeDataset("dense 44-bit random", rows, 0.9, wide), rounds);
+    return 0;
+}
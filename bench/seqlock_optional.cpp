@@ -0,0 +1,105 @@
+#include "bench.hpp"
+
+#include "lib-optional/seqlock_optional.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct ConfigSnapshot {
+    std::uint64_t fields[25];
+};
+
+class SharedMutexOptional {
+public:
+    void store(const ConfigSnapshot& value) {
+        std::unique_lock<std::shared_mutex> lock(mMutex);
+        mValue = value;
+    }
+
+    Optional<ConfigSnapshot> load() const {
+        std::shared_lock<std::shared_mutex> lock(mMutex);
+        return mValue;
+    }
+
+private:
+    mutable std::shared_mutex mMutex;
+    Optional<ConfigSnapshot> mValue;
+};
+
+class MutexOptional {
+public:
+    void store(const ConfigSnapshot& value) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mValue = value;
+    }
+
+    Optional<ConfigSnapshot> load() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mValue;
+    }
+
+private:
+    mutable std::mutex mMutex;
+    Optional<ConfigSnapshot> mValue;
+};
+
+/// Total loads per second of \p readers threads while one writer stores every millisecond
+template <typename TShared>
+double run(std::size_t readers, std::size_t millis) {
+    TShared shared;
+    shared.store(ConfigSnapshot());
+    std::atomic<bool> done{ false };
+    std::atomic<std::uint64_t> loads{ 0 };
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < readers; ++i) {
+        threads.emplace_back([&] {
+            std::uint64_t count = 0;
+            std::uint64_t checksum = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                checksum += shared.load()->fields[24];
+                ++count;
+            }
+            bench::doNotOptimize(checksum);
+            loads += count;
+        });
+    }
+    const auto start = bench::Clock::now();
+    ConfigSnapshot snapshot = ConfigSnapshot();
+    while (bench::secondsSince(start) * 1e3 < double(millis)) {
+        ++snapshot.fields[24];
+        shared.store(snapshot);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    done = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return double(loads.load()) / bench::secondsSince(start);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t maxReaders = bench::argument(argc, argv, "readers", 16);
+    const std::size_t millis = bench::argument(argc, argv, "millis", 300);
+    std::printf("%u hardware threads, %zu byte payload, one writer storing every 1 ms\n",
+                std::thread::hardware_concurrency(),
+                sizeof(ConfigSnapshot));
+    std::printf("%8s %18s %18s %18s\n", "readers", "seqlock Mloads/s", "shared_mutex", "mutex");
+    for (std::size_t readers = 1; readers <= maxReaders; readers *= 2) {
+        std::printf("%8zu %18.2f %18.2f %18.2f\n",
+                    readers,
+                    run<SeqlockOptional<ConfigSnapshot>>(readers, millis) / 1e6,
+                    run<SharedMutexOptional>(readers, millis) / 1e6,
+                    run<MutexOptional>(readers, millis) / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "bench.hpp"
+
+#include "lib-optional/serialization.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Record {
+    std::int64_t id;
+    Optional<double> price;
+    Optional<std::int64_t> quantity;
+    Optional<std::int32_t> venue;
+    Optional<double> fee;
+};
+
+/// The previous approach: a bool per field and deserialization through emplace()
+namespace naive {
+
+    template <typename T>
+    void write(BufferWriter& writer, const Optional<T>& value) {
+        const bool present = bool(value);
+        writer.write(&present, sizeof(present));
+        if (present) {
+            writer.write(&*value, sizeof(T));
+        }
+    }
+
+    template <typename T>
+    void read(BufferReader& reader, Optional<T>& value) {
+        bool present;
+        reader.read(&present, sizeof(present));
+        value = Optional<T>();
+        if (present) {
+            T payload;
+            reader.read(&payload, sizeof(T));
+            value.emplace(payload);
+        }
+    }
+
+} // namespace naive
+
+std::vector<Record> makeRecords(std::size_t count) {
+    std::vector<Record> records(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Record& record = records[i];
+        record.id = std::int64_t(i);
+        if (i % 3 != 0) {
+            record.price = double(i) * 0.25;
+        }
+        if (i % 2 == 0) {
+            record.quantity = std::int64_t(i * 10);
+        }
+        if (i % 5 != 0) {
+            record.venue = std::int32_t(i % 17);
+        }
+        if (i % 7 == 0) {
+            record.fee = 0.01;
+        }
+    }
+    return records;
+}
+
+template <typename TWrite, typename TRead>
+void run(const char* name,
+         const std::vector<Record>& records,
+         std::size_t rounds,
+         TWrite&& write,
+         TRead&& read) {
+    std::vector<unsigned char> buffer;
+    buffer.reserve(records.size() * 64);
+    double writeSeconds = 0;
+    for (std::size_t round = 0; round < rounds; ++round) {
+        buffer.clear();
+        BufferWriter writer(buffer);
+        const auto start = bench::Clock::now();
+        for (const Record& record : records) {
+            write(writer, record);
+        }
+        writeSeconds += bench::secondsSince(start);
+        bench::doNotOptimize(buffer.data());
+    }
+
+    std::vector<Record> output(records.size());
+    double readSeconds = 0;
+    for (std::size_t round = 0; round < rounds; ++round) {
+        BufferReader reader(buffer);
+        const auto start = bench::Clock::now();
+        for (Record& record : output) {
+            read(reader, record);
+        }
+        readSeconds += bench::secondsSince(start);
+        bench::doNotOptimize(output.data());
+    }
+
+    const double bytes = double(buffer.size()) * double(rounds);
+    std::printf("%-22s %6.2f bytes/record  serialize %6.2f GB/s  deserialize %6.2f GB/s\n",
+                name,
+                double(buffer.size()) / double(records.size()),
+                bytes / writeSeconds / 1e9,
+                bytes / readSeconds / 1e9);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = bench::argument(argc, argv, "records", 1000000);
+    const std::size_t rounds = bench::argument(argc, argv, "rounds", 10);
+    const std::vector<Record> records = makeRecords(count);
+    std::printf("%zu records with 4 optional fields, %zu rounds\n", count, rounds);
+
+    run("bool + emplace",
+        records,
+        rounds,
+        [](BufferWriter& writer, const Record& r) {
+            writer.write(&r.id, sizeof(r.id));
+            naive::write(writer, r.price);
+            naive::write(writer, r.quantity);
+            naive::write(writer, r.venue);
+            naive::write(writer, r.fee);
+        },
+        [](BufferReader& reader, Record& r) {
+            reader.read(&r.id, sizeof(r.id));
+            naive::read(reader, r.price);
+            naive::read(reader, r.quantity);
+            naive::read(reader, r.venue);
+            naive::read(reader, r.fee);
+        });
+
+    run("presence byte",
+        records,
+        rounds,
+        [](BufferWriter& writer, const Record& r) {
+            serialize(writer, r.id);
+            serialize(writer, r.price);
+            serialize(writer, r.quantity);
+            serialize(writer, r.venue);
+            serialize(writer, r.fee);
+        },
+        [](BufferReader& reader, Record& r) {
+            deserialize(reader, r.id);
+            deserialize(reader, r.price);
+            deserialize(reader, r.quantity);
+            deserialize(reader, r.venue);
+            deserialize(reader, r.fee);
+        });
+
+    run("packed presence bits",
+        records,
+        rounds,
+        [](BufferWriter& writer, const Record& r) {
+            serializeFields(writer, r.id, r.price, r.quantity, r.venue, r.fee);
+        },
+        [](BufferReader& reader, Record& r) {
+            deserializeFields(reader, r.id, r.price, r.quantity, r.venue, r.fee);
+        });
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "bench.hpp"
+
+#include "lib-optional/set_associative_cache.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Quote {
+    double bid;
+    double ask;
+    std::uint64_t volume;
+    std::uint64_t timestamp;
+};
+
+using Store = std::unordered_map<std::uint64_t, Quote>;
+
+void report(const char* name, double seconds, std::size_t lookups, std::size_t hits, double checksum) {
+    std::printf("%-24s %7.2f ns/op  hit rate %6.2f%%  (checksum %.0f)\n",
+                name,
+                seconds * 1e9 / double(lookups),
+                100.0 * double(hits) / double(lookups),
+                checksum);
+}
+
+/// The baseline: every lookup goes to the map and copies the value into an Optional
+void runMap(const Store& store, const std::vector<std::uint64_t>& keys) {
+    double checksum = 0;
+    const auto start = bench::Clock::now();
+    for (std::uint64_t key : keys) {
+        const Store::const_iterator it = store.find(key);
+        Optional<Quote> quote;
+        if (it != store.end()) {
+            quote = it->second;
+        }
+        if (quote) {
+            checksum += quote->bid;
+        }
+    }
+    report("unordered_map::find", bench::secondsSince(start), keys.size(), keys.size(), checksum);
+}
+
+/// The cache sits in front of the map, misses fall through to it and are inserted
+template <std::size_t TWays>
+void runCache(const char* name,
+              const Store& store,
+              const std::vector<std::uint64_t>& keys,
+              std::size_t size) {
+    SetAssociativeCache<std::uint64_t, Quote, TWays> cache(size);
+    std::size_t hits = 0;
+    double checksum = 0;
+    const auto start = bench::Clock::now();
+    for (std::uint64_t key : keys) {
+        Optional<Quote&> quote = cache.lookup(key);
+        if (quote) {
+            ++hits;
+            checksum += quote->bid;
+        } else {
+            checksum += cache.insert(key, store.find(key)->second).bid;
+        }
+    }
+    report(name, bench::secondsSince(start), keys.size(), hits, checksum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t universe = bench::argument(argc, argv, "keys", 1000000);
+    const std::size_t lookups = bench::argument(argc, argv, "lookups", 10000000);
+    const std::size_t cacheSize = bench::argument(argc, argv, "cache", 4096);
+
+    Store store;
+    store.reserve(universe);
+    for (std::uint64_t key = 0; key < universe; ++key) {
+        store[key * 7919] = Quote{ double(key), double(key) + 0.5, key, key };
+    }
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<std::uint64_t> hot(lookups);
+    std::vector<std::uint64_t> skewed(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        // Half as many distinct keys as the cache holds, and a log-uniform spread over all keys
+        hot[i] = std::uint64_t(uniform(random) * double(cacheSize / 2)) * 7919;
+        skewed[i] = (std::uint64_t(std::exp(uniform(random) * std::log(double(universe)))) - 1) * 7919;
+    }
+
+    std::printf("%zu keys, %zu lookups, %zu cache entries\n", universe, lookups, cacheSize);
+    const std::vector<std::uint64_t>* workloads[] = { &hot, &skewed };
+    const char* names[] = { "hot keys", "log-uniform keys" };
+    for (int w = 0; w < 2; ++w) {
+        std::printf("\n%s\n", names[w]);
+        const std::vector<std::uint64_t>& keys = *workloads[w];
+        runMap(store, keys);
+        runCache<1>("direct-mapped", store, keys, cacheSize);
+        runCache<2>("2-way", store, keys, cacheSize);
+        runCache<4>("4-way", store, keys, cacheSize);
+        runCache<8>("8-way", store, keys, cacheSize);
+        runCache<16>("16-way", store, keys, cacheSize);
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "bench.hpp"
+
+#include "lib-optional/slot_map.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Particle {
+    float position[3];
+    float velocity[3];
+};
+
+Particle particle(std::size_t i) {
+    const float f = float(i);
+    return Particle{ { f, f, f }, { 1.0f, 0.5f, 0.25f } };
+}
+
+/// The baseline: optionals addressed by raw indices, free slots found by a linear scan
+class OptionalVector {
+public:
+    using Handle = std::size_t;
+
+    Handle insert(const Particle& value) {
+        for (; mScan < mSlots.size(); ++mScan) {
+            if (!mSlots[mScan]) {
+                mSlots[mScan] = value;
+                return mScan;
+            }
+        }
+        mSlots.emplace_back(value);
+        return mSlots.size() - 1;
+    }
+
+    void erase(Handle handle) {
+        mSlots[handle].reset();
+        mScan = 0;
+    }
+
+    Optional<Particle&> get(Handle handle) {
+        if (handle >= mSlots.size() || !mSlots[handle]) {
+            return NullOptional;
+        }
+        return *mSlots[handle];
+    }
+
+    template <typename TFunction>
+    void forEach(TFunction&& function) {
+        for (Optional<Particle>& slot : mSlots) {
+            if (slot) {
+                function(*slot);
+            }
+        }
+    }
+
+private:
+    std::vector<Optional<Particle>> mSlots;
+    std::size_t mScan = 0;
+};
+
+class SlotMapAdapter {
+public:
+    using Handle = SlotHandle;
+
+    Handle insert(const Particle& value) { return mMap.insert(value); }
+
+    void erase(Handle handle) { mMap.erase(handle); }
+
+    Optional<Particle&> get(Handle handle) { return mMap.get(handle); }
+
+    template <typename TFunction>
+    void forEach(TFunction&& function) {
+        for (Particle& value : mMap) {
+            function(value);
+        }
+    }
+
+private:
+    SlotMap<Particle> mMap;
+};
+
+template <typename TContainer>
+void run(const char* name, std::size_t count, std::size_t churn) {
+    using Handle = typename TContainer::Handle;
+    TContainer container;
+    std::vector<Handle> handles;
+    handles.reserve(count);
+
+    auto start = bench::Clock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+        handles.push_back(container.insert(particle(i)));
+    }
+    const double insertNs = bench::nanosecondsSince(start) / double(count);
+
+    // Churn: erase a random live element and insert a new one in its place
+    std::mt19937_64 random(42);
+    start = bench::Clock::now();
+    for (std::size_t i = 0; i < churn; ++i) {
+        const std::size_t victim = random() % handles.size();
+        container.erase(handles[victim]);
+        handles[victim] = container.insert(particle(i));
+    }
+    const double churnNs = bench::nanosecondsSince(start) / double(churn);
+
+    // Leave half of the elements erased, so the baseline has holes to skip
+    std::shuffle(handles.begin(), handles.end(), random);
+    for (std::size_t i = 0; i < count / 2; ++i) {
+        container.erase(handles[i]);
+    }
+
+    const std::size_t passes = 20;
+    float sum = 0;
+    start = bench::Clock::now();
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        container.forEach([&sum](Particle& p) {
+            p.position[0] += p.velocity[0];
+            sum += p.position[0];
+        });
+    }
+    const double iterateNs = bench::nanosecondsSince(start) / double(passes * (count - count / 2));
+
+    std::size_t found = 0;
+    start = bench::Clock::now();
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        for (const Handle& handle : handles) {
+            Optional<Particle&> p = container.get(handle);
+            if (p) {
+                sum += p->position[1];
+                ++found;
+            }
+        }
+    }
+    const double getNs = bench::nanosecondsSince(start) / double(passes * handles.size());
+    bench::doNotOptimize(sum);
+
+    std::printf("%-28s insert %5.1f ns  erase+insert %8.1f ns  iterate %5.2f ns  get %5.1f ns  (%zu live)\n",
+                name,
+                insertNs,
+                churnNs,
+                iterateNs,
+                getNs,
+                found / passes);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = bench::argument(argc, argv, "count", 1000000);
+    const std::size_t churn = bench::argument(argc, argv, "churn", 20000);
+    std::printf("%zu elements, %zu erase+insert pairs\n", count, churn);
+    run<OptionalVector>("vector<Optional<T>> + scan", count, churn);
+    run<SlotMapAdapter>("SlotMap", count, churn);
+    return 0;
+}
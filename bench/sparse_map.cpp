@@ -0,0 +1,154 @@
+#include "bench.hpp"
+
+#include "lib-optional/sparse_map.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Body {
+    float position[3];
+    float velocity[3];
+};
+
+Body body(std::size_t i) {
+    const float f = float(i);
+    return Body{ { f, f, f }, { 1.0f, 0.5f, 0.25f } };
+}
+
+/// The baseline: an optional per possible id, indexed by the id itself
+class OptionalVector {
+public:
+    explicit OptionalVector(std::size_t universe)
+        : mSlots(universe) {}
+
+    void insert(std::uint32_t id, const Body& value) { mSlots[id] = value; }
+
+    void erase(std::uint32_t id) { mSlots[id].reset(); }
+
+    Optional<Body&> find(std::uint32_t id) {
+        if (id >= mSlots.size() || !mSlots[id]) {
+            return NullOptional;
+        }
+        return *mSlots[id];
+    }
+
+    template <typename TFunction>
+    void forEach(TFunction&& function) {
+        for (Optional<Body>& slot : mSlots) {
+            if (slot) {
+                function(*slot);
+            }
+        }
+    }
+
+    std::size_t memoryUsage() const { return mSlots.capacity() * sizeof(Optional<Body>); }
+
+private:
+    std::vector<Optional<Body>> mSlots;
+};
+
+class SparseMapAdapter {
+public:
+    explicit SparseMapAdapter(std::size_t) {}
+
+    void insert(std::uint32_t id, const Body& value) { mMap.insert(id, value); }
+
+    void erase(std::uint32_t id) { mMap.erase(id); }
+
+    Optional<Body&> find(std::uint32_t id) { return mMap.find(id); }
+
+    template <typename TFunction>
+    void forEach(TFunction&& function) {
+        for (Body& value : mMap) {
+            function(value);
+        }
+    }
+
+    std::size_t memoryUsage() const { return mMap.memoryUsage(); }
+
+private:
+    SparseMap<Body> mMap;
+};
+
+template <typename TContainer>
+void run(const char* name, std::size_t universe, double density) {
+    std::mt19937_64 random(42);
+    std::vector<std::uint32_t> ids(universe);
+    for (std::size_t i = 0; i < universe; ++i) {
+        ids[i] = std::uint32_t(i);
+    }
+    std::shuffle(ids.begin(), ids.end(), random);
+    const std::size_t count = std::max<std::size_t>(1, std::size_t(double(universe) * density));
+    ids.resize(count);
+
+    TContainer container(universe);
+    auto start = bench::Clock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+        container.insert(ids[i], body(i));
+    }
+    const double insertNs = bench::nanosecondsSince(start) / double(count);
+
+    const std::size_t passes = 10;
+    float sum = 0;
+    start = bench::Clock::now();
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        container.forEach([&sum](Body& b) {
+            b.position[0] += b.velocity[0];
+            sum += b.position[0];
+        });
+    }
+    const double iterateNs = bench::nanosecondsSince(start) / double(passes * count);
+
+    // Random lookups over the whole id range, hits and misses in proportion to the density
+    std::vector<std::uint32_t> probes(1 << 20);
+    for (std::uint32_t& probe : probes) {
+        probe = std::uint32_t(random() % universe);
+    }
+    std::size_t found = 0;
+    start = bench::Clock::now();
+    for (const std::uint32_t probe : probes) {
+        Optional<Body&> b = container.find(probe);
+        if (b) {
+            sum += b->position[1];
+            ++found;
+        }
+    }
+    const double findNs = bench::nanosecondsSince(start) / double(probes.size());
+
+    start = bench::Clock::now();
+    for (std::size_t i = 0; i < count; i += 2) {
+        container.erase(ids[i]);
+    }
+    const double eraseNs = bench::nanosecondsSince(start) / double((count + 1) / 2);
+    bench::doNotOptimize(sum);
+
+    std::printf("%-22s %4.0f%%  insert %5.1f ns  iterate %6.2f ns/value  find %5.1f ns  erase %5.1f ns"
+                "  %7.1f MiB  (%zu hits)\n",
+                name,
+                density * 100,
+                insertNs,
+                iterateNs,
+                findNs,
+                eraseNs,
+                double(container.memoryUsage()) / (1 << 20),
+                found);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t universe = bench::argument(argc, argv, "universe", 4000000);
+    std::printf("ids below %zu, %zu-byte values\n", universe, sizeof(Body));
+    const double densities[] = { 0.01, 0.1, 0.5 };
+    for (const double density : densities) {
+        run<OptionalVector>("vector<Optional<T>>", universe, density);
+        run<SparseMapAdapter>("SparseMap", universe, density);
+    }
+    return 0;
+}
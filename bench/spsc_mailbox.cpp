@@ -0,0 +1,98 @@
+#include "bench.hpp"
+
+#include "lib-optional/spsc_mailbox.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+using namespace libOptional;
+
+namespace {
+
+struct Message {
+    std::uint64_t sequence;
+    double prices[7];
+};
+
+/// The baseline: an Optional guarded by a mutex
+template <MailboxMode TMode>
+class MutexMailbox {
+public:
+    bool tryPut(Message&& message) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mSlot && TMode == MailboxMode::Reject) {
+            return false;
+        }
+        mSlot = std::move(message);
+        return true;
+    }
+
+    Optional<Message> tryTake() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Optional<Message> result = std::move(mSlot);
+        mSlot.reset();
+        return result;
+    }
+
+private:
+    std::mutex mMutex;
+    Optional<Message> mSlot;
+};
+
+struct Result {
+    double seconds;
+    std::uint64_t received;
+};
+
+/// Producer sends \p count messages, the consumer takes until it sees the last one
+template <typename TMailbox>
+Result run(std::uint64_t count) {
+    TMailbox mailbox;
+    const auto start = bench::Clock::now();
+    std::thread producer([&] {
+        for (std::uint64_t i = 1; i <= count; ++i) {
+            Message message = Message();
+            message.sequence = i;
+            while (!mailbox.tryPut(std::move(message))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::uint64_t received = 0;
+    for (std::uint64_t last = 0; last != count;) {
+        Optional<Message> message = mailbox.tryTake();
+        if (message) {
+            last = message->sequence;
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    return Result{ bench::secondsSince(start), received };
+}
+
+template <typename TMailbox>
+void report(const char* name, std::uint64_t count) {
+    const Result result = run<TMailbox>(count);
+    std::printf("%-34s %10.1f ns/put %12llu received\n",
+                name,
+                result.seconds * 1e9 / double(count),
+                static_cast<unsigned long long>(result.received));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::uint64_t count = bench::argument(argc, argv, "messages", 2000000);
+    std::printf("%u hardware threads, %llu messages of %zu bytes\n",
+                std::thread::hardware_concurrency(),
+                static_cast<unsigned long long>(count),
+                sizeof(Message));
+    report<SpscMailbox<Message>>("SpscMailbox reject", count);
+    report<MutexMailbox<MailboxMode::Reject>>("mutex + Optional reject", count);
+    report<SpscMailbox<Message, MailboxMode::Overwrite>>("SpscMailbox overwrite", count);
+    report<MutexMailbox<MailboxMode::Overwrite>>("mutex + Optional overwrite", count);
+    return 0;
+}
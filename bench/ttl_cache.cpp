@@ -0,0 +1,119 @@
+#include "bench.hpp"
+
+#include "lib-optional/ttl_cache.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+/// Simulated time, so both caches see exactly the same sequence of expiries
+struct SimulatedClock {
+    using duration = std::chrono::microseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<SimulatedClock>;
+    static constexpr bool is_steady = true;
+
+    time_point now() const noexcept { return time_point(*current); }
+
+    const duration* current;
+};
+
+/// The baseline: an unordered_map of timestamped optionals, checked on every lookup and swept
+/// in full every \p sweepInterval
+class SweptMap {
+public:
+    SweptMap(std::size_t capacity, SimulatedClock::duration ttl, SimulatedClock clock)
+        : mTtl(ttl)
+        , mClock(clock)
+        , mLastSweep(clock.now()) {
+        mMap.reserve(capacity);
+    }
+
+    Optional<std::uint64_t&> get(std::uint64_t key) {
+        const auto it = mMap.find(key);
+        if (it == mMap.end() || it->second.expiry <= mClock.now()) {
+            return NullOptional;
+        }
+        return *it->second.value;
+    }
+
+    void put(std::uint64_t key, std::uint64_t value) {
+        const SimulatedClock::time_point now = mClock.now();
+        if (now - mLastSweep >= SweepInterval) {
+            for (auto it = mMap.begin(); it != mMap.end();) {
+                it = it->second.expiry <= now ? mMap.erase(it) : std::next(it);
+            }
+            mLastSweep = now;
+        }
+        Entry& entry = mMap[key];
+        entry.expiry = now + mTtl;
+        entry.value = value;
+    }
+
+    std::size_t size() const noexcept { return mMap.size(); }
+
+private:
+    struct Entry {
+        SimulatedClock::time_point expiry;
+        Optional<std::uint64_t> value;
+    };
+
+    static const SimulatedClock::duration SweepInterval;
+
+    SimulatedClock::duration mTtl;
+    SimulatedClock mClock;
+    SimulatedClock::time_point mLastSweep;
+    std::unordered_map<std::uint64_t, Entry> mMap;
+};
+
+const SimulatedClock::duration SweptMap::SweepInterval = std::chrono::milliseconds(10);
+
+/// Every step advances the time by 1us, stores a new key and reads one stored 50us earlier
+template <typename TCache>
+void run(const char* name, std::size_t operations, SimulatedClock::duration ttl) {
+    SimulatedClock::duration now(0);
+    TCache cache(2 * std::size_t(ttl.count()), ttl, SimulatedClock{ &now });
+    std::vector<double> samples;
+    samples.reserve(operations);
+    std::uint64_t hits = 0;
+    const auto start = bench::Clock::now();
+    for (std::uint64_t i = 0; i < operations; ++i) {
+        now += SimulatedClock::duration(1);
+        const auto opStart = bench::Clock::now();
+        cache.put(i, i);
+        hits += i >= 50 && cache.get(i - 50) ? 1 : 0;
+        samples.push_back(bench::nanosecondsSince(opStart));
+    }
+    const double seconds = bench::secondsSince(start);
+    const double median = bench::percentile(samples, 50);
+    const double tail = bench::percentile(samples, 99.9);
+    const double farTail = bench::percentile(samples, 99.99);
+    std::printf("%-22s %7.2f Mops/s  %7zu live  p50 %5.0f ns  p99.9 %5.0f ns  p99.99 %7.0f ns  (%llu hits)\n",
+                name,
+                double(operations) / seconds / 1e6,
+                cache.size(),
+                median,
+                tail,
+                farTail,
+                static_cast<unsigned long long>(hits));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t operations = bench::argument(argc, argv, "operations", 5000000);
+    const SimulatedClock::duration ttl(bench::argument(argc, argv, "ttl-us", 100000));
+    std::printf("%zu put+get steps 1us apart, %lld us time to live\n",
+                operations,
+                static_cast<long long>(ttl.count()));
+    run<SweptMap>("map + periodic sweep", operations, ttl);
+    run<TtlCache<std::uint64_t, std::uint64_t, SimulatedClock>>("TtlCache", operations, ttl);
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "bench.hpp"
+
+#include "lib-optional/work_stealing_deque.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+std::uint64_t serialFib(unsigned n) {
+    return n < 2 ? n : serialFib(n - 1) + serialFib(n - 2);
+}
+
+/// fib(n) in continuation-passing style: a task either computes a small fib directly or spawns
+/// two children, the last child to finish completes the parent
+struct Task {
+    unsigned n;
+    Task* parent;
+    std::atomic<std::uint64_t> result{ 0 };
+    std::atomic<int> pending{ 0 };
+};
+
+class Scheduler {
+public:
+    Scheduler(std::size_t workers, unsigned cutoff)
+        : mCutoff(cutoff)
+        , mDeques(workers) {}
+
+    std::uint64_t fib(unsigned n) {
+        Task root;
+        root.n = n;
+        root.parent = nullptr;
+        mDone = false;
+        mDeques[0].push(&root);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < mDeques.size(); ++i) {
+            threads.emplace_back([this, i] { work(i); });
+        }
+        work(0);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        return root.result.load();
+    }
+
+private:
+    void work(std::size_t self) {
+        std::minstd_rand random(unsigned(self) + 1);
+        WorkStealingDeque<Task*>& own = mDeques[self];
+        while (!mDone.load(std::memory_order_acquire)) {
+            Optional<Task*> task = own.pop();
+            if (!task && mDeques.size() > 1) {
+                const std::size_t victim = (self + 1 + random() % (mDeques.size() - 1)) % mDeques.size();
+                task = mDeques[victim].steal();
+            }
+            if (task) {
+                run(**task, own);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void run(Task& task, WorkStealingDeque<Task*>& own) {
+        if (task.n <= mCutoff) {
+            task.result = serialFib(task.n);
+            complete(&task);
+            return;
+        }
+        Task* left = new Task();
+        Task* right = new Task();
+        left->n = task.n - 1;
+        right->n = task.n - 2;
+        left->parent = right->parent = &task;
+        task.pending = 2;
+        own.push(right);
+        own.push(left);
+    }
+
+    void complete(Task* task) {
+        for (;;) {
+            Task* parent = task->parent;
+            if (parent == nullptr) {
+                mDone.store(true, std::memory_order_release);
+                return;
+            }
+            parent->result += task->result.load();
+            delete task;
+            if (parent->pending.fetch_sub(1) != 1) {
+                return;
+            }
+            task = parent;
+        }
+    }
+
+    unsigned mCutoff;
+    // The deques are cache-line aligned, which plain operator new doesn't honour before C++17
+    detail::CacheAlignedArray<WorkStealingDeque<Task*>> mDeques;
+    std::atomic<bool> mDone{ false };
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const unsigned n = unsigned(bench::argument(argc, argv, "n", 40));
+    const unsigned cutoff = unsigned(bench::argument(argc, argv, "cutoff", 20));
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t maxWorkers = bench::argument(argc, argv, "workers", std::max<std::size_t>(hardware, 8));
+
+    auto start = bench::Clock::now();
+    const std::uint64_t expected = serialFib(n);
+    const double serial = bench::secondsSince(start);
+    std::printf("fib(%u), cutoff %u, %zu hardware threads, serial %.3f s\n", n, cutoff, hardware, serial);
+    std::printf("%8s %10s %10s\n", "workers", "seconds", "speedup");
+    for (std::size_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        Scheduler scheduler(workers, cutoff);
+        start = bench::Clock::now();
+        const std::uint64_t result = scheduler.fib(n);
+        const double seconds = bench::secondsSince(start);
+        if (result != expected) {
+            std::printf("wrong result %llu\n", static_cast<unsigned long long>(result));
+            return 1;
+        }
+        std::printf("%8zu %10.3f %10.2f\n", workers, seconds, serial / seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,255 @@
+#ifndef UTILS_ADAPTIVE_VALIDITY_HPP_
+#define UTILS_ADAPTIVE_VALIDITY_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional_span.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace libOptional {
+
+/// Validity of a nullable column stored in whichever of four forms is the smallest:
+/// - AllValid/AllNull - a constant, no per-row storage at all
+/// - Runs - sorted, non-overlapping runs of engaged rows, compact for very sparse or very dense data
+/// - Bitmap - one bit per row, same layout as OptionalSpan uses
+///
+/// Kernels in kernels.hpp accept an AdaptiveValidity next to the values array and short-circuit
+/// on the constant forms.
+class AdaptiveValidity final {
+public:
+    enum class Kind { AllValid, AllNull, Runs, Bitmap };
+
+    /// Engaged rows [start, start + length)
+    struct Run {
+        std::uint64_t start;
+        std::uint64_t length;
+    };
+
+    AdaptiveValidity() noexcept = default;
+
+    static AdaptiveValidity allValid(std::size_t size) {
+        return AdaptiveValidity(Kind::AllValid, size, size);
+    }
+
+    static AdaptiveValidity allNull(std::size_t size) { return AdaptiveValidity(Kind::AllNull, size, 0); }
+
+    /// Picks the smallest representation of the first \p size bits of \p bitmap
+    ///
+    /// \param bitmap Validity bitmap, bit i set means row i is engaged. Null means all rows are engaged.
+    static AdaptiveValidity encode(const std::uint64_t* bitmap, std::size_t size) {
+        if (bitmap == nullptr) {
+            return allValid(size);
+        }
+        const std::size_t valid = detail::countSetBits(bitmap, size);
+        if (valid == size) {
+            return allValid(size);
+        }
+        if (valid == 0) {
+            return allNull(size);
+        }
+        AdaptiveValidity result(Kind::Bitmap, size, valid);
+        const std::size_t words = detail::wordCount(size);
+        if (countRuns(bitmap, size) * sizeof(Run) < words * sizeof(std::uint64_t)) {
+            result.mKind = Kind::Runs;
+            collectRuns(bitmap, size, result.mRuns);
+        } else {
+            result.mBitmap.assign(bitmap, bitmap + words);
+            result.mBitmap.back() &= detail::lowMask(size - (words - 1) * detail::BitsPerWord);
+        }
+        return result;
+    }
+
+    template <typename T>
+    static AdaptiveValidity encode(const OptionalSpan<T>& span) {
+        return encode(span.validity(), span.size());
+    }
+
+    Kind kind() const noexcept { return mKind; }
+
+    bool isAllValid() const noexcept { return mKind == Kind::AllValid; }
+
+    bool isAllNull() const noexcept { return mKind == Kind::AllNull; }
+
+    std::size_t size() const noexcept { return mSize; }
+
+    /// Number of engaged rows, O(1) in every form
+    std::size_t validCount() const noexcept { return mValid; }
+
+    std::size_t nullCount() const noexcept { return mSize - mValid; }
+
+    /// Engaged runs, empty unless kind() is Kind::Runs
+    const std::vector<Run>& runs() const noexcept { return mRuns; }
+
+    /// Validity bitmap, null unless kind() is Kind::Bitmap
+    const std::uint64_t* bitmap() const noexcept { return mBitmap.empty() ? nullptr : mBitmap.data(); }
+
+    /// Bytes used by the per-row representation
+    std::size_t byteSize() const noexcept {
+        return mRuns.size() * sizeof(Run) + mBitmap.size() * sizeof(std::uint64_t);
+    }
+
+    /// \note O(log runs) for Kind::Runs, O(1) otherwise
+    bool isValid(std::size_t index) const noexcept {
+        assert(index < mSize);
+        switch (mKind) {
+        case Kind::AllValid:
+            return true;
+        case Kind::AllNull:
+            return false;
+        case Kind::Bitmap:
+            return detail::testBit(mBitmap.data(), index);
+        case Kind::Runs:
+            break;
+        }
+        auto next = std::upper_bound(mRuns.begin(), mRuns.end(), index, [](std::size_t i, const Run& run) {
+            return i < run.start;
+        });
+        return next != mRuns.begin() && index - (next - 1)->start < (next - 1)->length;
+    }
+
+    /// Calls \p func(begin, end) for every maximal range of engaged rows, in order
+    template <typename TFunc>
+    void forEachValidRange(TFunc&& func) const {
+        switch (mKind) {
+        case Kind::AllValid:
+            if (mSize != 0) {
+                func(std::size_t(0), mSize);
+            }
+            return;
+        case Kind::AllNull:
+            return;
+        case Kind::Runs:
+            for (const Run& run : mRuns) {
+                func(std::size_t(run.start), std::size_t(run.start + run.length));
+            }
+            return;
+        case Kind::Bitmap:
+            forEachRun(mBitmap.data(), mSize, func);
+            return;
+        }
+    }
+
+    /// Writes the validity as a plain bitmap of wordCount(size()) words into \p out
+    void toBitmap(std::uint64_t* out) const {
+        const std::size_t words = detail::wordCount(mSize);
+        switch (mKind) {
+        case Kind::Bitmap:
+            std::memcpy(out, mBitmap.data(), words * sizeof(std::uint64_t));
+            return;
+        case Kind::AllValid:
+            std::fill(out, out + words, ~std::uint64_t(0));
+            if (words != 0) {
+                out[words - 1] = detail::lowMask(mSize - (words - 1) * detail::BitsPerWord);
+            }
+            return;
+        case Kind::AllNull:
+        case Kind::Runs:
+            std::fill(out, out + words, std::uint64_t(0));
+            forEachValidRange([out](std::size_t begin, std::size_t end) { setRange(out, begin, end); });
+            return;
+        }
+    }
+
+    /// Span over \p values with this validity, unless kind() is Kind::Runs or Kind::AllNull
+    template <typename T>
+    OptionalSpan<T> span(const T* values) const noexcept {
+        assert(mKind == Kind::AllValid || mKind == Kind::Bitmap);
+        return OptionalSpan<T>(values, bitmap(), mSize);
+    }
+
+private:
+    AdaptiveValidity(Kind kind, std::size_t size, std::size_t valid) noexcept
+        : mKind(kind)
+        , mSize(size)
+        , mValid(valid) {}
+
+    /// Number of 0 -> 1 transitions, bit -1 being 0
+    static std::size_t countRuns(const std::uint64_t* bitmap, std::size_t size) noexcept {
+        const std::size_t words = detail::wordCount(size);
+        std::size_t count = 0;
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < words; ++i) {
+            std::uint64_t word = bitmap[i];
+            if (i + 1 == words) {
+                word &= detail::lowMask(size - i * detail::BitsPerWord);
+            }
+            count += detail::popcount(word & ~((word << 1) | carry));
+            carry = word >> 63;
+        }
+        return count;
+    }
+
+    static void collectRuns(const std::uint64_t* bitmap, std::size_t size, std::vector<Run>& runs) {
+        runs.reserve(countRuns(bitmap, size));
+        forEachRun(bitmap, size, [&runs](std::size_t begin, std::size_t end) {
+            runs.push_back(Run{ begin, end - begin });
+        });
+    }
+
+    /// Calls \p func(begin, end) for every maximal run of set bits, skipping whole words at a time
+    template <typename TFunc>
+    static void forEachRun(const std::uint64_t* bitmap, std::size_t size, TFunc&& func) {
+        const std::size_t words = detail::wordCount(size);
+        auto load = [&](std::size_t i, bool set) {
+            std::uint64_t word = set ? bitmap[i] : ~bitmap[i];
+            if (i + 1 == words) {
+                word &= detail::lowMask(size - i * detail::BitsPerWord);
+            }
+            return word;
+        };
+        std::size_t bit = 0;
+        while (bit < size) {
+            // Find the next set bit, then the next clear bit after it
+            std::size_t begin = size;
+            for (std::size_t i = detail::wordIndex(bit); i < words; ++i) {
+                const std::uint64_t word =
+                    load(i, true) & ~detail::lowMask(i == detail::wordIndex(bit) ? bit % 64 : 0);
+                if (word != 0) {
+                    begin = i * detail::BitsPerWord + detail::countTrailingZeros(word);
+                    break;
+                }
+            }
+            if (begin == size) {
+                return;
+            }
+            std::size_t end = size;
+            for (std::size_t i = detail::wordIndex(begin); i < words; ++i) {
+                const std::uint64_t word =
+                    load(i, false) & ~detail::lowMask(i == detail::wordIndex(begin) ? begin % 64 : 0);
+                if (word != 0) {
+                    end = std::min(size, i * detail::BitsPerWord + detail::countTrailingZeros(word));
+                    break;
+                }
+            }
+            func(begin, end);
+            bit = end;
+        }
+    }
+
+    static void setRange(std::uint64_t* words, std::size_t begin, std::size_t end) noexcept {
+        while (begin < end && begin % detail::BitsPerWord != 0) {
+            detail::setBit(words, begin++);
+        }
+        for (; begin + detail::BitsPerWord <= end; begin += detail::BitsPerWord) {
+            words[detail::wordIndex(begin)] = ~std::uint64_t(0);
+        }
+        while (begin < end) {
+            detail::setBit(words, begin++);
+        }
+    }
+
+    Kind mKind = Kind::AllValid;
+    std::size_t mSize = 0;
+    std::size_t mValid = 0;
+    std::vector<Run> mRuns;
+    std::vector<std::uint64_t> mBitmap;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_ADAPTIVE_VALIDITY_HPP_
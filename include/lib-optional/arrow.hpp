@@ -0,0 +1,329 @@
+#ifndef UTILS_ARROW_HPP_
+#define UTILS_ARROW_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional.hpp"
+#include "lib-optional/optional_span.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The Arrow export relies on the validity words having the little-endian Arrow bitmap layout"
+#endif
+
+// The Arrow C data interface structures, as defined by the specification
+// (https://arrow.apache.org/docs/format/CDataInterface.html). The guard is the one the
+// specification mandates, so the definitions don't clash with the ones from an Arrow library.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#include <stdint.h>
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace libOptional {
+
+class ArrowError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/// Arrow format string of the primitive type T, specialized for all fixed-width numeric types
+template <typename T>
+struct ArrowFormat;
+
+template <>
+struct ArrowFormat<std::int8_t> {
+    static const char* value() noexcept { return "c"; }
+};
+
+template <>
+struct ArrowFormat<std::uint8_t> {
+    static const char* value() noexcept { return "C"; }
+};
+
+template <>
+struct ArrowFormat<std::int16_t> {
+    static const char* value() noexcept { return "s"; }
+};
+
+template <>
+struct ArrowFormat<std::uint16_t> {
+    static const char* value() noexcept { return "S"; }
+};
+
+template <>
+struct ArrowFormat<std::int32_t> {
+    static const char* value() noexcept { return "i"; }
+};
+
+template <>
+struct ArrowFormat<std::uint32_t> {
+    static const char* value() noexcept { return "I"; }
+};
+
+template <>
+struct ArrowFormat<std::int64_t> {
+    static const char* value() noexcept { return "l"; }
+};
+
+template <>
+struct ArrowFormat<std::uint64_t> {
+    static const char* value() noexcept { return "L"; }
+};
+
+template <>
+struct ArrowFormat<float> {
+    static const char* value() noexcept { return "f"; }
+};
+
+template <>
+struct ArrowFormat<double> {
+    static const char* value() noexcept { return "g"; }
+};
+
+namespace detail {
+
+    /// Private data of an exported array, keeps the buffers alive until the consumer releases it
+    struct ArrowArrayExport {
+        std::shared_ptr<const void> owner;
+        const void* buffers[2];
+    };
+
+    inline void releaseArrowArray(ArrowArray* array) {
+        delete static_cast<ArrowArrayExport*>(array->private_data);
+        array->private_data = nullptr;
+        array->release = nullptr;
+    }
+
+    struct ArrowSchemaExport {
+        std::string name;
+    };
+
+    inline void releaseArrowSchema(ArrowSchema* schema) {
+        delete static_cast<ArrowSchemaExport*>(schema->private_data);
+        schema->private_data = nullptr;
+        schema->release = nullptr;
+    }
+
+    template <typename T>
+    struct ArrowBuffers {
+        std::vector<T> values;
+        std::vector<std::uint64_t> validity;
+    };
+
+} // namespace detail
+
+/// Fills \p out with the schema of a nullable column of T named \p name
+template <typename T>
+void exportArrowSchema(ArrowSchema* out, const std::string& name = std::string()) {
+    std::unique_ptr<detail::ArrowSchemaExport> data(new detail::ArrowSchemaExport{ name });
+    out->format = ArrowFormat<T>::value();
+    out->name = data->name.c_str();
+    out->metadata = nullptr;
+    out->flags = ARROW_FLAG_NULLABLE;
+    out->n_children = 0;
+    out->children = nullptr;
+    out->dictionary = nullptr;
+    out->release = &detail::releaseArrowSchema;
+    out->private_data = data.release();
+}
+
+/// Fills \p out with an array pointing straight at the buffers of \p span, nothing is copied
+///
+/// \param owner Keeps the buffers alive, it is destroyed when the consumer releases the array
+template <typename T>
+void exportArrow(const OptionalSpan<T>& span, std::shared_ptr<const void> owner, ArrowArray* out) {
+    std::unique_ptr<detail::ArrowArrayExport> data(new detail::ArrowArrayExport());
+    data->owner = std::move(owner);
+    data->buffers[0] = span.validity();
+    data->buffers[1] = span.values();
+    const std::size_t valid =
+        span.allValid() ? span.size() : detail::countSetBits(span.validity(), span.size());
+    out->length = std::int64_t(span.size());
+    out->null_count = std::int64_t(span.size() - valid);
+    out->offset = 0;
+    out->n_buffers = 2;
+    out->n_children = 0;
+    out->buffers = data->buffers;
+    out->children = nullptr;
+    out->dictionary = nullptr;
+    out->release = &detail::releaseArrowArray;
+    out->private_data = data.release();
+}
+
+/// Fills \p out with an array that takes over \p values and \p validity without copying them
+///
+/// \param validity Bitmap of at least wordCount(values.size()) words, empty if all values are engaged
+template <typename T>
+void exportArrow(std::vector<T>&& values, std::vector<std::uint64_t>&& validity, ArrowArray* out) {
+    if (!validity.empty() && validity.size() < detail::wordCount(values.size())) {
+        throw ArrowError("The validity bitmap is shorter than the values");
+    }
+    std::shared_ptr<detail::ArrowBuffers<T>> buffers = std::make_shared<detail::ArrowBuffers<T>>();
+    buffers->values = std::move(values);
+    buffers->validity = std::move(validity);
+    const OptionalSpan<T> span(buffers->values.data(),
+                               buffers->validity.empty() ? nullptr : buffers->validity.data(),
+                               buffers->values.size());
+    exportArrow(span, std::move(buffers), out);
+}
+
+/// Fills \p out with the contents of \p values
+///
+/// \note Optional<T> interleaves the engaged flag with the value, which is not the Arrow layout,
+///       so this is the one export that has to build the buffers. Columns that are already stored
+///       as values and a bitmap should be exported through the overloads above.
+template <typename T>
+void exportArrow(const std::vector<Optional<T>>& values, ArrowArray* out) {
+    std::vector<T> buffer(values.size());
+    std::vector<std::uint64_t> validity(detail::wordCount(values.size()));
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (values[i]) {
+            buffer[i] = *values[i];
+            detail::setBit(validity.data(), i);
+        }
+    }
+    exportArrow(std::move(buffer), std::move(validity), out);
+}
+
+/// Nullable column imported from the Arrow C data interface without copying
+///
+/// Takes over the ArrowArray (the source is marked released, as the specification prescribes
+/// for moves) and calls its release callback when destroyed. The buffers are exposed as an
+/// OptionalSpan, so all kernels work on them directly.
+///
+/// \note The validity words are read 8 bytes at a time, which relies on the producer padding its
+///       buffers to 8 bytes as the specification recommends.
+template <typename T>
+class ImportedArrowArray final {
+public:
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    /// \param array Array to take over
+    /// \param schema Schema to check the format against, it stays owned by the caller
+    /// \throw ArrowError if the array does not describe a primitive nullable column of T this
+    ///                   class can view, the array is left untouched in that case
+    explicit ImportedArrowArray(ArrowArray* array, const ArrowSchema* schema = nullptr) {
+        if (array == nullptr || array->release == nullptr) {
+            throw ArrowError("The Arrow array is already released");
+        }
+        if (schema != nullptr && std::string(schema->format) != ArrowFormat<T>::value()) {
+            throw ArrowError(std::string("Arrow format '") + schema->format + "' does not match '" +
+                             ArrowFormat<T>::value() + "'");
+        }
+        if (array->n_buffers != 2 || array->n_children != 0 || array->dictionary != nullptr) {
+            throw ArrowError("The Arrow array is not a primitive array");
+        }
+        if (array->length < 0 || array->offset < 0) {
+            throw ArrowError("The Arrow array has a negative length or offset");
+        }
+        const T* values = static_cast<const T*>(array->buffers[1]);
+        const std::uint64_t* validity = static_cast<const std::uint64_t*>(array->buffers[0]);
+        if (array->null_count == 0) {
+            validity = nullptr;
+        }
+        if (reinterpret_cast<std::uintptr_t>(values) % alignof(T) != 0 ||
+            reinterpret_cast<std::uintptr_t>(validity) % alignof(std::uint64_t) != 0) {
+            throw ArrowError("The Arrow buffers are not aligned");
+        }
+        if (validity != nullptr && array->offset % std::int64_t(detail::BitsPerWord) != 0) {
+            throw ArrowError("Arrow arrays with nulls must have an offset that is a multiple of 64");
+        }
+        const std::size_t offset = std::size_t(array->offset);
+        mSpan = OptionalSpan<T>(values ? values + offset : nullptr,
+                                validity ? validity + detail::wordIndex(offset) : nullptr,
+                                std::size_t(array->length));
+        mArray = *array;
+        array->release = nullptr;
+    }
+
+    ImportedArrowArray(const ImportedArrowArray&) = delete;
+    ImportedArrowArray& operator=(const ImportedArrowArray&) = delete;
+
+    ImportedArrowArray(ImportedArrowArray&& other) noexcept
+        : mArray(other.mArray)
+        , mSpan(other.mSpan) {
+        other.mArray.release = nullptr;
+        other.mSpan = OptionalSpan<T>();
+    }
+
+    ImportedArrowArray& operator=(ImportedArrowArray&& other) noexcept {
+        if (this != &other) {
+            reset();
+            mArray = other.mArray;
+            mSpan = other.mSpan;
+            other.mArray.release = nullptr;
+            other.mSpan = OptionalSpan<T>();
+        }
+        return *this;
+    }
+
+    ~ImportedArrowArray() noexcept { reset(); }
+
+    std::size_t size() const noexcept { return mSpan.size(); }
+
+    std::size_t nullCount() const noexcept {
+        return mSpan.allValid() ? 0 : mSpan.size() - detail::countSetBits(mSpan.validity(), mSpan.size());
+    }
+
+    Optional<const T&> operator[](std::size_t index) const noexcept { return mSpan[index]; }
+
+    const OptionalSpan<T>& span() const noexcept { return mSpan; }
+
+private:
+    void reset() noexcept {
+        if (mArray.release != nullptr) {
+            mArray.release(&mArray);
+            mArray.release = nullptr;
+        }
+        mSpan = OptionalSpan<T>();
+    }
+
+    ArrowArray mArray = ArrowArray();
+    OptionalSpan<T> mSpan;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_ARROW_HPP_
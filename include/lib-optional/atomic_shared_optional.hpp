@@ -0,0 +1,256 @@
+#ifndef UTILS_ATOMIC_SHARED_OPTIONAL_HPP_
+#define UTILS_ATOMIC_SHARED_OPTIONAL_HPP_
+
+#include "lib-optional/concurrency.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace libOptional {
+
+/// Optional immutable payload that writers replace atomically while readers keep using the
+/// version they loaded, without blocking and without copying it
+///
+/// Each version lives in its own heap node. Readers protect the node they load with a hazard
+/// pointer, one of TSlots per instance, and writers retire replaced nodes and only delete those
+/// that no hazard pointer refers to. Readers therefore never lock nor touch a reference count
+/// shared with other readers; a thread mostly reuses the same cache-line-sized slot.
+///
+/// \note At most TSlots handles may be alive at the same time, load() spins while all slots are
+///       taken. All handles must be destroyed before the AtomicSharedOptional.
+template <typename T, std::size_t TSlots = 128>
+class AtomicSharedOptional final {
+    struct Node {
+        template <typename... TArgs>
+        explicit Node(TArgs&&... args)
+            : value(std::forward<TArgs>(args)...) {}
+
+        const T value;
+    };
+
+    struct alignas(detail::CacheLineSize) Slot {
+        std::atomic<bool> owned{ false };
+        std::atomic<Node*> hazard{ nullptr };
+    };
+
+public:
+    static_assert(TSlots > 0, "AtomicSharedOptional needs at least one hazard slot");
+
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    /// Reader's view of one version of the payload, keeps it alive until destroyed
+    class Handle final {
+    public:
+        Handle() noexcept = default;
+
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        Handle(Handle&& other) noexcept
+            : mSlot(other.mSlot)
+            , mNode(other.mNode) {
+            other.mSlot = nullptr;
+            other.mNode = nullptr;
+        }
+
+        Handle& operator=(Handle&& other) noexcept {
+            if (this != &other) {
+                release();
+                mSlot = other.mSlot;
+                mNode = other.mNode;
+                other.mSlot = nullptr;
+                other.mNode = nullptr;
+            }
+            return *this;
+        }
+
+        ~Handle() noexcept { release(); }
+
+        bool hasValue() const noexcept { return mNode != nullptr; }
+
+        explicit operator bool() const noexcept { return hasValue(); }
+
+        const T& operator*() const noexcept {
+            assert(mNode);
+            return mNode->value;
+        }
+
+        const T* operator->() const noexcept {
+            assert(mNode);
+            return &mNode->value;
+        }
+
+        Optional<const T&> value() const noexcept {
+            if (!mNode) {
+                return NullOptional;
+            }
+            return mNode->value;
+        }
+
+        operator Optional<const T&>() const noexcept { return value(); }
+
+        /// Gives up the protected version early
+        void release() noexcept {
+            if (mSlot) {
+                mSlot->hazard.store(nullptr, std::memory_order_release);
+                mSlot->owned.store(false, std::memory_order_release);
+                mSlot = nullptr;
+            }
+            mNode = nullptr;
+        }
+
+    private:
+        friend class AtomicSharedOptional;
+
+        Handle(Slot* slot, Node* node) noexcept
+            : mSlot(slot)
+            , mNode(node) {}
+
+        Slot* mSlot = nullptr;
+        Node* mNode = nullptr;
+    };
+
+    AtomicSharedOptional() = default;
+
+    explicit AtomicSharedOptional(const T& value)
+        : mCurrent(new Node(value)) {}
+
+    explicit AtomicSharedOptional(T&& value)
+        : mCurrent(new Node(std::move(value))) {}
+
+    AtomicSharedOptional(const AtomicSharedOptional&) = delete;
+    AtomicSharedOptional& operator=(const AtomicSharedOptional&) = delete;
+
+    ~AtomicSharedOptional() {
+        delete mCurrent.load(std::memory_order_relaxed);
+        for (Node* node : mRetired) {
+            delete node;
+        }
+    }
+
+    /// Protects and returns the current version, lock-free unless all slots are taken
+    Handle load() const noexcept {
+        if (mCurrent.load(std::memory_order_acquire) == nullptr) {
+            return Handle();
+        }
+        Slot& slot = acquireSlot();
+        Node* node = mCurrent.load(std::memory_order_seq_cst);
+        for (;;) {
+            slot.hazard.store(node, std::memory_order_seq_cst);
+            Node* again = mCurrent.load(std::memory_order_seq_cst);
+            if (again == node) {
+                break;
+            }
+            node = again;
+        }
+        if (node == nullptr) {
+            slot.hazard.store(nullptr, std::memory_order_relaxed);
+            slot.owned.store(false, std::memory_order_release);
+            return Handle();
+        }
+        return Handle(&slot, node);
+    }
+
+    bool hasValue() const noexcept { return mCurrent.load(std::memory_order_acquire) != nullptr; }
+
+    /// Publishes a new version constructed from \p args, the replaced one is reclaimed once no
+    /// reader holds it anymore
+    template <typename... TArgs>
+    void emplace(TArgs&&... args) {
+        publish(new Node(std::forward<TArgs>(args)...));
+    }
+
+    void store(const T& value) { emplace(value); }
+
+    void store(T&& value) { emplace(std::move(value)); }
+
+    void store(const Optional<T>& value) {
+        if (value) {
+            emplace(*value);
+        } else {
+            reset();
+        }
+    }
+
+    /// Publishes the disengaged state
+    void reset() { publish(nullptr); }
+
+    /// Deletes the retired versions no reader holds anymore, returns how many are still held
+    std::size_t collect() {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        return collectLocked();
+    }
+
+    /// Number of replaced versions waiting for readers to release them
+    std::size_t retiredCount() const {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        return mRetired.size();
+    }
+
+private:
+    Slot& acquireSlot() const noexcept {
+        // Starting where the thread left off last time makes it mostly reuse its own slot
+        static thread_local std::size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+        for (std::size_t i = hint;; ++i) {
+            Slot& slot = mSlots[i % TSlots];
+            if (!slot.owned.load(std::memory_order_relaxed) &&
+                !slot.owned.exchange(true, std::memory_order_acquire)) {
+                hint = i % TSlots;
+                return slot;
+            }
+            if ((i + 1) % TSlots == hint % TSlots) {
+                detail::cpuRelax();
+            }
+        }
+    }
+
+    void publish(Node* node) {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        Node* previous = mCurrent.exchange(node, std::memory_order_seq_cst);
+        if (previous != nullptr) {
+            mRetired.push_back(previous);
+            collectLocked();
+        }
+    }
+
+    std::size_t collectLocked() {
+        if (mRetired.empty()) {
+            return 0;
+        }
+        std::vector<Node*> hazards;
+        hazards.reserve(TSlots);
+        for (const Slot& slot : mSlots) {
+            Node* node = slot.hazard.load(std::memory_order_seq_cst);
+            if (node != nullptr) {
+                hazards.push_back(node);
+            }
+        }
+        std::sort(hazards.begin(), hazards.end());
+        auto held = std::partition(mRetired.begin(), mRetired.end(), [&hazards](Node* node) {
+            return std::binary_search(hazards.begin(), hazards.end(), node);
+        });
+        for (auto it = held; it != mRetired.end(); ++it) {
+            delete *it;
+        }
+        mRetired.erase(held, mRetired.end());
+        return mRetired.size();
+    }
+
+    std::atomic<Node*> mCurrent{ nullptr };
+    mutable Slot mSlots[TSlots];
+    mutable std::mutex mWriteMutex;
+    std::vector<Node*> mRetired;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_ATOMIC_SHARED_OPTIONAL_HPP_
@@ -0,0 +1,101 @@
+#ifndef UTILS_BITMAP_HPP_
+#define UTILS_BITMAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libOptional {
+
+namespace detail {
+
+    static constexpr std::size_t BitsPerWord = 64;
+
+    /// Number of 64-bit words needed to hold \p bits bits
+    constexpr std::size_t wordCount(std::size_t bits) noexcept {
+        return (bits + BitsPerWord - 1) / BitsPerWord;
+    }
+
+    constexpr std::size_t wordIndex(std::size_t bit) noexcept {
+        return bit / BitsPerWord;
+    }
+
+    constexpr std::uint64_t bitMask(std::size_t bit) noexcept {
+        return std::uint64_t(1) << (bit % BitsPerWord);
+    }
+
+    /// Mask with the lowest \p bits bits set, \p bits must be in range [0, 64]
+    constexpr std::uint64_t lowMask(std::size_t bits) noexcept {
+        return bits >= BitsPerWord ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+    }
+
+    inline bool testBit(const std::uint64_t* words, std::size_t bit) noexcept {
+        return (words[wordIndex(bit)] & bitMask(bit)) != 0;
+    }
+
+    inline void setBit(std::uint64_t* words, std::size_t bit) noexcept {
+        words[wordIndex(bit)] |= bitMask(bit);
+    }
+
+    inline void clearBit(std::uint64_t* words, std::size_t bit) noexcept {
+        words[wordIndex(bit)] &= ~bitMask(bit);
+    }
+
+    inline unsigned popcount(std::uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+        word = word - ((word >> 1) & 0x5555555555555555ULL);
+        word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+        word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<unsigned>((word * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    /// Index of the lowest set bit, \p word must not be zero
+    inline unsigned countTrailingZeros(std::uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+        unsigned n = 0;
+        while ((word & 1) == 0) {
+            word >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    /// Number of set bits in the first \p bits bits of \p words
+    inline std::size_t countSetBits(const std::uint64_t* words, std::size_t bits) noexcept {
+        std::size_t count = 0;
+        const std::size_t fullWords = bits / BitsPerWord;
+        for (std::size_t i = 0; i < fullWords; ++i) {
+            count += popcount(words[i]);
+        }
+        if (bits % BitsPerWord != 0) {
+            count += popcount(words[fullWords] & lowMask(bits % BitsPerWord));
+        }
+        return count;
+    }
+
+    /// Calls \p func with the index of every set bit among the first \p bits bits of \p words
+    template <typename TFunc>
+    void forEachSetBit(const std::uint64_t* words, std::size_t bits, TFunc&& func) {
+        const std::size_t count = wordCount(bits);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint64_t word = words[i];
+            if (i + 1 == count && bits % BitsPerWord != 0) {
+                word &= lowMask(bits % BitsPerWord);
+            }
+            while (word != 0) {
+                func(i * BitsPerWord + countTrailingZeros(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+} // namespace detail
+
+} // namespace libOptional
+
+#endif // UTILS_BITMAP_HPP_
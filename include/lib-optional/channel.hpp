@@ -0,0 +1,201 @@
+#ifndef UTILS_CHANNEL_HPP_
+#define UTILS_CHANNEL_HPP_
+
+#include "lib-optional/concurrency.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace libOptional {
+
+/// Unbounded multi-producer/single-consumer channel with blocking, timed and batched receives
+///
+/// Messages travel through Dmitry Vyukov's intrusive MPSC queue, so sending is one atomic
+/// compare-and-swap of the head plus an allocation and never blocks. Closing swaps an end marker
+/// into the head: senders that find it there are rejected, and every accepted message is linked
+/// in front of it, so the receiver drains exactly the accepted messages and stops at the marker.
+/// A receiver that finds the channel empty spins for a while and then parks on a condition
+/// variable; senders only touch the mutex when the receiver is actually parked.
+///
+/// All receive functions return an empty Optional on timeout or once the channel is closed and
+/// drained, and must only be called from one thread at a time.
+template <typename T>
+class Channel final {
+public:
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    /// \param spinCount How many times an empty channel is polled before the receiver parks
+    explicit Channel(std::size_t spinCount = 1000)
+        : mSpinCount(spinCount)
+        , mHead(new Node())
+        , mTail(mHead.load(std::memory_order_relaxed)) {}
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    ~Channel() {
+        while (mTail != nullptr && mTail != end()) {
+            Node* next = mTail->next.load(std::memory_order_relaxed);
+            delete mTail;
+            mTail = next;
+        }
+    }
+
+    /// Constructs a message from \p args, returns false if the channel is closed
+    template <typename... TArgs>
+    bool emplace(TArgs&&... args) {
+        Node* previous = mHead.load(std::memory_order_relaxed);
+        if (previous == end()) {
+            return false;
+        }
+        std::unique_ptr<Node> node(new Node());
+        node->value.emplace(std::forward<TArgs>(args)...);
+        // A compare-and-swap rather than an exchange, so a sender never replaces the end marker
+        do {
+            if (previous == end()) {
+                return false;
+            }
+        } while (!mHead.compare_exchange_weak(
+            previous, node.get(), std::memory_order_acq_rel, std::memory_order_relaxed));
+        previous->next.store(node.release(), std::memory_order_release);
+        wake();
+        return true;
+    }
+
+    bool send(const T& value) { return emplace(value); }
+
+    bool send(T&& value) { return emplace(std::move(value)); }
+
+    /// Wakes the receiver, which drains the remaining messages and then gets empty results
+    void close() {
+        Node* last = mHead.exchange(end(), std::memory_order_acq_rel);
+        if (last != end()) {
+            last->next.store(end(), std::memory_order_release);
+            wake();
+        }
+    }
+
+    bool closed() const noexcept { return mHead.load(std::memory_order_acquire) == end(); }
+
+    /// Takes a message if one is ready, never blocks
+    Optional<T> tryReceive() {
+        Node* next = mTail->next.load(std::memory_order_acquire);
+        if (next == nullptr || next == end()) {
+            return NullOptional;
+        }
+        // The next node becomes the new stub, its value is moved out
+        Optional<T> result(std::move(next->value));
+        next->value.reset();
+        delete mTail;
+        mTail = next;
+        return result;
+    }
+
+    /// Waits until a message arrives or the channel is closed
+    Optional<T> receive() { return receiveUntil(nullptr); }
+
+    /// Waits at most \p timeout for a message
+    template <typename TRep, typename TPeriod>
+    Optional<T> receiveFor(const std::chrono::duration<TRep, TPeriod>& timeout) {
+        const std::chrono::steady_clock::time_point deadline =
+            std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+        return receiveUntil(&deadline);
+    }
+
+    /// Waits at most \p timeout for the first message, then takes up to \p max messages that are
+    /// ready without waiting again and writes them to \p out
+    ///
+    /// \return The number of messages written
+    template <typename TOutputIterator, typename TRep, typename TPeriod>
+    std::size_t receiveMany(TOutputIterator out,
+                            std::size_t max,
+                            const std::chrono::duration<TRep, TPeriod>& timeout) {
+        if (max == 0) {
+            return 0;
+        }
+        Optional<T> first = receiveFor(timeout);
+        if (!first) {
+            return 0;
+        }
+        *out = std::move(*first);
+        ++out;
+        std::size_t count = 1;
+        for (; count < max; ++count) {
+            Optional<T> next = tryReceive();
+            if (!next) {
+                break;
+            }
+            *out = std::move(*next);
+            ++out;
+        }
+        return count;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{ nullptr };
+        Optional<T> value;
+    };
+
+    /// Whether a message is ready or the channel is closed and drained
+    bool ready() const noexcept { return mTail->next.load(std::memory_order_acquire) != nullptr; }
+
+    /// The marker linked after the last accepted message once the channel is closed
+    Node* end() noexcept { return &mEnd; }
+
+    const Node* end() const noexcept { return &mEnd; }
+
+    /// \param deadline Null to wait without a time limit
+    Optional<T> receiveUntil(const std::chrono::steady_clock::time_point* deadline) {
+        for (std::size_t i = 0; i < mSpinCount; ++i) {
+            if (ready()) {
+                return tryReceive();
+            }
+            detail::cpuRelax();
+        }
+        // Pairs with the fence in wake(): either the sender sees mParked or we see its message
+        mParked.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            if (deadline) {
+                mCondition.wait_until(lock, *deadline, [this] { return ready(); });
+            } else {
+                mCondition.wait(lock, [this] { return ready(); });
+            }
+        }
+        mParked.store(false, std::memory_order_relaxed);
+        return tryReceive();
+    }
+
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mParked.load(std::memory_order_relaxed)) {
+            // Taking the mutex orders the notification after the receiver's predicate check
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+            }
+            mCondition.notify_one();
+        }
+    }
+
+    const std::size_t mSpinCount;
+    alignas(detail::CacheLineSize) std::atomic<Node*> mHead;
+    alignas(detail::CacheLineSize) Node* mTail;
+    std::atomic<bool> mParked{ false };
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    Node mEnd;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_CHANNEL_HPP_
@@ -0,0 +1,211 @@
+#ifndef UTILS_CHUNKED_COLUMN_HPP_
+#define UTILS_CHUNKED_COLUMN_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional.hpp"
+#include "lib-optional/optional_span.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace libOptional {
+
+/// Append-optimized nullable column made of fixed-size chunks
+///
+/// Every chunk holds TChunkSize values together with their validity bitmap. Chunks are never
+/// reallocated, so appending never copies already stored elements and their addresses stay
+/// stable for the lifetime of the column. Each chunk is exposed as an OptionalSpan, so the
+/// kernels can be applied chunk by chunk.
+template <typename T, std::size_t TChunkSize = 4096>
+class ChunkedColumn final {
+public:
+    static_assert(TChunkSize > 0 && TChunkSize % detail::BitsPerWord == 0,
+                  "The chunk size must be a non-zero multiple of 64");
+    static_assert(std::is_default_constructible<T>::value,
+                  "The underlying type of ChunkedColumn must be default-constructible");
+
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    static constexpr std::size_t ChunkSize = TChunkSize;
+
+    ChunkedColumn() = default;
+    ChunkedColumn(const ChunkedColumn&) = delete;
+    ChunkedColumn& operator=(const ChunkedColumn&) = delete;
+
+    ChunkedColumn(ChunkedColumn&& other) noexcept
+        : mChunks(std::move(other.mChunks))
+        , mSize(other.mSize) {
+        other.mChunks.clear();
+        other.mSize = 0;
+    }
+
+    ChunkedColumn& operator=(ChunkedColumn&& other) noexcept {
+        if (this != &other) {
+            mChunks = std::move(other.mChunks);
+            mSize = other.mSize;
+            other.mChunks.clear();
+            other.mSize = 0;
+        }
+        return *this;
+    }
+
+    std::size_t size() const noexcept { return mSize; }
+
+    bool empty() const noexcept { return mSize == 0; }
+
+    std::size_t chunkCount() const noexcept { return (mSize + TChunkSize - 1) / TChunkSize; }
+
+    /// Number of elements the column can hold without allocating a new chunk
+    std::size_t capacity() const noexcept { return mChunks.size() * TChunkSize; }
+
+    /// Allocates chunks up front so that the next appends up to \p size elements don't allocate
+    void reserve(std::size_t size) {
+        mChunks.reserve((size + TChunkSize - 1) / TChunkSize);
+        while (capacity() < size) {
+            mChunks.push_back(std::unique_ptr<Chunk>(new Chunk()));
+        }
+    }
+
+    void append(const T& value) { store(value); }
+
+    void append(T&& value) { store(std::move(value)); }
+
+    void append(const Optional<T>& value) {
+        if (value) {
+            store(*value);
+        } else {
+            appendNull();
+        }
+    }
+
+    void append(Optional<T>&& value) {
+        if (value) {
+            store(std::move(*value));
+        } else {
+            appendNull();
+        }
+    }
+
+    /// Appends an element by assigning T(\p args...) to the default-constructed value of its slot
+    ///
+    /// \note Every slot of a chunk holds a live T, so that chunks can be exposed as OptionalSpans,
+    ///       which is why the element is assigned rather than constructed in place. T must be
+    ///       move-assignable.
+    template <typename... TArgs>
+    T& emplaceBack(TArgs&&... args) {
+        return store(T(std::forward<TArgs>(args)...));
+    }
+
+    void appendNull() {
+        tail();
+        ++mSize;
+    }
+
+    /// Removes the elements from \p size on, allocated chunks are kept for reuse
+    void truncate(std::size_t size) {
+        for (std::size_t i = size; i < mSize; ++i) {
+            Chunk& chunk = *mChunks[i / TChunkSize];
+            chunk.values[i % TChunkSize] = T();
+            detail::clearBit(chunk.validity, i % TChunkSize);
+        }
+        mSize = std::min(mSize, size);
+    }
+
+    /// Removes all elements, allocated chunks are kept for reuse
+    void clear() {
+        for (std::size_t i = 0; i < chunkCount(); ++i) {
+            Chunk& chunk = *mChunks[i];
+            for (std::size_t j = 0; j < TChunkSize; ++j) {
+                chunk.values[j] = T();
+            }
+            for (std::size_t j = 0; j < WordsPerChunk; ++j) {
+                chunk.validity[j] = 0;
+            }
+        }
+        mSize = 0;
+    }
+
+    bool isValid(std::size_t index) const noexcept {
+        assert(index < mSize);
+        return detail::testBit(mChunks[index / TChunkSize]->validity, index % TChunkSize);
+    }
+
+    Optional<const T&> operator[](std::size_t index) const noexcept {
+        if (!isValid(index)) {
+            return NullOptional;
+        }
+        return mChunks[index / TChunkSize]->values[index % TChunkSize];
+    }
+
+    Optional<T&> operator[](std::size_t index) noexcept {
+        if (!isValid(index)) {
+            return NullOptional;
+        }
+        return mChunks[index / TChunkSize]->values[index % TChunkSize];
+    }
+
+    /// View of the chunk at \p index, only the last chunk may be shorter than TChunkSize
+    OptionalSpan<T> chunk(std::size_t index) const noexcept {
+        assert(index < chunkCount());
+        const std::size_t begin = index * TChunkSize;
+        const std::size_t count = mSize - begin < TChunkSize ? mSize - begin : TChunkSize;
+        return OptionalSpan<T>(mChunks[index]->values, mChunks[index]->validity, count);
+    }
+
+    /// Calls \p func with an OptionalSpan of every non-empty chunk in order
+    template <typename TFunc>
+    void forEachChunk(TFunc&& func) const {
+        const std::size_t count = chunkCount();
+        for (std::size_t i = 0; i < count; ++i) {
+            func(chunk(i));
+        }
+    }
+
+private:
+    static constexpr std::size_t WordsPerChunk = TChunkSize / detail::BitsPerWord;
+
+    struct Chunk {
+        T values[TChunkSize];
+        std::uint64_t validity[WordsPerChunk];
+    };
+
+    Chunk& tail() {
+        const std::size_t index = mSize / TChunkSize;
+        if (index == mChunks.size()) {
+            mChunks.push_back(std::unique_ptr<Chunk>(new Chunk()));
+        }
+        return *mChunks[index];
+    }
+
+    /// Assigns \p value to the next slot and marks it valid
+    template <typename TArg>
+    T& store(TArg&& value) {
+        Chunk& chunk = tail();
+        const std::size_t offset = mSize % TChunkSize;
+        T& slot = chunk.values[offset];
+        slot = std::forward<TArg>(value);
+        detail::setBit(chunk.validity, offset);
+        ++mSize;
+        return slot;
+    }
+
+    std::vector<std::unique_ptr<Chunk>> mChunks;
+    std::size_t mSize = 0;
+};
+
+template <typename T, std::size_t TChunkSize>
+constexpr std::size_t ChunkedColumn<T, TChunkSize>::ChunkSize;
+
+template <typename T, std::size_t TChunkSize>
+constexpr std::size_t ChunkedColumn<T, TChunkSize>::WordsPerChunk;
+
+} // namespace libOptional
+
+#endif // UTILS_CHUNKED_COLUMN_HPP_
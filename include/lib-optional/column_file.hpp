@@ -0,0 +1,452 @@
+#ifndef UTILS_COLUMN_FILE_HPP_
+#define UTILS_COLUMN_FILE_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional.hpp"
+#include "lib-optional/optional_span.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace libOptional {
+
+class ColumnFileError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/// On-disk format of a nullable column (version 1), all integers in native byte order:
+///
+///   offset 0                    ColumnFileHeader (128 bytes)
+///   header.valuesOffset         rows * valueSize bytes of values, page aligned
+///   header.validityOffset       wordCount(rows) 64-bit validity words, 64-byte aligned
+///   header.checksumsOffset      one 64-bit checksum per block of header.blockRows rows
+///
+/// The values of disengaged rows are zero. A block checksum covers the values and the validity
+/// words of its rows, so any block can be verified without touching the rest of the file.
+struct ColumnFileHeader {
+    static constexpr std::uint32_t CurrentVersion = 1;
+    static constexpr std::uint32_t ByteOrderMark = 0x01020304;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t valueSize;
+    std::uint64_t rows;
+    std::uint64_t blockRows;
+    std::uint64_t valuesOffset;
+    std::uint64_t validityOffset;
+    std::uint64_t checksumsOffset;
+    std::uint64_t fileSize;
+    std::uint64_t headerChecksum;
+    std::uint64_t reserved[6];
+};
+
+static_assert(sizeof(ColumnFileHeader) == 128, "The column file header must be 128 bytes");
+
+namespace detail {
+
+    static constexpr char ColumnFileMagic[8] = { 'L', 'O', 'P', 'T', 'C', 'O', 'L', '\0' };
+    static constexpr std::uint64_t ColumnFilePageSize = 4096;
+
+    constexpr std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) noexcept {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /// Largest file size whose layout is accepted, every offset must fit in std::size_t
+    static constexpr std::uint64_t MaxColumnFileSize = std::numeric_limits<std::size_t>::max();
+
+    /// \p value + \p addend, throws ColumnFileError if the sum exceeds MaxColumnFileSize
+    inline std::uint64_t layoutAdd(std::uint64_t value, std::uint64_t addend) {
+        if (value > MaxColumnFileSize || addend > MaxColumnFileSize - value) {
+            throw ColumnFileError("The column file layout is too large");
+        }
+        return value + addend;
+    }
+
+    /// alignUp() that throws ColumnFileError if the result exceeds MaxColumnFileSize
+    inline std::uint64_t layoutAlignUp(std::uint64_t value, std::uint64_t alignment) {
+        return layoutAdd(value, alignment - 1) / alignment * alignment;
+    }
+
+    inline std::uint64_t rotateLeft(std::uint64_t value, unsigned bits) noexcept {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    /// Fast non-cryptographic 64-bit checksum, four independent lanes keep the multipliers busy
+    inline std::uint64_t checksum64(const void* data, std::size_t size, std::uint64_t seed = 0) noexcept {
+        static constexpr std::uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+        static constexpr std::uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        std::uint64_t lanes[4] = { seed + Prime1, seed + Prime2, seed, seed - Prime1 };
+        std::size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            for (std::size_t lane = 0; lane < 4; ++lane) {
+                std::uint64_t word;
+                std::memcpy(&word, bytes + i + lane * 8, 8);
+                lanes[lane] = rotateLeft(lanes[lane] + word * Prime2, 31) * Prime1;
+            }
+        }
+        std::uint64_t hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) +
+                             rotateLeft(lanes[3], 18) + size;
+        for (; i < size; ++i) {
+            hash = rotateLeft(hash ^ (bytes[i] * Prime1), 11) * Prime2;
+        }
+        hash ^= hash >> 33;
+        hash *= Prime2;
+        hash ^= hash >> 29;
+        return hash;
+    }
+
+    inline std::system_error systemError(const std::string& what) {
+        return std::system_error(errno, std::generic_category(), what);
+    }
+
+    /// Closes the file descriptor when going out of scope
+    class FileDescriptor final {
+    public:
+        explicit FileDescriptor(int fd) noexcept
+            : mFd(fd) {}
+
+        FileDescriptor(const FileDescriptor&) = delete;
+        FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+        FileDescriptor(FileDescriptor&& other) noexcept
+            : mFd(other.mFd) {
+            other.mFd = -1;
+        }
+
+        FileDescriptor& operator=(FileDescriptor&& other) noexcept {
+            std::swap(mFd, other.mFd);
+            return *this;
+        }
+
+        ~FileDescriptor() noexcept {
+            if (mFd >= 0) {
+                ::close(mFd);
+            }
+        }
+
+        int get() const noexcept { return mFd; }
+
+    private:
+        int mFd;
+    };
+
+    inline void writeAt(int fd, const void* data, std::size_t size, std::uint64_t offset) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            const ssize_t written = ::pwrite(fd, bytes, size, off_t(offset));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw systemError("Failed to write column file");
+            }
+            bytes += written;
+            size -= std::size_t(written);
+            offset += std::uint64_t(written);
+        }
+    }
+
+    inline void readAt(int fd, void* data, std::size_t size, std::uint64_t offset) {
+        char* bytes = static_cast<char*>(data);
+        while (size > 0) {
+            const ssize_t read = ::pread(fd, bytes, size, off_t(offset));
+            if (read < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw systemError("Failed to read column file");
+            }
+            if (read == 0) {
+                throw ColumnFileError("Unexpected end of column file");
+            }
+            bytes += read;
+            size -= std::size_t(read);
+            offset += std::uint64_t(read);
+        }
+    }
+
+    /// Layout of a column file with the given parameters, checksums excluded
+    ///
+    /// \throw ColumnFileError If the parameters are invalid or the file would not be addressable
+    inline ColumnFileHeader makeColumnFileHeader(std::uint64_t valueSize,
+                                                 std::uint64_t rows,
+                                                 std::uint64_t blockRows) {
+        if (blockRows == 0 || blockRows % BitsPerWord != 0) {
+            throw ColumnFileError("The block size must be a non-zero multiple of 64 rows");
+        }
+        if (valueSize == 0) {
+            throw ColumnFileError("The value size must not be zero");
+        }
+        const std::uint64_t valuesOffset = alignUp(sizeof(ColumnFileHeader), ColumnFilePageSize);
+        if (rows > (MaxColumnFileSize - valuesOffset) / valueSize) {
+            throw ColumnFileError("The column file layout is too large");
+        }
+        ColumnFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, ColumnFileMagic, sizeof(header.magic));
+        header.version = ColumnFileHeader::CurrentVersion;
+        header.byteOrder = ColumnFileHeader::ByteOrderMark;
+        header.valueSize = valueSize;
+        header.rows = rows;
+        header.blockRows = blockRows;
+        header.valuesOffset = valuesOffset;
+        // The bound on rows keeps the products and word counts from wrapping, the sums are checked
+        const std::uint64_t blocks = rows / blockRows + (rows % blockRows != 0 ? 1 : 0);
+        header.validityOffset = layoutAlignUp(valuesOffset + rows * valueSize, 64);
+        header.checksumsOffset =
+            layoutAlignUp(layoutAdd(header.validityOffset, wordCount(std::size_t(rows)) * 8), 64);
+        header.fileSize = layoutAdd(header.checksumsOffset, blocks * 8);
+        return header;
+    }
+
+    inline std::uint64_t headerChecksum(const ColumnFileHeader& header) noexcept {
+        return checksum64(&header, offsetof(ColumnFileHeader, headerChecksum));
+    }
+
+    /// Throws ColumnFileError unless \p header describes a valid column of values of \p valueSize
+    /// bytes stored in the file \p path of \p fileSize bytes
+    inline void validateColumnFileHeader(const ColumnFileHeader& header,
+                                         std::uint64_t valueSize,
+                                         std::uint64_t fileSize,
+                                         const std::string& path) {
+        if (std::memcmp(header.magic, ColumnFileMagic, sizeof(header.magic)) != 0) {
+            throw ColumnFileError(path + " is not a column file");
+        }
+        if (header.version != ColumnFileHeader::CurrentVersion) {
+            throw ColumnFileError("Unsupported column file version " + std::to_string(header.version));
+        }
+        if (header.byteOrder != ColumnFileHeader::ByteOrderMark) {
+            throw ColumnFileError("Column file " + path + " was written with a different byte order");
+        }
+        if (header.headerChecksum != headerChecksum(header)) {
+            throw ColumnFileError("Column file " + path + " has a corrupted header");
+        }
+        if (header.valueSize != valueSize) {
+            throw ColumnFileError("Column file " + path + " stores values of size " +
+                                  std::to_string(header.valueSize) + ", expected " +
+                                  std::to_string(valueSize));
+        }
+        ColumnFileHeader expected;
+        try {
+            expected = makeColumnFileHeader(header.valueSize, header.rows, header.blockRows);
+        } catch (const ColumnFileError&) {
+            throw ColumnFileError("Column file " + path + " has an invalid layout");
+        }
+        if (expected.valuesOffset != header.valuesOffset ||
+            expected.validityOffset != header.validityOffset ||
+            expected.checksumsOffset != header.checksumsOffset || expected.fileSize != header.fileSize ||
+            header.fileSize > fileSize) {
+            throw ColumnFileError("Column file " + path + " has an invalid layout");
+        }
+    }
+
+    /// Checksum of a block of \p count rows starting at row \p first,
+    /// \p values and \p validity point to the first row of the block
+    inline std::uint64_t blockChecksum(const void* values,
+                                       const std::uint64_t* validity,
+                                       std::uint64_t valueSize,
+                                       std::uint64_t first,
+                                       std::uint64_t count) noexcept {
+        const std::uint64_t valuesHash = checksum64(values, std::size_t(count * valueSize), first);
+        return checksum64(validity, std::size_t(wordCount(count) * 8), valuesHash);
+    }
+
+} // namespace detail
+
+/// Writes \p column to a new column file at \p path, replacing any existing file
+///
+/// The file is written to \p path + ".tmp" and renamed over \p path once it is complete and
+/// synced, so mappings of the previous file stay valid and a failed write leaves it untouched.
+///
+/// TColumn is any nullable column with size() and operator[] returning Optional<const T&>,
+/// such as OptionalSpan or ChunkedColumn.
+template <typename TColumn>
+void writeColumnFile(const std::string& path, const TColumn& column, std::size_t blockRows = 65536) {
+    using T = typename TColumn::ValueType;
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be stored");
+    ColumnFileHeader header = detail::makeColumnFileHeader(sizeof(T), column.size(), blockRows);
+
+    const std::string temporary = path + ".tmp";
+    detail::FileDescriptor fd(::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    if (fd.get() < 0) {
+        throw detail::systemError("Failed to create column file " + temporary);
+    }
+    try {
+        if (::ftruncate(fd.get(), off_t(header.fileSize)) != 0) {
+            throw detail::systemError("Failed to resize column file " + path);
+        }
+
+        // The file is written block by block, disengaged rows are stored as zeros, so the file
+        // doesn't depend on their unspecified values
+        std::vector<unsigned char> values;
+        std::vector<std::uint64_t> validity;
+        std::vector<std::uint64_t> checksums;
+        for (std::uint64_t first = 0; first < column.size(); first += blockRows) {
+            const std::size_t count =
+                std::size_t(std::min<std::uint64_t>(blockRows, column.size() - first));
+            values.assign(count * sizeof(T), 0);
+            validity.assign(detail::wordCount(count), 0);
+            for (std::size_t i = 0; i < count; ++i) {
+                const Optional<const T&> value = column[std::size_t(first) + i];
+                if (value) {
+                    std::memcpy(values.data() + i * sizeof(T), &*value, sizeof(T));
+                    detail::setBit(validity.data(), i);
+                }
+            }
+            checksums.push_back(
+                detail::blockChecksum(values.data(), validity.data(), sizeof(T), first, count));
+            detail::writeAt(fd.get(), values.data(), values.size(), header.valuesOffset + first * sizeof(T));
+            detail::writeAt(
+                fd.get(), validity.data(), validity.size() * 8, header.validityOffset + first / 8);
+        }
+        detail::writeAt(fd.get(), checksums.data(), checksums.size() * 8, header.checksumsOffset);
+        header.headerChecksum = detail::headerChecksum(header);
+        detail::writeAt(fd.get(), &header, sizeof(header), 0);
+        if (::fsync(fd.get()) != 0) {
+            throw detail::systemError("Failed to sync column file " + path);
+        }
+        if (::rename(temporary.c_str(), path.c_str()) != 0) {
+            throw detail::systemError("Failed to replace column file " + path);
+        }
+    } catch (...) {
+        ::unlink(temporary.c_str());
+        throw;
+    }
+}
+
+/// Read-only, memory-mapped view of a column file
+///
+/// Opening the file only validates its header, the data is paged in lazily by the kernel
+/// as the returned spans are accessed. Block checksums are verified on request.
+template <typename T>
+class MappedColumn final {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be stored");
+
+    explicit MappedColumn(const std::string& path) {
+        detail::FileDescriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (fd.get() < 0) {
+            throw detail::systemError("Failed to open column file " + path);
+        }
+        struct stat info;
+        if (::fstat(fd.get(), &info) != 0) {
+            throw detail::systemError("Failed to stat column file " + path);
+        }
+        if (std::uint64_t(info.st_size) < sizeof(ColumnFileHeader)) {
+            throw ColumnFileError("Column file " + path + " is truncated");
+        }
+        mSize = std::size_t(info.st_size);
+        mData = ::mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd.get(), 0);
+        if (mData == MAP_FAILED) {
+            mData = nullptr;
+            throw detail::systemError("Failed to map column file " + path);
+        }
+        try {
+            detail::validateColumnFileHeader(header(), sizeof(T), mSize, path);
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    MappedColumn(const MappedColumn&) = delete;
+    MappedColumn& operator=(const MappedColumn&) = delete;
+
+    MappedColumn(MappedColumn&& other) noexcept
+        : mData(other.mData)
+        , mSize(other.mSize) {
+        other.mData = nullptr;
+        other.mSize = 0;
+    }
+
+    MappedColumn& operator=(MappedColumn&& other) noexcept {
+        std::swap(mData, other.mData);
+        std::swap(mSize, other.mSize);
+        return *this;
+    }
+
+    ~MappedColumn() noexcept { unmap(); }
+
+    const ColumnFileHeader& header() const noexcept { return *static_cast<const ColumnFileHeader*>(mData); }
+
+    std::size_t size() const noexcept { return std::size_t(header().rows); }
+
+    /// Zero-copy view of the whole column
+    OptionalSpan<T> span() const noexcept { return OptionalSpan<T>(values(), validity(), size()); }
+
+    std::size_t blockRows() const noexcept { return std::size_t(header().blockRows); }
+
+    std::size_t blockCount() const noexcept {
+        return size() / blockRows() + (size() % blockRows() != 0 ? 1 : 0);
+    }
+
+    /// Zero-copy view of the rows of block \p index
+    OptionalSpan<T> block(std::size_t index) const noexcept {
+        const std::size_t first = index * blockRows();
+        return span().subspan(first, std::min(blockRows(), size() - first));
+    }
+
+    /// Checks the checksum of block \p index
+    bool verifyBlock(std::size_t index) const noexcept {
+        const std::uint64_t first = std::uint64_t(index) * blockRows();
+        const std::uint64_t count = std::min<std::uint64_t>(blockRows(), size() - first);
+        const std::uint64_t* checksums = reinterpret_cast<const std::uint64_t*>(
+            static_cast<const unsigned char*>(mData) + header().checksumsOffset);
+        return checksums[index] ==
+               detail::blockChecksum(
+                   values() + first, validity() + detail::wordIndex(first), sizeof(T), first, count);
+    }
+
+    /// Checks the checksums of all blocks, touching the whole file
+    bool verify() const noexcept {
+        for (std::size_t i = 0; i < blockCount(); ++i) {
+            if (!verifyBlock(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const T* values() const noexcept {
+        return reinterpret_cast<const T*>(static_cast<const unsigned char*>(mData) + header().valuesOffset);
+    }
+
+    const std::uint64_t* validity() const noexcept {
+        return reinterpret_cast<const std::uint64_t*>(static_cast<const unsigned char*>(mData) +
+                                                      header().validityOffset);
+    }
+
+    void unmap() noexcept {
+        if (mData) {
+            ::munmap(mData, mSize);
+            mData = nullptr;
+        }
+    }
+
+    void* mData = nullptr;
+    std::size_t mSize = 0;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_COLUMN_FILE_HPP_
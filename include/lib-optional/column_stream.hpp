@@ -0,0 +1,209 @@
+#ifndef UTILS_COLUMN_STREAM_HPP_
+#define UTILS_COLUMN_STREAM_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/column_file.hpp"
+#include "lib-optional/optional.hpp"
+#include "lib-optional/optional_span.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+namespace libOptional {
+
+/// Sequential reader of a column file using a constant amount of memory
+///
+/// The file is read one block at a time with pread. A background thread reads the next block
+/// into a second buffer while the caller processes the current one, and the kernel is asked to
+/// read ahead the block after that. Memory use is two blocks regardless of the file size.
+template <typename T>
+class ColumnFileStream final {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be stored");
+
+    /// Opens the column file at \p path
+    ///
+    /// \param verify Check the checksum of every block before handing it out
+    explicit ColumnFileStream(const std::string& path, bool verify = true)
+        : mFd(::open(path.c_str(), O_RDONLY | O_CLOEXEC))
+        , mPath(path)
+        , mVerify(verify) {
+        if (mFd.get() < 0) {
+            throw detail::systemError("Failed to open column file " + path);
+        }
+        struct stat info;
+        if (::fstat(mFd.get(), &info) != 0) {
+            throw detail::systemError("Failed to stat column file " + path);
+        }
+        if (std::uint64_t(info.st_size) < sizeof(ColumnFileHeader)) {
+            throw ColumnFileError("Column file " + path + " is truncated");
+        }
+        detail::readAt(mFd.get(), &mHeader, sizeof(mHeader), 0);
+        detail::validateColumnFileHeader(mHeader, sizeof(T), std::uint64_t(info.st_size), path);
+#if defined(POSIX_FADV_SEQUENTIAL)
+        ::posix_fadvise(mFd.get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+        // No block holds more rows than the file, so a small file declaring huge blocks doesn't get
+        // huge buffers
+        const std::size_t bufferRows = std::size_t(
+            std::min<std::uint64_t>(mHeader.blockRows, detail::wordCount(size()) * detail::BitsPerWord));
+        for (Buffer& buffer : mBuffers) {
+            buffer.values.reset(new T[bufferRows]);
+            buffer.validity.reset(new std::uint64_t[detail::wordCount(bufferRows)]);
+        }
+        mThread = std::thread(&ColumnFileStream::readAhead, this);
+    }
+
+    ColumnFileStream(const ColumnFileStream&) = delete;
+    ColumnFileStream& operator=(const ColumnFileStream&) = delete;
+
+    ~ColumnFileStream() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopped = true;
+        }
+        mCondition.notify_all();
+        mThread.join();
+    }
+
+    const ColumnFileHeader& header() const noexcept { return mHeader; }
+
+    std::size_t size() const noexcept { return std::size_t(mHeader.rows); }
+
+    std::size_t blockCount() const noexcept {
+        return std::size_t(mHeader.rows / mHeader.blockRows +
+                           (mHeader.rows % mHeader.blockRows != 0 ? 1 : 0));
+    }
+
+    /// View of the next block or NullOptional after the last block
+    ///
+    /// The returned view stays valid until the next call.
+    Optional<OptionalSpan<T>> next() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mCurrent > 0) {
+            // The caller is done with the previous block, its buffer can be refilled
+            mBuffers[(mCurrent - 1) % 2].filled = false;
+            mCondition.notify_all();
+        }
+        if (mCurrent == blockCount()) {
+            return NullOptional;
+        }
+        Buffer& buffer = mBuffers[mCurrent % 2];
+        mCondition.wait(lock, [&] { return buffer.filled || mError; });
+        if (!buffer.filled) {
+            std::rethrow_exception(mError);
+        }
+        const std::size_t first = mCurrent * std::size_t(mHeader.blockRows);
+        ++mCurrent;
+        return OptionalSpan<T>(buffer.values.get(),
+                               buffer.validity.get(),
+                               std::min(std::size_t(mHeader.blockRows), size() - first));
+    }
+
+private:
+    struct Buffer {
+        std::unique_ptr<T[]> values;
+        std::unique_ptr<std::uint64_t[]> validity;
+        bool filled = false;
+    };
+
+    void readAhead() noexcept {
+        try {
+            std::vector<std::uint64_t> checksums(blockCount());
+            if (mVerify) {
+                detail::readAt(mFd.get(), checksums.data(), checksums.size() * 8, mHeader.checksumsOffset);
+            }
+            for (std::size_t block = 0; block < blockCount(); ++block) {
+                Buffer& buffer = mBuffers[block % 2];
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mCondition.wait(lock, [&] { return !buffer.filled || mStopped; });
+                    if (mStopped) {
+                        return;
+                    }
+                }
+                const std::uint64_t first = std::uint64_t(block) * mHeader.blockRows;
+                const std::uint64_t count = std::min(mHeader.blockRows, mHeader.rows - first);
+                adviseWillNeed(block + 1);
+                detail::readAt(mFd.get(),
+                               buffer.values.get(),
+                               std::size_t(count * sizeof(T)),
+                               mHeader.valuesOffset + first * sizeof(T));
+                detail::readAt(mFd.get(),
+                               buffer.validity.get(),
+                               std::size_t(detail::wordCount(count) * 8),
+                               mHeader.validityOffset + first / 8);
+                if (mVerify && checksums[block] != detail::blockChecksum(buffer.values.get(),
+                                                                         buffer.validity.get(),
+                                                                         sizeof(T),
+                                                                         first,
+                                                                         count)) {
+                    throw ColumnFileError("Column file " + mPath + " has a corrupted block " +
+                                          std::to_string(block));
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    buffer.filled = true;
+                }
+                mCondition.notify_all();
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mError = std::current_exception();
+            }
+            mCondition.notify_all();
+        }
+    }
+
+    /// Asks the kernel to start reading block \p block in the background
+    void adviseWillNeed(std::size_t block) const noexcept {
+#if defined(POSIX_FADV_WILLNEED)
+        if (block < blockCount()) {
+            const std::uint64_t first = std::uint64_t(block) * mHeader.blockRows;
+            const std::uint64_t count = std::min(mHeader.blockRows, mHeader.rows - first);
+            ::posix_fadvise(mFd.get(),
+                            off_t(mHeader.valuesOffset + first * sizeof(T)),
+                            off_t(count * sizeof(T)),
+                            POSIX_FADV_WILLNEED);
+            ::posix_fadvise(mFd.get(),
+                            off_t(mHeader.validityOffset + first / 8),
+                            off_t(detail::wordCount(count) * 8),
+                            POSIX_FADV_WILLNEED);
+        }
+#else
+        (void)block;
+#endif
+    }
+
+    detail::FileDescriptor mFd;
+    const std::string mPath;
+    const bool mVerify;
+    ColumnFileHeader mHeader;
+
+    Buffer mBuffers[2];
+    std::size_t mCurrent = 0;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStopped = false;
+    std::exception_ptr mError;
+    std::thread mThread;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_COLUMN_STREAM_HPP_
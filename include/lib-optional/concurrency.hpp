@@ -0,0 +1,79 @@
+#ifndef UTILS_CONCURRENCY_HPP_
+#define UTILS_CONCURRENCY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace libOptional {
+
+namespace detail {
+
+    /// Assumed size of a cache line, used to keep independently written data apart
+    static constexpr std::size_t CacheLineSize = 64;
+
+    /// Hint to the CPU that the calling thread is spinning on a shared location
+    inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    /// Fixed-size heap array of default-constructed T whose first element starts on a cache line
+    ///
+    /// operator new only guarantees fundamental alignment before C++17, so the alignment is done
+    /// by hand. Meant for the slots of concurrent containers, which are padded to a cache line.
+    template <typename T>
+    class CacheAlignedArray final {
+    public:
+        explicit CacheAlignedArray(std::size_t size)
+            : mRaw(::operator new(size * sizeof(T) + CacheLineSize))
+            , mData(reinterpret_cast<T*>((reinterpret_cast<std::uintptr_t>(mRaw) + CacheLineSize - 1) &
+                                         ~std::uintptr_t(CacheLineSize - 1)))
+            , mSize(size) {
+            std::size_t constructed = 0;
+            try {
+                for (; constructed < size; ++constructed) {
+                    new (mData + constructed) T();
+                }
+            } catch (...) {
+                destroy(constructed);
+                throw;
+            }
+        }
+
+        CacheAlignedArray(const CacheAlignedArray&) = delete;
+        CacheAlignedArray& operator=(const CacheAlignedArray&) = delete;
+
+        ~CacheAlignedArray() noexcept { destroy(mSize); }
+
+        std::size_t size() const noexcept { return mSize; }
+
+        T& operator[](std::size_t index) noexcept { return mData[index]; }
+
+        const T& operator[](std::size_t index) const noexcept { return mData[index]; }
+
+    private:
+        void destroy(std::size_t count) noexcept {
+            for (std::size_t i = count; i > 0; --i) {
+                mData[i - 1].~T();
+            }
+            ::operator delete(mRaw);
+        }
+
+        void* mRaw;
+        T* mData;
+        std::size_t mSize;
+    };
+
+} // namespace detail
+
+} // namespace libOptional
+
+#endif // UTILS_CONCURRENCY_HPP_
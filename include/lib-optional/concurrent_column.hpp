@@ -0,0 +1,210 @@
+#ifndef UTILS_CONCURRENT_COLUMN_HPP_
+#define UTILS_CONCURRENT_COLUMN_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/concurrency.hpp"
+#include "lib-optional/optional.hpp"
+#include "lib-optional/optional_span.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace libOptional {
+
+/// Fixed-capacity nullable column that many producer threads can append to without a lock
+///
+/// A producer reserves a range of slots with a compare-and-swap, writes the values directly
+/// into its slots, publishes the validity bits with an atomic OR on the bitmap words and finally
+/// commits the range by setting its bits in a second "written" bitmap. Whoever commits then
+/// advances the committed size over the contiguous run of written rows, so readers always observe
+/// a consistent prefix of the column: every row below size() is completely written. No producer
+/// ever waits for another one.
+template <typename T>
+class ConcurrentColumn final {
+public:
+    static_assert(std::is_default_constructible<T>::value,
+                  "The underlying type of ConcurrentColumn must be default-constructible");
+    static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t),
+                  "Validity words must have the layout of plain 64-bit integers");
+
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    explicit ConcurrentColumn(std::size_t capacity)
+        : mValues(new T[capacity]())
+        , mValidity(new std::atomic<std::uint64_t>[detail::wordCount(capacity)])
+        , mWritten(new std::atomic<std::uint64_t>[detail::wordCount(capacity)])
+        , mCapacity(capacity) {
+        for (std::size_t i = 0; i < detail::wordCount(capacity); ++i) {
+            mValidity[i].store(0, std::memory_order_relaxed);
+            mWritten[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentColumn(const ConcurrentColumn&) = delete;
+    ConcurrentColumn& operator=(const ConcurrentColumn&) = delete;
+
+    std::size_t capacity() const noexcept { return mCapacity; }
+
+    /// Number of committed rows
+    std::size_t size() const noexcept { return mCommitted.load(std::memory_order_acquire); }
+
+    /// Reserves \p count consecutive slots for the calling producer
+    ///
+    /// \return Index of the first reserved slot or NullOptional if fewer than \p count slots are
+    ///         left, in which case the remaining slots stay available to smaller reservations
+    /// \note Every successful reservation must be committed, otherwise the committed prefix
+    ///       stops growing at the first uncommitted range
+    Optional<std::size_t> reserve(std::size_t count) noexcept {
+        std::size_t start = mReserved.load(std::memory_order_relaxed);
+        do {
+            if (mCapacity - start < count) {
+                return NullOptional;
+            }
+        } while (!mReserved.compare_exchange_weak(start, start + count, std::memory_order_relaxed));
+        return start;
+    }
+
+    /// Writes an engaged value into a reserved slot
+    void set(std::size_t index, const T& value) { setValue(index, value); }
+
+    void set(std::size_t index, T&& value) { setValue(index, std::move(value)); }
+
+    /// Writes \p value into a reserved slot, disengaged values leave the slot null
+    void set(std::size_t index, const Optional<T>& value) {
+        if (value) {
+            setValue(index, *value);
+        }
+    }
+
+    /// Marks the reserved range [start, start + count) as written
+    ///
+    /// The rows become visible to readers once all ranges reserved before this one are committed.
+    void commit(std::size_t start, std::size_t count) noexcept {
+        const std::size_t end = start + count;
+        for (std::size_t bit = start; bit < end;) {
+            const std::size_t offset = bit % detail::BitsPerWord;
+            const std::size_t bits = std::min(detail::BitsPerWord - offset, end - bit);
+            // Sequentially consistent, so that out of two producers committing concurrently at
+            // least one sees the other's bits when advancing the committed size
+            mWritten[detail::wordIndex(bit)].fetch_or(detail::lowMask(bits) << offset);
+            bit += bits;
+        }
+        advance();
+    }
+
+    /// Reserves, writes and commits the rows [first, last) of Optional<T>
+    ///
+    /// \return false if the column doesn't have enough space left
+    template <typename TIterator>
+    bool append(TIterator first, TIterator last) {
+        const std::size_t count = std::size_t(std::distance(first, last));
+        const Optional<std::size_t> start = reserve(count);
+        if (!start) {
+            return false;
+        }
+        std::size_t index = *start;
+        std::uint64_t word = 0;
+        for (; first != last; ++first, ++index) {
+            if (*first) {
+                mValues[index] = **first;
+                word |= detail::bitMask(index);
+            }
+            if ((index + 1) % detail::BitsPerWord == 0 && word != 0) {
+                mValidity[detail::wordIndex(index)].fetch_or(word, std::memory_order_relaxed);
+                word = 0;
+            }
+        }
+        if (word != 0) {
+            mValidity[detail::wordIndex(index - 1)].fetch_or(word, std::memory_order_relaxed);
+        }
+        commit(*start, count);
+        return true;
+    }
+
+    /// Appends a single row
+    ///
+    /// \return false if the column is full
+    bool append(const Optional<T>& value) {
+        const Optional<std::size_t> index = reserve(1);
+        if (!index) {
+            return false;
+        }
+        set(*index, value);
+        commit(*index, 1);
+        return true;
+    }
+
+    /// Committed row at \p index, which must be lower than a previously observed size()
+    Optional<const T&> operator[](std::size_t index) const noexcept {
+        assert(index < mCapacity);
+        if ((mValidity[detail::wordIndex(index)].load(std::memory_order_relaxed) &
+             detail::bitMask(index)) == 0) {
+            return NullOptional;
+        }
+        return mValues[index];
+    }
+
+    /// View of the committed prefix usable with the kernels
+    ///
+    /// \note The view reads the validity words without atomics, so it may only be used while no
+    ///       producer is running, e.g. after they were joined. Concurrent readers use operator[].
+    OptionalSpan<T> view() const noexcept {
+        const std::size_t size = this->size();
+        return OptionalSpan<T>(
+            mValues.get(), reinterpret_cast<const std::uint64_t*>(mValidity.get()), size);
+    }
+
+private:
+    /// Moves the committed size past the contiguous run of written rows following it
+    void advance() noexcept {
+        std::size_t committed = mCommitted.load(std::memory_order_acquire);
+        while (true) {
+            std::size_t end = committed;
+            while (end < mCapacity) {
+                const std::size_t base = end - end % detail::BitsPerWord;
+                const std::uint64_t pending =
+                    ~mWritten[detail::wordIndex(end)].load() & ~detail::lowMask(end % detail::BitsPerWord);
+                if (pending == 0) {
+                    end = base + detail::BitsPerWord;
+                } else {
+                    end = base + detail::countTrailingZeros(pending);
+                    break;
+                }
+            }
+            end = std::min(end, mCapacity);
+            if (end == committed) {
+                return;
+            }
+            if (mCommitted.compare_exchange_weak(committed, end, std::memory_order_acq_rel)) {
+                committed = end;
+            }
+        }
+    }
+
+    template <typename TValue>
+    void setValue(std::size_t index, TValue&& value) {
+        assert(index < mCapacity);
+        mValues[index] = std::forward<TValue>(value);
+        mValidity[detail::wordIndex(index)].fetch_or(detail::bitMask(index), std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<T[]> mValues;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> mValidity;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> mWritten;
+    const std::size_t mCapacity;
+
+    alignas(detail::CacheLineSize) std::atomic<std::size_t> mReserved{ 0 };
+    alignas(detail::CacheLineSize) std::atomic<std::size_t> mCommitted{ 0 };
+};
+
+} // namespace libOptional
+
+#endif // UTILS_CONCURRENT_COLUMN_HPP_
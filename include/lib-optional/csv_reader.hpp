@@ -0,0 +1,354 @@
+#ifndef UTILS_CSV_READER_HPP_
+#define UTILS_CSV_READER_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/chunked_column.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace libOptional {
+
+class CsvError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+namespace detail {
+
+    static constexpr std::size_t CsvBlockSize = 64;
+
+    /// Bit i is set if \p data[i] is \p delimiter or a newline, \p count must be at most 64
+    inline std::uint64_t csvSeparatorMaskScalar(const char* data,
+                                                std::size_t count,
+                                                char delimiter) noexcept {
+        std::uint64_t mask = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            mask |= std::uint64_t(data[i] == delimiter || data[i] == '\n') << i;
+        }
+        return mask;
+    }
+
+    /// Same as csvSeparatorMaskScalar() for a full block of 64 bytes, 16 bytes per SSE2 compare
+    inline std::uint64_t csvSeparatorMask(const char* data, char delimiter) noexcept {
+#if defined(__SSE2__)
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        const __m128i newlines = _mm_set1_epi8('\n');
+        std::uint64_t mask = 0;
+        for (std::size_t i = 0; i < CsvBlockSize; i += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i hits =
+                _mm_or_si128(_mm_cmpeq_epi8(bytes, delimiters), _mm_cmpeq_epi8(bytes, newlines));
+            mask |= std::uint64_t(std::uint32_t(_mm_movemask_epi8(hits))) << i;
+        }
+        return mask;
+#else
+        return csvSeparatorMaskScalar(data, CsvBlockSize, delimiter);
+#endif
+    }
+
+    inline bool isDigit(char c) noexcept {
+        return unsigned(c - '0') < 10;
+    }
+
+    /// Parses [begin, end) as an optionally signed decimal integer without allocating
+    inline bool parseInt64(const char* begin, const char* end, std::int64_t& out) noexcept {
+        const char* p = begin;
+        const bool negative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+')) {
+            ++p;
+        }
+        if (p == end || end - p > 19) {
+            return false;
+        }
+        std::uint64_t value = 0;
+        for (; p != end; ++p) {
+            if (!isDigit(*p)) {
+                return false;
+            }
+            value = value * 10 + std::uint64_t(*p - '0');
+        }
+        const std::uint64_t limit =
+            std::uint64_t(std::numeric_limits<std::int64_t>::max()) + (negative ? 1 : 0);
+        if (value > limit) {
+            return false;
+        }
+        out = negative ? std::int64_t(~value + 1) : std::int64_t(value);
+        return true;
+    }
+
+    /// Parses [begin, end) as a decimal floating point number without allocating
+    ///
+    /// Numbers with at most 19 significant digits whose mantissa is exactly representable and
+    /// whose decimal exponent is within [-22, 22] are computed with a single multiplication or
+    /// division, which is correctly rounded (Clinger's fast path). Anything else, including
+    /// inf and nan, goes through strtod() on a stack copy of the field.
+    inline bool parseDouble(const char* begin, const char* end, double& out) noexcept {
+        static const double powers[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                         1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                         1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        const char* p = begin;
+        const bool negative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+')) {
+            ++p;
+        }
+        std::uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool any = false;
+        for (; p != end && isDigit(*p); ++p) {
+            mantissa = mantissa * 10 + std::uint64_t(*p - '0');
+            digits += mantissa != 0 ? 1 : 0;
+            any = true;
+        }
+        if (p != end && *p == '.') {
+            for (++p; p != end && isDigit(*p); ++p) {
+                mantissa = mantissa * 10 + std::uint64_t(*p - '0');
+                digits += mantissa != 0 ? 1 : 0;
+                --exponent;
+                any = true;
+            }
+        }
+        if (any && p != end && (*p == 'e' || *p == 'E')) {
+            ++p;
+            const bool negativeExponent = p != end && *p == '-';
+            if (p != end && (*p == '-' || *p == '+')) {
+                ++p;
+            }
+            int value = 0;
+            const char* first = p;
+            for (; p != end && isDigit(*p) && value < 10000; ++p) {
+                value = value * 10 + (*p - '0');
+            }
+            any = p != first;
+            exponent += negativeExponent ? -value : value;
+        }
+        if (any && p == end && digits <= 19 && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 &&
+            exponent <= 22) {
+            double value = double(mantissa);
+            value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+            out = negative ? -value : value;
+            return true;
+        }
+
+        char buffer[128];
+        const std::size_t length = std::size_t(end - begin);
+        if (length == 0 || length >= sizeof(buffer) || std::isspace(static_cast<unsigned char>(*begin))) {
+            return false;
+        }
+        std::memcpy(buffer, begin, length);
+        buffer[length] = '\0';
+        char* parsedEnd = nullptr;
+        out = std::strtod(buffer, &parsedEnd);
+        return parsedEnd == buffer + length;
+    }
+
+} // namespace detail
+
+/// Binds one CSV field position to a nullable destination column
+///
+/// Empty fields are appended as disengaged elements, anything else must parse as the
+/// column's type.
+class CsvColumn final {
+public:
+    /// Fields parsed as Optional<int64_t>
+    static CsvColumn int64(ChunkedColumn<std::int64_t>& target) noexcept {
+        return CsvColumn(Type::Int64, &target);
+    }
+
+    /// Fields parsed as Optional<double>
+    static CsvColumn float64(ChunkedColumn<double>& target) noexcept {
+        return CsvColumn(Type::Double, &target);
+    }
+
+    /// Fields that are not loaded at all
+    static CsvColumn ignored() noexcept { return CsvColumn(Type::Ignored, nullptr); }
+
+    /// Appends the field [begin, end) to the target column
+    ///
+    /// \return false if the field is not a valid number, nothing is appended in that case
+    bool append(const char* begin, const char* end) {
+        switch (mType) {
+        case Type::Int64: {
+            ChunkedColumn<std::int64_t>& target = *static_cast<ChunkedColumn<std::int64_t>*>(mTarget);
+            std::int64_t value;
+            if (begin == end) {
+                target.appendNull();
+            } else if (detail::parseInt64(begin, end, value)) {
+                target.append(value);
+            } else {
+                return false;
+            }
+            return true;
+        }
+        case Type::Double: {
+            ChunkedColumn<double>& target = *static_cast<ChunkedColumn<double>*>(mTarget);
+            double value;
+            if (begin == end) {
+                target.appendNull();
+            } else if (detail::parseDouble(begin, end, value)) {
+                target.append(value);
+            } else {
+                return false;
+            }
+            return true;
+        }
+        case Type::Ignored:
+            break;
+        }
+        return true;
+    }
+
+    /// Removes the element the last successful append() added
+    void removeLast() {
+        switch (mType) {
+        case Type::Int64: {
+            ChunkedColumn<std::int64_t>& target = *static_cast<ChunkedColumn<std::int64_t>*>(mTarget);
+            target.truncate(target.size() - 1);
+            break;
+        }
+        case Type::Double: {
+            ChunkedColumn<double>& target = *static_cast<ChunkedColumn<double>*>(mTarget);
+            target.truncate(target.size() - 1);
+            break;
+        }
+        case Type::Ignored:
+            break;
+        }
+    }
+
+private:
+    enum class Type { Int64, Double, Ignored };
+
+    CsvColumn(Type type, void* target) noexcept
+        : mType(type)
+        , mTarget(target) {}
+
+    Type mType;
+    void* mTarget;
+};
+
+struct CsvOptions {
+    char delimiter = ',';
+
+    /// Skip the first line
+    bool header = true;
+};
+
+struct CsvStats {
+    std::size_t rows = 0;
+    std::size_t bytes = 0;
+    double seconds = 0.0;
+
+    /// Input throughput of the single thread that did the loading
+    double megabytesPerSecond() const noexcept { return seconds > 0.0 ? double(bytes) / seconds / 1e6 : 0.0; }
+};
+
+/// Loads numeric CSV data from [data, data + size) into \p columns, one per field
+///
+/// Delimiters and newlines are located 64 bytes at a time (with SSE2 where available) and the
+/// fields are parsed in place without allocating. Rows end with \\n or \\r\\n, a missing
+/// newline after the last row is accepted. Quoted fields are not supported.
+///
+/// \throw CsvError if a row has the wrong number of fields or a field does not parse,
+///                 the rows loaded before the failing one stay in the columns
+inline CsvStats loadCsv(const char* data,
+                        std::size_t size,
+                        std::vector<CsvColumn>& columns,
+                        const CsvOptions& options = CsvOptions()) {
+    const auto start = std::chrono::steady_clock::now();
+    CsvStats stats;
+    stats.bytes = size;
+    std::size_t line = 1;
+    std::size_t fieldStart = 0;
+    if (options.header) {
+        const void* newline = std::memchr(data, '\n', size);
+        fieldStart = newline ? std::size_t(static_cast<const char*>(newline) - data) + 1 : size;
+        ++line;
+    }
+    std::size_t field = 0;
+
+    auto fail = [&](const std::string& what) {
+        // Rolls back the fields of the failing row appended so far
+        for (std::size_t i = 0; i < std::min(field, columns.size()); ++i) {
+            columns[i].removeLast();
+        }
+        throw CsvError("CSV line " + std::to_string(line) + ": " + what);
+    };
+    auto consume = [&](std::size_t end, bool rowEnd) {
+        const char* fieldEnd = data + end;
+        if (rowEnd && end > fieldStart && fieldEnd[-1] == '\r') {
+            --fieldEnd;
+        }
+        if (field >= columns.size()) {
+            fail("expected " + std::to_string(columns.size()) + " fields");
+        }
+        if (!columns[field].append(data + fieldStart, fieldEnd)) {
+            fail("invalid value '" + std::string(data + fieldStart, fieldEnd) + "' in field " +
+                 std::to_string(field + 1));
+        }
+        fieldStart = end + 1;
+        ++field;
+        if (rowEnd) {
+            if (field != columns.size()) {
+                fail("expected " + std::to_string(columns.size()) + " fields, got " + std::to_string(field));
+            }
+            field = 0;
+            ++line;
+            ++stats.rows;
+        }
+    };
+
+    for (std::size_t base = fieldStart; base < size; base += detail::CsvBlockSize) {
+        const std::size_t count = size - base;
+        std::uint64_t mask = count >= detail::CsvBlockSize
+                                 ? detail::csvSeparatorMask(data + base, options.delimiter)
+                                 : detail::csvSeparatorMaskScalar(data + base, count, options.delimiter);
+        while (mask != 0) {
+            const std::size_t end = base + detail::countTrailingZeros(mask);
+            consume(end, data[end] == '\n');
+            mask &= mask - 1;
+        }
+    }
+    if (fieldStart < size || field != 0) {
+        consume(size, true);
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+/// Reads the whole file at \p path and loads it with loadCsv()
+///
+/// \throw CsvError if the file cannot be read or its contents are invalid
+inline CsvStats loadCsvFile(const std::string& path,
+                            std::vector<CsvColumn>& columns,
+                            const CsvOptions& options = CsvOptions()) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw CsvError("Failed to open " + path);
+    }
+    std::vector<char> contents(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(contents.data(), std::streamsize(contents.size()))) {
+        throw CsvError("Failed to read " + path);
+    }
+    return loadCsv(contents.data(), contents.size(), columns, options);
+}
+
+} // namespace libOptional
+
+#endif // UTILS_CSV_READER_HPP_
@@ -0,0 +1,243 @@
+#ifndef UTILS_DICTIONARY_COLUMN_HPP_
+#define UTILS_DICTIONARY_COLUMN_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional.hpp"
+#include "lib-optional/string_ref.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace libOptional {
+
+/// Dictionary-encoded column of Optional<std::string>
+///
+/// Every distinct string is stored once in a contiguous arena and rows only keep its 32-bit
+/// code, disengaged rows use the reserved NullCode. Filters and group-bys work on the codes,
+/// so a predicate is evaluated once per distinct string instead of once per row.
+class DictionaryColumn final {
+public:
+    using Code = std::uint32_t;
+
+    /// Code of disengaged rows
+    enum : Code { NullCode = 0xFFFFFFFF };
+
+    DictionaryColumn() = default;
+
+    template <typename TIterator>
+    DictionaryColumn(TIterator first, TIterator last) {
+        for (; first != last; ++first) {
+            append(*first);
+        }
+    }
+
+    /// Number of rows
+    std::size_t size() const noexcept { return mCodes.size(); }
+
+    bool empty() const noexcept { return mCodes.empty(); }
+
+    /// Number of distinct strings
+    std::size_t dictionarySize() const noexcept { return mHashes.size(); }
+
+    void append(StringRef value) { mCodes.push_back(encode(value)); }
+
+    void append(const char* value) { append(StringRef(value)); }
+
+    void append(const std::string& value) { append(StringRef(value)); }
+
+    void append(const Optional<std::string>& value) {
+        mCodes.push_back(value ? encode(*value) : NullCode);
+    }
+
+    void append(const Optional<StringRef>& value) { mCodes.push_back(value ? encode(*value) : NullCode); }
+
+    void appendNull() { mCodes.push_back(NullCode); }
+
+    /// Appends a row with a code obtained from encode() or findCode()
+    void appendCode(Code code) {
+        if (code != NullCode && code >= dictionarySize()) {
+            throw std::out_of_range("Invalid dictionary code");
+        }
+        mCodes.push_back(code);
+    }
+
+    /// Code of \p value, the value is added to the dictionary if it's not there yet
+    Code encode(StringRef value) {
+        const std::uint64_t hash = detail::hashBytes(value.data(), value.size());
+        std::size_t slot = find(value, hash);
+        if (!mSlots.empty() && mSlots[slot] != NullCode) {
+            return mSlots[slot];
+        }
+        if (dictionarySize() >= NullCode) {
+            throw std::length_error("Dictionary is full");
+        }
+        if ((dictionarySize() + 1) * 2 > mSlots.size()) {
+            rehash(mSlots.empty() ? 16 : mSlots.size() * 2);
+            slot = find(value, hash);
+        }
+        const Code code = Code(dictionarySize());
+        // value may come from decode() and point into mArena, which growing it would move, so it is
+        // located by its offset once the arena has room
+        const std::less<const char*> before;
+        const bool inArena = !before(value.data(), mArena.data()) &&
+                             before(value.data(), mArena.data() + mArena.size());
+        const std::size_t source = inArena ? std::size_t(value.data() - mArena.data()) : 0;
+        const std::size_t start = mArena.size();
+        mArena.resize(start + value.size());
+        if (!value.empty()) {
+            std::memcpy(&mArena[start], inArena ? &mArena[source] : value.data(), value.size());
+        }
+        mOffsets.push_back(mArena.size());
+        mHashes.push_back(hash);
+        mSlots[slot] = code;
+        return code;
+    }
+
+    /// Code of \p value or NullOptional if the value is not in the dictionary
+    Optional<Code> findCode(StringRef value) const noexcept {
+        if (mSlots.empty()) {
+            return NullOptional;
+        }
+        const Code code = mSlots[find(value, detail::hashBytes(value.data(), value.size()))];
+        return code == NullCode ? Optional<Code>() : Optional<Code>(code);
+    }
+
+    /// Dictionary string with the given \p code
+    ///
+    /// \note The reference is invalidated when a new distinct string is added
+    StringRef decode(Code code) const noexcept {
+        return StringRef(mArena.data() + mOffsets[code], mOffsets[code + 1] - mOffsets[code]);
+    }
+
+    Code code(std::size_t index) const noexcept { return mCodes[index]; }
+
+    const std::vector<Code>& codes() const noexcept { return mCodes; }
+
+    bool isValid(std::size_t index) const noexcept { return mCodes[index] != NullCode; }
+
+    /// Value of row \p index as a view into the dictionary
+    ///
+    /// \note The reference is invalidated when a new distinct string is added
+    Optional<StringRef> operator[](std::size_t index) const noexcept {
+        const Code code = mCodes[index];
+        return code == NullCode ? Optional<StringRef>() : Optional<StringRef>(decode(code));
+    }
+
+    /// Value of row \p index as an owning string
+    Optional<std::string> string(std::size_t index) const {
+        const Code code = mCodes[index];
+        return code == NullCode ? Optional<std::string>() : Optional<std::string>(decode(code).str());
+    }
+
+    std::vector<Optional<std::string>> toOptionals() const {
+        std::vector<Optional<std::string>> result;
+        result.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i) {
+            result.push_back(string(i));
+        }
+        return result;
+    }
+
+    /// Selects the rows equal to \p value in the selection bitmap \p selection, which must hold
+    /// wordCount(size()) words
+    ///
+    /// \return The number of selected rows
+    std::size_t filterEqual(StringRef value, std::uint64_t* selection) const noexcept {
+        const Optional<Code> wanted = findCode(value);
+        return selectCodes(selection, [&](Code code) { return wanted && code == *wanted; });
+    }
+
+    /// Selects the engaged rows for which \p predicate(StringRef) holds, the predicate is
+    /// evaluated once per distinct string
+    ///
+    /// \return The number of selected rows
+    template <typename TPredicate>
+    std::size_t filter(TPredicate&& predicate, std::uint64_t* selection) const {
+        std::vector<std::uint64_t> matching(detail::wordCount(dictionarySize()));
+        for (Code code = 0; code < dictionarySize(); ++code) {
+            if (predicate(decode(code))) {
+                detail::setBit(matching.data(), code);
+            }
+        }
+        return selectCodes(selection, [&](Code code) {
+            return code != NullCode && detail::testBit(matching.data(), code);
+        });
+    }
+
+    /// Number of rows for every code, indexed by code
+    std::vector<std::size_t> countByCode() const {
+        std::vector<std::size_t> counts(dictionarySize());
+        for (Code code : mCodes) {
+            if (code != NullCode) {
+                ++counts[code];
+            }
+        }
+        return counts;
+    }
+
+    /// Number of disengaged rows
+    std::size_t nullCount() const noexcept {
+        std::size_t count = 0;
+        for (Code code : mCodes) {
+            count += code == NullCode ? 1 : 0;
+        }
+        return count;
+    }
+
+private:
+    /// Slot holding \p value or the empty slot where it would be inserted
+    std::size_t find(StringRef value, std::uint64_t hash) const noexcept {
+        if (mSlots.empty()) {
+            return 0;
+        }
+        const std::size_t mask = mSlots.size() - 1;
+        for (std::size_t slot = std::size_t(hash) & mask;; slot = (slot + 1) & mask) {
+            const Code code = mSlots[slot];
+            if (code == NullCode || (mHashes[code] == hash && decode(code) == value)) {
+                return slot;
+            }
+        }
+    }
+
+    void rehash(std::size_t slots) {
+        mSlots.assign(slots, NullCode);
+        for (Code code = 0; code < dictionarySize(); ++code) {
+            std::size_t slot = std::size_t(mHashes[code]) & (slots - 1);
+            while (mSlots[slot] != NullCode) {
+                slot = (slot + 1) & (slots - 1);
+            }
+            mSlots[slot] = code;
+        }
+    }
+
+    template <typename TMatch>
+    std::size_t selectCodes(std::uint64_t* selection, TMatch&& match) const {
+        std::size_t selected = 0;
+        for (std::size_t base = 0; base < size(); base += detail::BitsPerWord) {
+            const std::size_t count = std::min(detail::BitsPerWord, size() - base);
+            std::uint64_t word = 0;
+            for (std::size_t j = 0; j < count; ++j) {
+                word |= std::uint64_t(match(mCodes[base + j]) ? 1 : 0) << j;
+            }
+            selection[detail::wordIndex(base)] = word;
+            selected += detail::popcount(word);
+        }
+        return selected;
+    }
+
+    std::vector<Code> mCodes;
+    std::vector<char> mArena;
+    std::vector<std::size_t> mOffsets = std::vector<std::size_t>(1, 0);
+    std::vector<std::uint64_t> mHashes;
+    std::vector<Code> mSlots;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_DICTIONARY_COLUMN_HPP_
@@ -0,0 +1,403 @@
+#ifndef UTILS_FLAT_HASH_MAP_HPP_
+#define UTILS_FLAT_HASH_MAP_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/hashing.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace libOptional {
+
+namespace detail {
+
+    template <typename T>
+    struct VoidType {
+        using Type = void;
+    };
+
+    /// Whether \p T declares is_transparent, as the std heterogeneous lookup functors do
+    template <typename T, typename = void>
+    struct IsTransparent : std::false_type {};
+
+    template <typename T>
+    struct IsTransparent<T, typename VoidType<typename T::is_transparent>::Type> : std::true_type {};
+
+} // namespace detail
+
+/// Open-addressing hash map storing its entries in one flat array, in the style of SwissTable
+///
+/// Every slot has a control byte next to it: zero for an empty slot, one for an erased one and
+/// the hashTag() of the key for an occupied one. Slots are probed in groups of 16 whose control
+/// bytes are compared with the tag in one SSE2 instruction, so a lookup touches the entries only
+/// for tag hits, which are almost always the key itself. Groups are visited in triangular order,
+/// which reaches all of them for a power-of-two group count, and a lookup stops at the first
+/// group with an empty slot. The table grows at 7/8 load, counting erased slots, and an erased
+/// slot goes back to empty whenever its group still has an empty slot, because then no probe can
+/// have passed through it.
+///
+/// When both THash and TEqual declare is_transparent, find(), contains(), erase(), extract() and
+/// tryEmplace() accept any key type they accept, and tryEmplace() only converts it to TKey when
+/// it inserts.
+///
+/// \note References returned by find() and tryEmplace() are invalidated by the next insertion,
+///       which may rehash, and by erasing their entry.
+template <typename TKey,
+          typename TValue,
+          typename THash = std::hash<TKey>,
+          typename TEqual = std::equal_to<TKey>>
+class FlatHashMap final {
+public:
+    using KeyType = TKey;
+    using ValueType = TValue;
+    using key_type = KeyType;      // std traits
+    using mapped_type = ValueType; // std traits
+
+    /// Whether the transparent overloads taking any key type are available
+    static constexpr bool Transparent =
+        detail::IsTransparent<THash>::value && detail::IsTransparent<TEqual>::value;
+
+    enum : std::size_t { GroupSize = 16 };
+
+    /// \param capacity Number of entries to make room for up front
+    explicit FlatHashMap(std::size_t capacity = 0,
+                         const THash& hash = THash(),
+                         const TEqual& equal = TEqual())
+        : mHash(hash)
+        , mEqual(equal) {
+        reserve(capacity);
+    }
+
+    FlatHashMap(const FlatHashMap&) = delete;
+    FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+    FlatHashMap(FlatHashMap&& other) noexcept
+        : mControl(std::move(other.mControl))
+        , mSlots(std::move(other.mSlots))
+        , mGroupMask(other.mGroupMask)
+        , mSize(other.mSize)
+        , mGrowthLeft(other.mGrowthLeft)
+        , mHash(std::move(other.mHash))
+        , mEqual(std::move(other.mEqual)) {
+        other.forget();
+    }
+
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+        if (this != &other) {
+            mControl = std::move(other.mControl);
+            mSlots = std::move(other.mSlots);
+            mGroupMask = other.mGroupMask;
+            mSize = other.mSize;
+            mGrowthLeft = other.mGrowthLeft;
+            mHash = std::move(other.mHash);
+            mEqual = std::move(other.mEqual);
+            other.forget();
+        }
+        return *this;
+    }
+
+    /// The value of \p key, empty if the key is not present
+    Optional<TValue&> find(const TKey& key) { return valueAt(findSlot(key)); }
+
+    Optional<const TValue&> find(const TKey& key) const { return valueAt(findSlot(key)); }
+
+    template <typename TLookup>
+    detail::EnableIf<Transparent && !std::is_same<TLookup, TKey>::value, Optional<TValue&>>
+    find(const TLookup& key) {
+        return valueAt(findSlot(key));
+    }
+
+    template <typename TLookup>
+    detail::EnableIf<Transparent && !std::is_same<TLookup, TKey>::value, Optional<const TValue&>>
+    find(const TLookup& key) const {
+        return valueAt(findSlot(key));
+    }
+
+    bool contains(const TKey& key) const { return findSlot(key) != NotFound; }
+
+    template <typename TLookup>
+    detail::EnableIf<Transparent && !std::is_same<TLookup, TKey>::value, bool> contains(
+        const TLookup& key) const {
+        return findSlot(key) != NotFound;
+    }
+
+    /// Constructs the value of \p key from \p args unless the key is already present
+    ///
+    /// \return The value of \p key and whether it was inserted; \p args are left untouched when
+    ///         it was not
+    template <typename... TArgs>
+    std::pair<TValue&, bool> tryEmplace(const TKey& key, TArgs&&... args) {
+        return emplaceKey(key, std::forward<TArgs>(args)...);
+    }
+
+    template <typename... TArgs>
+    std::pair<TValue&, bool> tryEmplace(TKey&& key, TArgs&&... args) {
+        return emplaceKey(std::move(key), std::forward<TArgs>(args)...);
+    }
+
+    template <typename TLookup, typename... TArgs>
+    detail::EnableIf<Transparent && !std::is_same<typename std::decay<TLookup>::type, TKey>::value &&
+                         std::is_constructible<TKey, TLookup&&>::value,
+                     std::pair<TValue&, bool>>
+    tryEmplace(TLookup&& key, TArgs&&... args) {
+        return emplaceKey(std::forward<TLookup>(key), std::forward<TArgs>(args)...);
+    }
+
+    /// Removes \p key, returns false if it was not present
+    bool erase(const TKey& key) { return eraseSlot(findSlot(key)); }
+
+    template <typename TLookup>
+    detail::EnableIf<Transparent && !std::is_same<TLookup, TKey>::value, bool> erase(const TLookup& key) {
+        return eraseSlot(findSlot(key));
+    }
+
+    /// Removes \p key and moves its value out, empty if the key was not present
+    Optional<TValue> extract(const TKey& key) { return extractSlot(findSlot(key)); }
+
+    template <typename TLookup>
+    detail::EnableIf<Transparent && !std::is_same<TLookup, TKey>::value, Optional<TValue>> extract(
+        const TLookup& key) {
+        return extractSlot(findSlot(key));
+    }
+
+    /// Calls \p function with the key and the value of every entry, in no particular order
+    template <typename TFunction>
+    void forEach(TFunction&& function) {
+        for (std::size_t i = 0; i < capacity(); ++i) {
+            if (mControl[i] & 0x80) {
+                function(static_cast<const TKey&>(mSlots[i]->key), mSlots[i]->value);
+            }
+        }
+    }
+
+    template <typename TFunction>
+    void forEach(TFunction&& function) const {
+        for (std::size_t i = 0; i < capacity(); ++i) {
+            if (mControl[i] & 0x80) {
+                const Entry& entry = *mSlots[i];
+                function(entry.key, entry.value);
+            }
+        }
+    }
+
+    /// Makes room for \p count entries, so inserting up to that many never rehashes
+    ///
+    /// \throw std::length_error if the table for \p count entries would not be addressable
+    void reserve(std::size_t count) {
+        std::size_t slots = GroupSize;
+        while (slots / 8 * 7 < count) {
+            if (slots > std::size_t(-1) / 4) {
+                throw std::length_error("FlatHashMap capacity overflow");
+            }
+            slots *= 2;
+        }
+        if (slots > capacity() && count > 0) {
+            rehash(slots);
+        }
+    }
+
+    /// Removes all entries, the table keeps its capacity
+    void clear() noexcept {
+        for (std::size_t i = 0; i < capacity(); ++i) {
+            mSlots[i].reset();
+        }
+        std::fill(mControl.get(), mControl.get() + capacity(), std::uint8_t(Empty));
+        mSize = 0;
+        mGrowthLeft = capacity() / 8 * 7;
+    }
+
+    std::size_t size() const noexcept { return mSize; }
+
+    bool empty() const noexcept { return mSize == 0; }
+
+    /// Number of slots of the table, entries are added without rehashing up to 7/8 of it
+    std::size_t capacity() const noexcept { return mControl ? (mGroupMask + 1) * GroupSize : 0; }
+
+private:
+    enum : std::uint8_t {
+        Empty = 0,  ///< Control byte of a slot never used since the last rehash
+        Deleted = 1 ///< Control byte of an erased slot that probes have to walk past
+    };
+
+    enum : std::size_t { NotFound = std::size_t(-1) };
+
+    struct Entry {
+        template <typename TKeyArg, typename... TArgs>
+        Entry(TKeyArg&& entryKey, TArgs&&... args)
+            : key(std::forward<TKeyArg>(entryKey))
+            , value(std::forward<TArgs>(args)...) {}
+
+        TKey key;
+        TValue value;
+    };
+
+    const std::uint8_t* group(std::size_t index) const noexcept { return &mControl[index * GroupSize]; }
+
+    template <typename TLookup>
+    std::size_t findSlot(const TLookup& key) const {
+        if (mSize == 0) {
+            return NotFound;
+        }
+        return findSlot(key, detail::mixHash(mHash(key)));
+    }
+
+    template <typename TLookup>
+    std::size_t findSlot(const TLookup& key, std::uint64_t hash) const {
+        const std::uint8_t tag = detail::hashTag(hash);
+        std::size_t index = std::size_t(hash) & mGroupMask;
+        for (std::size_t step = 1;; ++step) {
+            const std::uint8_t* control = group(index);
+            for (std::uint32_t hits = detail::matchTags16(control, tag); hits != 0; hits &= hits - 1) {
+                const std::size_t slot = index * GroupSize + detail::countTrailingZeros(hits);
+                if (mEqual(mSlots[slot]->key, key)) {
+                    return slot;
+                }
+            }
+            if (detail::matchTags16(control, Empty) != 0) {
+                return NotFound;
+            }
+            index = (index + step) & mGroupMask;
+        }
+    }
+
+    /// First empty or erased slot of the probe sequence of \p hash
+    std::size_t freeSlot(std::uint64_t hash) const noexcept {
+        return freeSlot(mControl.get(), mGroupMask, hash);
+    }
+
+    static std::size_t freeSlot(const std::uint8_t* control,
+                                std::size_t groupMask,
+                                std::uint64_t hash) noexcept {
+        std::size_t index = std::size_t(hash) & groupMask;
+        for (std::size_t step = 1;; ++step) {
+            const std::uint32_t free = detail::matchFree16(&control[index * GroupSize]);
+            if (free != 0) {
+                return index * GroupSize + detail::countTrailingZeros(free);
+            }
+            index = (index + step) & groupMask;
+        }
+    }
+
+    template <typename TKeyArg, typename... TArgs>
+    std::pair<TValue&, bool> emplaceKey(TKeyArg&& key, TArgs&&... args) {
+        const std::uint64_t hash = detail::mixHash(mHash(key));
+        if (mSize != 0) {
+            const std::size_t found = findSlot(key, hash);
+            if (found != NotFound) {
+                return std::pair<TValue&, bool>(mSlots[found]->value, false);
+            }
+        }
+        std::size_t slot = mControl ? freeSlot(hash) : NotFound;
+        if (slot == NotFound || (mGrowthLeft == 0 && mControl[slot] == Empty)) {
+            grow();
+            slot = freeSlot(hash);
+        }
+        mSlots[slot].emplace(std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
+        if (mControl[slot] == Empty) {
+            --mGrowthLeft;
+        }
+        mControl[slot] = detail::hashTag(hash);
+        ++mSize;
+        return std::pair<TValue&, bool>(mSlots[slot]->value, true);
+    }
+
+    Optional<TValue&> valueAt(std::size_t slot) noexcept {
+        if (slot == NotFound) {
+            return NullOptional;
+        }
+        return mSlots[slot]->value;
+    }
+
+    Optional<const TValue&> valueAt(std::size_t slot) const noexcept {
+        if (slot == NotFound) {
+            return NullOptional;
+        }
+        return mSlots[slot]->value;
+    }
+
+    bool eraseSlot(std::size_t slot) noexcept {
+        if (slot == NotFound) {
+            return false;
+        }
+        mSlots[slot].reset();
+        if (detail::matchTags16(group(slot / GroupSize), Empty) != 0) {
+            mControl[slot] = Empty;
+            ++mGrowthLeft;
+        } else {
+            mControl[slot] = Deleted;
+        }
+        --mSize;
+        return true;
+    }
+
+    Optional<TValue> extractSlot(std::size_t slot) {
+        if (slot == NotFound) {
+            return NullOptional;
+        }
+        Optional<TValue> value(std::move(mSlots[slot]->value));
+        eraseSlot(slot);
+        return value;
+    }
+
+    /// Makes room for one more entry, reclaiming erased slots in place when they rather than the
+    /// entries filled the table
+    void grow() {
+        const std::size_t slots = capacity();
+        if (slots == 0) {
+            rehash(GroupSize);
+        } else {
+            rehash(mSize <= slots / 32 * 25 ? slots : 2 * slots);
+        }
+    }
+
+    /// Moves all entries into a new table of \p slots slots
+    ///
+    /// The new table only replaces the old one once every entry is in it, and entries whose move
+    /// may throw are copied, so an exception leaves the map as it was.
+    void rehash(std::size_t slots) {
+        std::unique_ptr<std::uint8_t[]> control(new std::uint8_t[slots]());
+        std::unique_ptr<Optional<Entry>[]> entries(new Optional<Entry>[slots]);
+        const std::size_t groupMask = slots / GroupSize - 1;
+        for (std::size_t i = 0; i < capacity(); ++i) {
+            if (mControl[i] & 0x80) {
+                const std::uint64_t hash = detail::mixHash(mHash(mSlots[i]->key));
+                const std::size_t slot = freeSlot(control.get(), groupMask, hash);
+                entries[slot].emplace(std::move_if_noexcept(mSlots[i]->key),
+                                      std::move_if_noexcept(mSlots[i]->value));
+                control[slot] = detail::hashTag(hash);
+            }
+        }
+        mControl = std::move(control);
+        mSlots = std::move(entries);
+        mGroupMask = groupMask;
+        mGrowthLeft = slots / 8 * 7 - mSize;
+    }
+
+    void forget() noexcept {
+        mGroupMask = 0;
+        mSize = 0;
+        mGrowthLeft = 0;
+    }
+
+    std::unique_ptr<std::uint8_t[]> mControl;
+    std::unique_ptr<Optional<Entry>[]> mSlots;
+    std::size_t mGroupMask = 0;  ///< Number of groups minus one
+    std::size_t mSize = 0;
+    std::size_t mGrowthLeft = 0; ///< Empty slots that may still be filled before the table grows
+    THash mHash;
+    TEqual mEqual;
+};
+
+template <typename TKey, typename TValue, typename THash, typename TEqual>
+constexpr bool FlatHashMap<TKey, TValue, THash, TEqual>::Transparent;
+
+} // namespace libOptional
+
+#endif // UTILS_FLAT_HASH_MAP_HPP_
@@ -0,0 +1,264 @@
+#ifndef UTILS_FUTURE_HPP_
+#define UTILS_FUTURE_HPP_
+
+#include "lib-optional/optional.hpp"
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace libOptional {
+
+class FutureError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+template <typename T>
+class Future;
+
+namespace detail {
+
+    /// Space reserved for a continuation inside a promise
+    static constexpr std::size_t InlineContinuationSize = 4 * sizeof(void*);
+
+    /// Type-erased callable taking a TArg&, stored in place and never on the heap
+    template <typename TArg>
+    class InlineContinuation final {
+    public:
+        InlineContinuation() = default;
+        InlineContinuation(const InlineContinuation&) = delete;
+        InlineContinuation& operator=(const InlineContinuation&) = delete;
+
+        ~InlineContinuation() noexcept { reset(); }
+
+        explicit operator bool() const noexcept { return mManage != nullptr; }
+
+        template <typename TFunction>
+        void assign(TFunction&& function) {
+            using Stored = typename std::decay<TFunction>::type;
+            static_assert(sizeof(Stored) <= InlineContinuationSize,
+                          "The continuation does not fit into the promise, capture less or by reference");
+            static_assert(alignof(Stored) <= alignof(Storage), "The continuation is over-aligned");
+            reset();
+            new (&mStorage) Stored(std::forward<TFunction>(function));
+            mManage = &manage<Stored>;
+        }
+
+        /// Calls the continuation once and destroys it
+        void invoke(TArg& argument) {
+            void (*manage)(Operation, void*, TArg*) = mManage;
+            mManage = nullptr;
+            // The callable is destroyed even if it throws
+            struct Destroy {
+                ~Destroy() { manage(Operation::Destroy, storage, nullptr); }
+                void (*manage)(Operation, void*, TArg*);
+                void* storage;
+            } destroy{ manage, &mStorage };
+            manage(Operation::Invoke, &mStorage, &argument);
+        }
+
+        void reset() noexcept {
+            if (mManage != nullptr) {
+                mManage(Operation::Destroy, &mStorage, nullptr);
+                mManage = nullptr;
+            }
+        }
+
+    private:
+        enum class Operation { Invoke, Destroy };
+
+        using Storage = typename std::aligned_storage<InlineContinuationSize, alignof(void*)>::type;
+
+        template <typename TStored>
+        static void manage(Operation operation, void* storage, TArg* argument) {
+            TStored& function = *static_cast<TStored*>(storage);
+            if (operation == Operation::Invoke) {
+                function(*argument);
+            } else {
+                function.~TStored();
+            }
+        }
+
+        Storage mStorage;
+        void (*mManage)(Operation, void*, TArg*) = nullptr;
+    };
+
+} // namespace detail
+
+/// Single-threaded promise whose result is an Optional<T> embedded in the promise itself
+///
+/// Unlike std::promise nothing is allocated and nothing is synchronized: the future only points
+/// at the promise, and the one continuation a future may register is stored in a fixed buffer of
+/// detail::InlineContinuationSize bytes inside the promise. A continuation that does not fit is
+/// rejected at compile time.
+///
+/// \note The promise can neither be copied nor moved, which is what lets futures and chained
+///       continuations refer to it. It must outlive the uses of the result; destroying it leaves
+///       its future invalid. Everything must happen on one thread.
+template <typename T>
+class Promise final {
+public:
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    Promise() = default;
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    ~Promise() noexcept;
+
+    /// \throw FutureError if the future has already been retrieved
+    Future<T> getFuture();
+
+    /// Constructs the result from \p args and runs the continuation, if any
+    ///
+    /// \throw FutureError if the promise is already satisfied
+    template <typename... TArgs>
+    void setValue(TArgs&&... args) {
+        if (mResult) {
+            throw FutureError("The promise is already satisfied");
+        }
+        mResult.emplace(std::forward<TArgs>(args)...);
+        if (mContinuation) {
+            mContinuation.invoke(*mResult);
+        }
+    }
+
+    bool satisfied() const noexcept { return mResult.hasValue(); }
+
+private:
+    friend class Future<T>;
+
+    Optional<T> mResult;
+    detail::InlineContinuation<T> mContinuation;
+    Future<T>* mFuture = nullptr;
+    bool mRetrieved = false;
+};
+
+/// Receiving end of a Promise, see there for the lifetime rules
+template <typename T>
+class Future final {
+public:
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    /// Constructs an invalid future
+    Future() noexcept = default;
+
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+
+    Future(Future&& other) noexcept
+        : mPromise(other.mPromise) {
+        attach();
+        other.mPromise = nullptr;
+    }
+
+    Future& operator=(Future&& other) noexcept {
+        if (this != &other) {
+            detach();
+            mPromise = other.mPromise;
+            attach();
+            other.mPromise = nullptr;
+        }
+        return *this;
+    }
+
+    ~Future() noexcept { detach(); }
+
+    /// Whether the future is connected to a promise
+    bool valid() const noexcept { return mPromise != nullptr; }
+
+    bool ready() const noexcept { return mPromise != nullptr && mPromise->satisfied(); }
+
+    /// The result if the promise has been satisfied, the value stays in the promise
+    Optional<T&> tryGet() const noexcept {
+        if (!ready()) {
+            return NullOptional;
+        }
+        return *mPromise->mResult;
+    }
+
+    /// Calls \p function with a T& once the result is set, right away if it is set already
+    ///
+    /// \throw FutureError if the future is invalid or a continuation is already registered
+    template <typename TFunction>
+    void then(TFunction&& function) {
+        if (!mPromise) {
+            throw FutureError("The future has no promise");
+        }
+        if (mPromise->mContinuation) {
+            throw FutureError("The future already has a continuation");
+        }
+        if (mPromise->mResult) {
+            function(*mPromise->mResult);
+        } else {
+            mPromise->mContinuation.assign(std::forward<TFunction>(function));
+        }
+    }
+
+    /// Chains \p next: once this result is set, \p next is satisfied with \p function applied to it
+    ///
+    /// \return The future of \p next
+    template <typename TResult, typename TFunction>
+    Future<TResult> then(Promise<TResult>& next, TFunction&& function) {
+        Future<TResult> result = next.getFuture();
+        then(Chain<TResult, typename std::decay<TFunction>::type>{ &next,
+                                                                   std::forward<TFunction>(function) });
+        return result;
+    }
+
+private:
+    friend class Promise<T>;
+
+    template <typename TResult, typename TFunction>
+    struct Chain {
+        void operator()(T& value) { next->setValue(function(value)); }
+
+        Promise<TResult>* next;
+        TFunction function;
+    };
+
+    explicit Future(Promise<T>* promise) noexcept
+        : mPromise(promise) {
+        attach();
+    }
+
+    void attach() noexcept {
+        if (mPromise) {
+            mPromise->mFuture = this;
+        }
+    }
+
+    void detach() noexcept {
+        if (mPromise) {
+            mPromise->mFuture = nullptr;
+            mPromise = nullptr;
+        }
+    }
+
+    Promise<T>* mPromise = nullptr;
+};
+
+template <typename T>
+Promise<T>::~Promise() noexcept {
+    if (mFuture) {
+        mFuture->mPromise = nullptr;
+    }
+}
+
+template <typename T>
+Future<T> Promise<T>::getFuture() {
+    if (mRetrieved) {
+        throw FutureError("The future has already been retrieved");
+    }
+    mRetrieved = true;
+    return Future<T>(this);
+}
+
+} // namespace libOptional
+
+#endif // UTILS_FUTURE_HPP_
@@ -0,0 +1,180 @@
+#ifndef UTILS_HASHING_HPP_
+#define UTILS_HASHING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace libOptional {
+
+namespace detail {
+
+    /// Spreads the bits of a hash that may be weak (std::hash of integers is the identity), the
+    /// finalizer of MurmurHash3
+    inline std::uint64_t mixHash(std::uint64_t hash) noexcept {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    /// One-byte fingerprint of a mixed hash stored next to occupied slots, the high bit is always
+    /// set so a zero byte can mark an empty slot
+    inline std::uint8_t hashTag(std::uint64_t mixedHash) noexcept {
+        return std::uint8_t(0x80 | (mixedHash >> 57));
+    }
+
+    /// Bit i is set if \p tags[i] equals \p tag, \p count must be at most 32
+    inline std::uint32_t matchTagsScalar(const std::uint8_t* tags,
+                                         std::size_t count,
+                                         std::uint8_t tag) noexcept {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            mask |= std::uint32_t(tags[i] == tag) << i;
+        }
+        return mask;
+    }
+
+    /// Same as matchTagsScalar() for 8 tags, one SSE2 compare
+    inline std::uint32_t matchTags8(const std::uint8_t* tags, std::uint8_t tag) noexcept {
+#if defined(__SSE2__)
+        const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tags));
+        const __m128i hits = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(char(tag)));
+        return std::uint32_t(_mm_movemask_epi8(hits)) & 0xff;
+#else
+        return matchTagsScalar(tags, 8, tag);
+#endif
+    }
+
+    /// Same as matchTagsScalar() for 16 tags, one SSE2 compare
+    inline std::uint32_t matchTags16(const std::uint8_t* tags, std::uint8_t tag) noexcept {
+#if defined(__SSE2__)
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags));
+        const __m128i hits = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(char(tag)));
+        return std::uint32_t(_mm_movemask_epi8(hits));
+#else
+        return matchTagsScalar(tags, 16, tag);
+#endif
+    }
+
+    /// Matches a group of TCount tags, using SSE2 for the group sizes it covers in one compare
+    template <std::size_t TCount>
+    inline std::uint32_t matchTags(const std::uint8_t* tags, std::uint8_t tag) noexcept {
+        return TCount == 16  ? matchTags16(tags, tag)
+               : TCount == 8 ? matchTags8(tags, tag)
+                             : matchTagsScalar(tags, TCount, tag);
+    }
+
+    /// Bit i is set if \p tags[i] does not hold a hashTag(), i.e. its high bit is clear
+    inline std::uint32_t matchFree16(const std::uint8_t* tags) noexcept {
+#if defined(__SSE2__)
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags));
+        return ~std::uint32_t(_mm_movemask_epi8(bytes)) & 0xffff;
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < 16; ++i) {
+            mask |= std::uint32_t(tags[i] < 0x80) << i;
+        }
+        return mask;
+#endif
+    }
+
+    /// Open-addressing hash index from keys to the positions of nodes stored elsewhere
+    ///
+    /// The owner keeps the keys and passes the mixed hash of a key along with a predicate telling
+    /// whether the node at a position holds that key. Linear probing with backward-shift
+    /// deletion keeps the table free of tombstones, so a workload that keeps inserting and
+    /// erasing never degrades and never allocates after construction.
+    class NodeIndex final {
+    public:
+        enum : std::uint32_t { NotFound = 0xffffffffu };
+
+        /// \param nodes Maximum number of nodes indexed at the same time, the table is sized so
+        ///              it stays at most half full
+        explicit NodeIndex(std::size_t nodes)
+            : mMask(tableSize(nodes) - 1)
+            , mSlots(new Slot[mMask + 1]) {
+            if (nodes >= NotFound) {
+                throw std::length_error("NodeIndex supports at most 2^32 - 1 nodes");
+            }
+            clear();
+        }
+
+        /// Position of the node \p matches accepts among those indexed under \p hash
+        template <typename TMatch>
+        std::uint32_t find(std::uint64_t hash, TMatch&& matches) const {
+            const std::uint32_t shortHash = std::uint32_t(hash);
+            for (std::size_t i = shortHash & mMask;; i = (i + 1) & mMask) {
+                const Slot& slot = mSlots[i];
+                if (slot.node == NotFound) {
+                    return NotFound;
+                }
+                if (slot.hash == shortHash && matches(slot.node)) {
+                    return slot.node;
+                }
+            }
+        }
+
+        /// Adds \p node under \p hash, the key must not be indexed yet
+        void insert(std::uint64_t hash, std::uint32_t node) noexcept {
+            std::size_t i = std::uint32_t(hash) & mMask;
+            while (mSlots[i].node != NotFound) {
+                i = (i + 1) & mMask;
+            }
+            mSlots[i].hash = std::uint32_t(hash);
+            mSlots[i].node = node;
+        }
+
+        /// Removes \p node, which must be indexed under \p hash
+        void erase(std::uint64_t hash, std::uint32_t node) noexcept {
+            std::size_t hole = std::uint32_t(hash) & mMask;
+            while (mSlots[hole].node != node) {
+                hole = (hole + 1) & mMask;
+            }
+            // Moves back every following entry of the cluster that may live in the hole
+            for (std::size_t i = (hole + 1) & mMask; mSlots[i].node != NotFound; i = (i + 1) & mMask) {
+                const std::size_t home = mSlots[i].hash & mMask;
+                if (((i - home) & mMask) >= ((i - hole) & mMask)) {
+                    mSlots[hole] = mSlots[i];
+                    hole = i;
+                }
+            }
+            mSlots[hole].node = NotFound;
+        }
+
+        void clear() noexcept {
+            for (std::size_t i = 0; i <= mMask; ++i) {
+                mSlots[i].node = NotFound;
+            }
+        }
+
+    private:
+        struct Slot {
+            std::uint32_t hash;
+            std::uint32_t node;
+        };
+
+        static std::size_t tableSize(std::size_t nodes) noexcept {
+            std::size_t size = 2;
+            while (size < 2 * nodes) {
+                size *= 2;
+            }
+            return size;
+        }
+
+        std::size_t mMask;
+        std::unique_ptr<Slot[]> mSlots;
+    };
+
+} // namespace detail
+
+} // namespace libOptional
+
+#endif // UTILS_HASHING_HPP_
@@ -0,0 +1,241 @@
+#ifndef UTILS_KERNELS_HPP_
+#define UTILS_KERNELS_HPP_
+
+#include "lib-optional/adaptive_validity.hpp"
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional.hpp"
+#include "lib-optional/optional_span.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace libOptional {
+
+/// Number of engaged elements in \p span
+template <typename T>
+std::size_t countValid(const OptionalSpan<T>& span) noexcept {
+    if (span.allValid()) {
+        return span.size();
+    }
+    return detail::countSetBits(span.validity(), span.size());
+}
+
+/// Number of disengaged elements in \p span
+template <typename T>
+std::size_t countNull(const OptionalSpan<T>& span) noexcept {
+    return span.size() - countValid(span);
+}
+
+/// Calls \p func(index, value) for every engaged element of \p span
+template <typename T, typename TFunc>
+void forEachValid(const OptionalSpan<T>& span, TFunc&& func) {
+    const T* values = span.values();
+    if (span.allValid()) {
+        for (std::size_t i = 0; i < span.size(); ++i) {
+            func(i, values[i]);
+        }
+        return;
+    }
+    detail::forEachSetBit(span.validity(), span.size(), [&](std::size_t i) { func(i, values[i]); });
+}
+
+/// Sum of all engaged elements of \p span added to \p init, disengaged elements are skipped
+///
+/// The loop works on a whole validity word at a time and selects instead of branching,
+/// so it vectorizes for arithmetic types.
+template <typename T, typename TAccumulate = T>
+TAccumulate sum(const OptionalSpan<T>& span, TAccumulate init = TAccumulate()) {
+    const T* values = span.values();
+    const std::size_t size = span.size();
+    if (span.allValid()) {
+        for (std::size_t i = 0; i < size; ++i) {
+            init += values[i];
+        }
+        return init;
+    }
+    const std::uint64_t* validity = span.validity();
+    for (std::size_t base = 0; base < size; base += detail::BitsPerWord) {
+        const std::uint64_t word = validity[detail::wordIndex(base)];
+        if (word == 0) {
+            continue;
+        }
+        const std::size_t count = size - base < detail::BitsPerWord ? size - base : detail::BitsPerWord;
+        TAccumulate partial = TAccumulate();
+        for (std::size_t j = 0; j < count; ++j) {
+            partial += ((word >> j) & 1) ? TAccumulate(values[base + j]) : TAccumulate();
+        }
+        init += partial;
+    }
+    return init;
+}
+
+/// Smallest engaged element of \p span or NullOptional if there is none
+template <typename T>
+Optional<T> min(const OptionalSpan<T>& span) {
+    Optional<T> result;
+    forEachValid(span, [&](std::size_t, const T& value) {
+        if (!result || value < *result) {
+            result = value;
+        }
+    });
+    return result;
+}
+
+/// Largest engaged element of \p span or NullOptional if there is none
+template <typename T>
+Optional<T> max(const OptionalSpan<T>& span) {
+    Optional<T> result;
+    forEachValid(span, [&](std::size_t, const T& value) {
+        if (!result || *result < value) {
+            result = value;
+        }
+    });
+    return result;
+}
+
+/// Evaluates \p predicate on every engaged element of \p span and writes the outcome into the
+/// selection bitmap \p selection, which must hold at least wordCount(span.size()) words.
+/// Disengaged elements are never selected.
+///
+/// \return The number of selected elements
+template <typename T, typename TPredicate>
+std::size_t filter(const OptionalSpan<T>& span, TPredicate&& predicate, std::uint64_t* selection) {
+    const T* values = span.values();
+    const std::size_t size = span.size();
+    std::size_t selected = 0;
+    for (std::size_t base = 0; base < size; base += detail::BitsPerWord) {
+        const std::uint64_t valid =
+            span.allValid() ? ~std::uint64_t(0) : span.validity()[detail::wordIndex(base)];
+        const std::size_t count = size - base < detail::BitsPerWord ? size - base : detail::BitsPerWord;
+        std::uint64_t word = 0;
+        if (valid != 0) {
+            for (std::size_t j = 0; j < count; ++j) {
+                word |= std::uint64_t(predicate(values[base + j]) ? 1 : 0) << j;
+            }
+            word &= valid & detail::lowMask(count);
+        }
+        selection[detail::wordIndex(base)] = word;
+        selected += detail::popcount(word);
+    }
+    return selected;
+}
+
+// Kernels over a values array with an AdaptiveValidity. The constant forms return without
+// touching the values when nothing is engaged and run the dense loop when everything is.
+// Runs are processed as dense ranges, bitmaps as an OptionalSpan.
+
+/// Number of engaged elements, O(1)
+inline std::size_t countValid(const AdaptiveValidity& validity) noexcept {
+    return validity.validCount();
+}
+
+/// Number of disengaged elements, O(1)
+inline std::size_t countNull(const AdaptiveValidity& validity) noexcept {
+    return validity.nullCount();
+}
+
+/// Calls \p func(index, value) for every engaged element
+template <typename T, typename TFunc>
+void forEachValid(const T* values, const AdaptiveValidity& validity, TFunc&& func) {
+    switch (validity.kind()) {
+    case AdaptiveValidity::Kind::AllNull:
+        return;
+    case AdaptiveValidity::Kind::AllValid:
+    case AdaptiveValidity::Kind::Bitmap:
+        forEachValid(validity.span(values), func);
+        return;
+    case AdaptiveValidity::Kind::Runs:
+        for (const AdaptiveValidity::Run& run : validity.runs()) {
+            for (std::size_t i = run.start; i < run.start + run.length; ++i) {
+                func(i, values[i]);
+            }
+        }
+        return;
+    }
+}
+
+/// Sum of all engaged elements added to \p init
+template <typename T, typename TAccumulate = T>
+TAccumulate sum(const T* values, const AdaptiveValidity& validity, TAccumulate init = TAccumulate()) {
+    switch (validity.kind()) {
+    case AdaptiveValidity::Kind::AllNull:
+        return init;
+    case AdaptiveValidity::Kind::AllValid:
+    case AdaptiveValidity::Kind::Bitmap:
+        return sum<T, TAccumulate>(validity.span(values), init);
+    case AdaptiveValidity::Kind::Runs:
+        break;
+    }
+    for (const AdaptiveValidity::Run& run : validity.runs()) {
+        const T* first = values + run.start;
+        for (std::size_t i = 0; i < run.length; ++i) {
+            init += first[i];
+        }
+    }
+    return init;
+}
+
+/// Smallest engaged element or NullOptional if there is none
+template <typename T>
+Optional<T> min(const T* values, const AdaptiveValidity& validity) {
+    if (validity.isAllNull()) {
+        return NullOptional;
+    }
+    Optional<T> result;
+    forEachValid(values, validity, [&](std::size_t, const T& value) {
+        if (!result || value < *result) {
+            result = value;
+        }
+    });
+    return result;
+}
+
+/// Largest engaged element or NullOptional if there is none
+template <typename T>
+Optional<T> max(const T* values, const AdaptiveValidity& validity) {
+    if (validity.isAllNull()) {
+        return NullOptional;
+    }
+    Optional<T> result;
+    forEachValid(values, validity, [&](std::size_t, const T& value) {
+        if (!result || *result < value) {
+            result = value;
+        }
+    });
+    return result;
+}
+
+/// Same contract as filter() over an OptionalSpan, \p selection holds wordCount(validity.size()) words
+template <typename T, typename TPredicate>
+std::size_t filter(const T* values,
+                   const AdaptiveValidity& validity,
+                   TPredicate&& predicate,
+                   std::uint64_t* selection) {
+    const std::size_t words = detail::wordCount(validity.size());
+    switch (validity.kind()) {
+    case AdaptiveValidity::Kind::AllNull:
+        std::fill(selection, selection + words, std::uint64_t(0));
+        return 0;
+    case AdaptiveValidity::Kind::AllValid:
+    case AdaptiveValidity::Kind::Bitmap:
+        return filter(validity.span(values), predicate, selection);
+    case AdaptiveValidity::Kind::Runs:
+        break;
+    }
+    std::fill(selection, selection + words, std::uint64_t(0));
+    std::size_t selected = 0;
+    for (const AdaptiveValidity::Run& run : validity.runs()) {
+        for (std::size_t i = run.start; i < run.start + run.length; ++i) {
+            if (predicate(values[i])) {
+                detail::setBit(selection, i);
+                ++selected;
+            }
+        }
+    }
+    return selected;
+}
+
+} // namespace libOptional
+
+#endif // UTILS_KERNELS_HPP_
@@ -0,0 +1,215 @@
+#ifndef UTILS_LRU_CACHE_HPP_
+#define UTILS_LRU_CACHE_HPP_
+
+#include "lib-optional/hashing.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace libOptional {
+
+/// Fixed-capacity cache evicting the least recently used entry, without allocating after
+/// construction
+///
+/// Entries live in a pool of nodes allocated up front. The recency order is a circular doubly
+/// linked list threaded through the pool by 32-bit indices, unused nodes form a free list, and
+/// keys are found through a detail::NodeIndex. Keys and values are kept in Optional arrays
+/// separate from the links, so reordering the list does not pull them into the cache.
+///
+/// \note References returned by get() and put() stay valid until their entry is evicted or
+///       erased.
+template <typename TKey,
+          typename TValue,
+          typename THash = std::hash<TKey>,
+          typename TEqual = std::equal_to<TKey>>
+class LruCache final {
+public:
+    using KeyType = TKey;
+    using ValueType = TValue;
+    using key_type = KeyType;      // std traits
+    using mapped_type = ValueType; // std traits
+
+    /// \throw std::invalid_argument if \p capacity is zero
+    explicit LruCache(std::size_t capacity,
+                      const THash& hash = THash(),
+                      const TEqual& equal = TEqual())
+        : mCapacity(capacity)
+        , mIndex(capacity)
+        , mPrevious(new std::uint32_t[capacity + 1])
+        , mNext(new std::uint32_t[capacity + 1])
+        , mHashes(new std::uint32_t[capacity])
+        , mKeys(new Optional<TKey>[capacity])
+        , mValues(new Optional<TValue>[capacity])
+        , mHash(hash)
+        , mEqual(equal) {
+        if (capacity == 0) {
+            throw std::invalid_argument("The capacity of an LruCache must not be zero");
+        }
+        resetLinks();
+    }
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    /// The value of \p key, which becomes the most recently used entry
+    Optional<TValue&> get(const TKey& key) {
+        const std::uint32_t node = find(detail::mixHash(mHash(key)), key);
+        if (node == detail::NodeIndex::NotFound) {
+            return NullOptional;
+        }
+        moveToFront(node);
+        return *mValues[node];
+    }
+
+    /// The value of \p key without changing the recency order
+    Optional<const TValue&> peek(const TKey& key) const {
+        const std::uint32_t node = find(detail::mixHash(mHash(key)), key);
+        if (node == detail::NodeIndex::NotFound) {
+            return NullOptional;
+        }
+        return *mValues[node];
+    }
+
+    /// Stores \p value under \p key as the most recently used entry, evicting the least recently
+    /// used one if the cache is full
+    ///
+    /// \note If constructing the key or the value throws, the new entry is not added, but when the
+    ///       cache was full its least recently used entry has already been evicted.
+    /// \return The stored value
+    template <typename TArg>
+    TValue& put(const TKey& key, TArg&& value) {
+        const std::uint64_t hash = detail::mixHash(mHash(key));
+        std::uint32_t node = find(hash, key);
+        if (node != detail::NodeIndex::NotFound) {
+            mValues[node] = std::forward<TArg>(value);
+            moveToFront(node);
+            return *mValues[node];
+        }
+        if (mSize == mCapacity) {
+            remove(mPrevious[sentinel()]);
+            ++mEvictions;
+        }
+        node = mFree;
+        mKeys[node].emplace(key);
+        try {
+            mValues[node].emplace(std::forward<TArg>(value));
+        } catch (...) {
+            mKeys[node].reset();
+            throw;
+        }
+        mFree = mNext[node];
+        mHashes[node] = std::uint32_t(hash);
+        mIndex.insert(hash, node);
+        link(node, sentinel());
+        ++mSize;
+        return *mValues[node];
+    }
+
+    /// Removes \p key, returns false if it was not cached
+    bool erase(const TKey& key) {
+        const std::uint32_t node = find(detail::mixHash(mHash(key)), key);
+        if (node == detail::NodeIndex::NotFound) {
+            return false;
+        }
+        remove(node);
+        return true;
+    }
+
+    /// The key that put() would evict next
+    Optional<const TKey&> leastRecent() const noexcept {
+        if (mSize == 0) {
+            return NullOptional;
+        }
+        return *mKeys[mPrevious[sentinel()]];
+    }
+
+    void clear() noexcept {
+        for (std::size_t i = 0; i < mCapacity; ++i) {
+            mKeys[i].reset();
+            mValues[i].reset();
+        }
+        mIndex.clear();
+        mSize = 0;
+        resetLinks();
+    }
+
+    std::size_t size() const noexcept { return mSize; }
+
+    bool empty() const noexcept { return mSize == 0; }
+
+    std::size_t capacity() const noexcept { return mCapacity; }
+
+    /// Number of entries put() has evicted to make room
+    std::uint64_t evictions() const noexcept { return mEvictions; }
+
+private:
+    /// The list head, its next node is the most recently used one and its previous the least
+    std::uint32_t sentinel() const noexcept { return std::uint32_t(mCapacity); }
+
+    std::uint32_t find(std::uint64_t hash, const TKey& key) const {
+        return mIndex.find(hash, [this, &key](std::uint32_t node) { return mEqual(*mKeys[node], key); });
+    }
+
+    void resetLinks() noexcept {
+        mPrevious[sentinel()] = sentinel();
+        mNext[sentinel()] = sentinel();
+        for (std::size_t i = 0; i < mCapacity; ++i) {
+            mNext[i] = std::uint32_t(i + 1);
+        }
+        mFree = 0;
+    }
+
+    /// Inserts \p node right after \p previous
+    void link(std::uint32_t node, std::uint32_t previous) noexcept {
+        const std::uint32_t next = mNext[previous];
+        mPrevious[node] = previous;
+        mNext[node] = next;
+        mNext[previous] = node;
+        mPrevious[next] = node;
+    }
+
+    void unlink(std::uint32_t node) noexcept {
+        mNext[mPrevious[node]] = mNext[node];
+        mPrevious[mNext[node]] = mPrevious[node];
+    }
+
+    void moveToFront(std::uint32_t node) noexcept {
+        if (mNext[sentinel()] != node) {
+            unlink(node);
+            link(node, sentinel());
+        }
+    }
+
+    /// Returns \p node to the free list
+    void remove(std::uint32_t node) noexcept {
+        unlink(node);
+        mIndex.erase(mHashes[node], node);
+        mKeys[node].reset();
+        mValues[node].reset();
+        mNext[node] = mFree;
+        mFree = node;
+        --mSize;
+    }
+
+    const std::size_t mCapacity;
+    detail::NodeIndex mIndex;
+    std::unique_ptr<std::uint32_t[]> mPrevious;
+    std::unique_ptr<std::uint32_t[]> mNext;
+    std::unique_ptr<std::uint32_t[]> mHashes;
+    std::unique_ptr<Optional<TKey>[]> mKeys;
+    std::unique_ptr<Optional<TValue>[]> mValues;
+    std::uint32_t mFree = 0;
+    std::size_t mSize = 0;
+    std::uint64_t mEvictions = 0;
+    THash mHash;
+    TEqual mEqual;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_LRU_CACHE_HPP_
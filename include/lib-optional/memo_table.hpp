@@ -0,0 +1,145 @@
+#ifndef UTILS_MEMO_TABLE_HPP_
+#define UTILS_MEMO_TABLE_HPP_
+
+#include "lib-optional/hashing.hpp"
+#include "lib-optional/once_optional.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+namespace libOptional {
+
+class MemoTableError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/// Fixed-capacity concurrent memoization table for pure functions
+///
+/// Lock-free open addressing with linear probing over mixed hashes, so weak hashes such as the
+/// identity std::hash of integers do not form long clusters. A slot's key is published once and
+/// never changes, its value is a OnceOptional, so each key is computed at most once no matter how
+/// many threads ask for it at the same time; the others wait for that one computation. Hits
+/// cost a hash, the probe and acquire loads, with no writes to shared memory.
+///
+/// \note Entries are never removed. If a computation throws, the key stays in the table without
+///       a value and the next getOrCompute() for it tries again. If copying the key into its
+///       slot throws, the slot is given back empty.
+template <typename TKey,
+          typename TValue,
+          typename THash = std::hash<TKey>,
+          typename TEqual = std::equal_to<TKey>>
+class MemoTable final {
+public:
+    using KeyType = TKey;
+    using ValueType = TValue;
+    using key_type = KeyType;      // std traits
+    using mapped_type = ValueType; // std traits
+
+    /// \param capacity Number of slots, a power of two
+    /// \throw std::invalid_argument if the capacity is not a power of two
+    explicit MemoTable(std::size_t capacity, const THash& hash = THash(), const TEqual& equal = TEqual())
+        : mSlots(new Slot[capacity])
+        , mMask(capacity - 1)
+        , mHash(hash)
+        , mEqual(equal) {
+        if (capacity == 0 || (capacity & mMask) != 0) {
+            throw std::invalid_argument("The capacity of a MemoTable must be a power of two");
+        }
+    }
+
+    MemoTable(const MemoTable&) = delete;
+    MemoTable& operator=(const MemoTable&) = delete;
+
+    /// Returns the value of \p key, calling \p compute(key) first if it is not known yet
+    ///
+    /// \throw MemoTableError if the key is new and all slots are taken
+    template <typename TCompute>
+    const TValue& getOrCompute(const TKey& key, TCompute&& compute) {
+        Slot& slot = claim(key);
+        return slot.value.getOrInit([&]() -> TValue { return compute(key); });
+    }
+
+    /// The value of \p key if it has already been computed, never waits
+    Optional<const TValue&> find(const TKey& key) const noexcept {
+        const std::size_t hash = std::size_t(detail::mixHash(mHash(key)));
+        for (std::size_t i = 0; i <= mMask; ++i) {
+            const Slot& slot = mSlots[(hash + i) & mMask];
+            State state = slot.state.load(std::memory_order_acquire);
+            if (state == Empty) {
+                return NullOptional;
+            }
+            if (state == Published && slot.hash == hash && mEqual(*slot.key, key)) {
+                return slot.value.get();
+            }
+            // A key still being written is not computed yet, so it can be skipped
+        }
+        return NullOptional;
+    }
+
+    std::size_t capacity() const noexcept { return mMask + 1; }
+
+    /// Number of keys in the table, including the ones still being computed
+    std::size_t size() const noexcept { return mSize.load(std::memory_order_relaxed); }
+
+private:
+    enum State : unsigned char { Empty, Writing, Published };
+
+    struct Slot {
+        std::atomic<State> state{ Empty };
+        std::size_t hash = 0;
+        Optional<TKey> key;
+        OnceOptional<TValue> value;
+    };
+
+    Slot& claim(const TKey& key) {
+        const std::size_t hash = std::size_t(detail::mixHash(mHash(key)));
+        for (std::size_t i = 0; i <= mMask;) {
+            Slot& slot = mSlots[(hash + i) & mMask];
+            State state = slot.state.load(std::memory_order_acquire);
+            if (state == Empty) {
+                if (slot.state.compare_exchange_strong(state, Writing, std::memory_order_acquire)) {
+                    slot.hash = hash;
+                    try {
+                        slot.key.emplace(key);
+                    } catch (...) {
+                        slot.state.store(Empty, std::memory_order_release);
+                        throw;
+                    }
+                    slot.state.store(Published, std::memory_order_release);
+                    mSize.fetch_add(1, std::memory_order_relaxed);
+                    return slot;
+                }
+            }
+            // Another thread is publishing a key here, it may be ours
+            std::size_t attempt = 0;
+            while (state == Writing) {
+                detail::backoff(attempt);
+                state = slot.state.load(std::memory_order_acquire);
+            }
+            if (state == Empty) {
+                // Copying the other key threw and the slot was given back, try it again
+                continue;
+            }
+            if (slot.hash == hash && mEqual(*slot.key, key)) {
+                return slot;
+            }
+            ++i;
+        }
+        throw MemoTableError("The MemoTable is full");
+    }
+
+    std::unique_ptr<Slot[]> mSlots;
+    const std::size_t mMask;
+    const THash mHash;
+    const TEqual mEqual;
+    std::atomic<std::size_t> mSize{ 0 };
+};
+
+} // namespace libOptional
+
+#endif // UTILS_MEMO_TABLE_HPP_
@@ -0,0 +1,210 @@
+#ifndef UTILS_MPMC_QUEUE_HPP_
+#define UTILS_MPMC_QUEUE_HPP_
+
+#include "lib-optional/concurrency.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace libOptional {
+
+/// Bounded lock-free multi-producer/multi-consumer queue (Dmitry Vyukov's sequence-slot ring)
+///
+/// Every slot carries a sequence number that tells producers and consumers whether it is free
+/// for the lap they are on, so each operation costs one CAS on the shared position and one
+/// release store on the slot. Slots are padded to a cache line and hold the value in an
+/// uninitialized union just like Optional does, so T need not be default-constructible and
+/// tryPop() moves the value straight from the slot into the returned Optional.
+///
+/// A producer whose constructor throws has already claimed its slot, so the slot is published
+/// as a tombstone that consumers release and skip; the exception then propagates.
+template <typename T>
+class MpmcQueue final {
+public:
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "A claimed slot cannot be given back, so moving T out of it must not throw");
+
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    /// \param capacity Maximal number of queued elements, must be a power of two
+    explicit MpmcQueue(std::size_t capacity)
+        : mMask(capacity - 1)
+        , mSlots(capacity) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("The capacity of MpmcQueue must be a power of two");
+        }
+        for (std::size_t i = 0; i < capacity; ++i) {
+            mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    ~MpmcQueue() {
+        while (tryPop()) {
+        }
+    }
+
+    std::size_t capacity() const noexcept { return mMask + 1; }
+
+    /// Number of queued elements, only a snapshot while other threads are active
+    std::size_t sizeApprox() const noexcept {
+        const std::size_t tail = mDequeuePosition.load(std::memory_order_relaxed);
+        const std::size_t head = mEnqueuePosition.load(std::memory_order_relaxed);
+        return head > tail ? head - tail : 0;
+    }
+
+    /// Constructs an element from \p args at the back, returns false if the queue is full
+    ///
+    /// \throw Whatever the constructor of T throws, the queue stays usable
+    template <typename... TArgs>
+    bool tryEmplace(TArgs&&... args) {
+        std::size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = mSlots[position & mMask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::intptr_t difference = std::intptr_t(sequence) - std::intptr_t(position);
+            if (difference == 0) {
+                if (mEnqueuePosition.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed)) {
+                    try {
+                        new (reinterpret_cast<void*>(&slot.value)) T(std::forward<TArgs>(args)...);
+                    } catch (...) {
+                        slot.engaged = false;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        throw;
+                    }
+                    slot.engaged = true;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = mEnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPush(const T& value) { return tryEmplace(value); }
+
+    bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+    /// Removes the front element, empty if the queue is empty
+    Optional<T> tryPop() {
+        Optional<T> result;
+        std::size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = mSlots[position & mMask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::intptr_t difference = std::intptr_t(sequence) - std::intptr_t(position + 1);
+            if (difference == 0) {
+                if (mDequeuePosition.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed)) {
+                    if (slot.engaged) {
+                        detail::OptionalAccess::construct(result, std::move(slot.value));
+                    }
+                    release(slot, position);
+                    if (result) {
+                        return result;
+                    }
+                    // A tombstone, try the next slot
+                    position = mDequeuePosition.load(std::memory_order_relaxed);
+                }
+            } else if (difference < 0) {
+                return result;
+            } else {
+                position = mDequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Removes up to \p max elements from the front with a single CAS and writes them to \p out
+    ///
+    /// \return The number of elements written, lower than the number removed by the tombstones
+    ///         among them
+    /// \throw Whatever writing to \p out throws, the elements removed but not written yet are
+    ///        destroyed
+    template <typename TOutputIterator>
+    std::size_t tryPopMany(TOutputIterator out, std::size_t max) {
+        std::size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+        std::size_t count;
+        for (;;) {
+            count = 0;
+            while (count < max && count <= mMask) {
+                const Slot& slot = mSlots[(position + count) & mMask];
+                if (slot.sequence.load(std::memory_order_acquire) != position + count + 1) {
+                    break;
+                }
+                ++count;
+            }
+            if (count == 0) {
+                return 0;
+            }
+            if (mDequeuePosition.compare_exchange_weak(
+                    position, position + count, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        std::size_t written = 0;
+        std::size_t i = 0;
+        try {
+            for (; i < count; ++i) {
+                Slot& slot = mSlots[(position + i) & mMask];
+                if (slot.engaged) {
+                    *out = std::move(slot.value);
+                    ++out;
+                    ++written;
+                }
+                release(slot, position + i);
+            }
+        } catch (...) {
+            // The claimed slots must be released, or every consumer would stall at them
+            for (; i < count; ++i) {
+                release(mSlots[(position + i) & mMask], position + i);
+            }
+            throw;
+        }
+        return written;
+    }
+
+private:
+    struct alignas(detail::CacheLineSize) Slot {
+        Slot() noexcept {}
+        ~Slot() {}
+
+        std::atomic<std::size_t> sequence{ 0 };
+        bool engaged = false; ///< False for a tombstone, published by the sequence store
+        // Same trick as Optional, so T doesn't have to be default-constructible
+        struct Empty {};
+        union {
+            Empty empty;
+            T value;
+        };
+    };
+
+    /// Destroys the value of the claimed \p slot, if any, and hands the slot to the next lap
+    void release(Slot& slot, std::size_t position) noexcept {
+        if (slot.engaged) {
+            slot.value.~T();
+        }
+        slot.sequence.store(position + mMask + 1, std::memory_order_release);
+    }
+
+    const std::size_t mMask;
+    detail::CacheAlignedArray<Slot> mSlots;
+    alignas(detail::CacheLineSize) std::atomic<std::size_t> mEnqueuePosition{ 0 };
+    alignas(detail::CacheLineSize) std::atomic<std::size_t> mDequeuePosition{ 0 };
+};
+
+} // namespace libOptional
+
+#endif // UTILS_MPMC_QUEUE_HPP_
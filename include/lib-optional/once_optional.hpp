@@ -0,0 +1,89 @@
+#ifndef UTILS_ONCE_OPTIONAL_HPP_
+#define UTILS_ONCE_OPTIONAL_HPP_
+
+#include "lib-optional/concurrency.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace libOptional {
+
+namespace detail {
+
+    /// Waits a little for another thread, spinning first and then giving up the time slice
+    inline void backoff(std::size_t& attempt) noexcept {
+        if (attempt < 64) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+        ++attempt;
+    }
+
+} // namespace detail
+
+/// Optional value that is initialized at most once, by whichever thread asks for it first
+///
+/// Works like std::call_once with the result kept alongside the flag: getOrInit() runs the
+/// initializer in one thread while concurrent callers wait for it, and once the value is set
+/// reads are a single acquire load. If the initializer throws the value stays empty and the
+/// next caller runs its initializer instead.
+template <typename T>
+class OnceOptional final {
+public:
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    OnceOptional() = default;
+    OnceOptional(const OnceOptional&) = delete;
+    OnceOptional& operator=(const OnceOptional&) = delete;
+
+    /// Returns the value, calling \p init() to construct it first if nobody has done so yet
+    template <typename TInit>
+    const T& getOrInit(TInit&& init) {
+        std::size_t attempt = 0;
+        for (;;) {
+            State state = mState.load(std::memory_order_acquire);
+            if (state == Ready) {
+                return *mValue;
+            }
+            if (state == Empty && mState.compare_exchange_weak(state, Running, std::memory_order_acquire)) {
+                struct Rollback {
+                    ~Rollback() {
+                        if (state) {
+                            state->store(Empty, std::memory_order_release);
+                        }
+                    }
+                    std::atomic<State>* state;
+                } rollback{ &mState };
+                detail::OptionalAccess::construct(mValue, init());
+                rollback.state = nullptr;
+                mState.store(Ready, std::memory_order_release);
+                return *mValue;
+            }
+            detail::backoff(attempt);
+        }
+    }
+
+    /// The value if it has been initialized, never waits
+    Optional<const T&> get() const noexcept {
+        if (mState.load(std::memory_order_acquire) != Ready) {
+            return NullOptional;
+        }
+        return *mValue;
+    }
+
+    bool hasValue() const noexcept { return mState.load(std::memory_order_acquire) == Ready; }
+
+private:
+    enum State : unsigned char { Empty, Running, Ready };
+
+    std::atomic<State> mState{ Empty };
+    Optional<T> mValue;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_ONCE_OPTIONAL_HPP_
@@ -100,6 +100,8 @@ namespace detail {
         Nonmovable& operator=(Nonmovable&&) = delete;
     };
 
+    struct OptionalAccess;
+
 } // namespace detail
 
 template <typename T>
@@ -599,8 +601,41 @@ private:
 
     template <typename TValueOther>
     friend class Optional;
+
+    friend struct detail::OptionalAccess;
 };
 
+namespace detail {
+
+    /// Direct access to the storage of an Optional for the library's own containers and
+    /// serializers, which need to construct the value in place without going through emplace()
+    struct OptionalAccess {
+        /// Address of the (possibly uninitialized) value storage
+        template <typename T>
+        static void* storage(Optional<T>& optional) noexcept {
+            return reinterpret_cast<void*>(&optional.mValue);
+        }
+
+        /// Constructs the value of a disengaged \p optional in place
+        template <typename T, typename... TArgs>
+        static void construct(Optional<T>& optional, TArgs&&... args) noexcept(
+            std::is_nothrow_constructible<typename Optional<T>::ValueType, TArgs...>::value) {
+            assert(!optional.mInitialized);
+            optional.construct(std::forward<TArgs>(args)...);
+        }
+
+        /// Marks \p optional as engaged after its storage was filled with a valid object,
+        /// e.g. by copying the bytes of a trivially copyable type
+        template <typename T>
+        static void markInitialized(Optional<T>& optional) noexcept {
+            static_assert(std::is_trivially_copyable<typename Optional<T>::ValueType>::value,
+                          "Only trivially copyable values can be initialized by writing their bytes");
+            optional.mInitialized = true;
+        }
+    };
+
+} // namespace detail
+
 // Compare Optional<T> to Optional<T>
 template <typename T>
 constexpr bool operator==(const Optional<T>& x, const Optional<T>& y) {
@@ -0,0 +1,208 @@
+#ifndef UTILS_OPTIONAL_POOL_HPP_
+#define UTILS_OPTIONAL_POOL_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace libOptional {
+
+/// Fixed-capacity pool of N objects of type T that lives wherever the pool lives, with no heap
+/// allocation at all
+///
+/// Every slot is an Optional<T>, so its storage is the uninitialized union an Optional already
+/// provides, constructed by acquire() and destroyed by release(). Free slots are the set bits of
+/// atomic 64-bit occupancy words; a slot is taken by clearing its bit with a compare-and-swap
+/// found by a count-trailing-zeros, and given back with an atomic OR. The pool can therefore be
+/// shared between threads as is, and ThreadCache takes slots in batches to keep threads off the
+/// shared words.
+///
+/// \note N * sizeof(Optional<T>) bytes are embedded in the pool, large pools belong in static or
+///       heap storage rather than on the stack. All objects must be released before the pool is
+///       destroyed.
+template <typename T, std::size_t N>
+class OptionalPool final {
+public:
+    static_assert(N > 0, "OptionalPool needs at least one slot");
+    static_assert(N < 0xffffffffu, "OptionalPool supports at most 2^32 - 2 slots");
+
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    class ThreadCache;
+
+    OptionalPool() noexcept {
+        for (std::size_t i = 0; i < Words; ++i) {
+            const std::size_t bits = i + 1 < Words ? detail::BitsPerWord : N - i * detail::BitsPerWord;
+            mFree[i].store(detail::lowMask(bits), std::memory_order_relaxed);
+        }
+    }
+
+    OptionalPool(const OptionalPool&) = delete;
+    OptionalPool& operator=(const OptionalPool&) = delete;
+
+    /// Constructs an object from \p args in a free slot
+    ///
+    /// \return The object, empty if all slots are taken
+    template <typename... TArgs>
+    Optional<T&> acquire(TArgs&&... args) {
+        std::uint32_t index;
+        if (take(&index, 1) == 0) {
+            return NullOptional;
+        }
+        try {
+            return construct(index, std::forward<TArgs>(args)...);
+        } catch (...) {
+            give(index);
+            throw;
+        }
+    }
+
+    /// Destroys \p object, which must have been acquired from this pool, and frees its slot
+    void release(T& object) noexcept { give(destroy(object)); }
+
+    /// Whether \p object lives in one of the slots of this pool
+    bool owns(const T& object) const noexcept {
+        const char* address = reinterpret_cast<const char*>(&object);
+        const char* first = reinterpret_cast<const char*>(&mSlots[0]);
+        return address >= first && address < reinterpret_cast<const char*>(&mSlots[N]);
+    }
+
+    /// Number of free slots, only a snapshot while other threads are active
+    std::size_t available() const noexcept {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < Words; ++i) {
+            count += detail::popcount(mFree[i].load(std::memory_order_relaxed));
+        }
+        return count;
+    }
+
+    static constexpr std::size_t capacity() noexcept { return N; }
+
+private:
+    static constexpr std::size_t Words = detail::wordCount(N);
+
+    /// Clears up to \p max free bits, writing the indices of their slots to \p out
+    ///
+    /// \return The number of slots taken
+    std::size_t take(std::uint32_t* out, std::size_t max) noexcept {
+        std::size_t taken = 0;
+        for (std::size_t i = 0; i < Words && taken < max; ++i) {
+            std::uint64_t word = mFree[i].load(std::memory_order_relaxed);
+            std::uint64_t bits = 0;
+            while (word != 0) {
+                // The lowest free bits of the word, as many as are still wanted
+                bits = 0;
+                std::uint64_t rest = word;
+                for (std::size_t wanted = max - taken; rest != 0 && wanted > 0; --wanted) {
+                    bits |= rest & (~rest + 1);
+                    rest &= rest - 1;
+                }
+                if (mFree[i].compare_exchange_weak(
+                        word, rest, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    break;
+                }
+                bits = 0;
+            }
+            for (; bits != 0; bits &= bits - 1) {
+                out[taken++] = std::uint32_t(i * detail::BitsPerWord + detail::countTrailingZeros(bits));
+            }
+        }
+        return taken;
+    }
+
+    void give(std::uint32_t index) noexcept {
+        mFree[detail::wordIndex(index)].fetch_or(detail::bitMask(index), std::memory_order_release);
+    }
+
+    template <typename... TArgs>
+    T& construct(std::uint32_t index, TArgs&&... args) {
+        detail::OptionalAccess::construct(mSlots[index], std::forward<TArgs>(args)...);
+        return *mSlots[index];
+    }
+
+    /// Destroys \p object and returns the index of its slot
+    std::uint32_t destroy(T& object) noexcept {
+        assert(owns(object));
+        const char* first = static_cast<const char*>(detail::OptionalAccess::storage(mSlots[0]));
+        const std::size_t index =
+            std::size_t(reinterpret_cast<const char*>(&object) - first) / sizeof(Optional<T>);
+        assert(mSlots[index]);
+        mSlots[index].reset();
+        return std::uint32_t(index);
+    }
+
+    Optional<T> mSlots[N];
+    std::atomic<std::uint64_t> mFree[Words];
+};
+
+/// Per-thread front-end of an OptionalPool
+///
+/// Keeps up to 2 * Batch free slot indices of its own, refilled and drained Batch at a time,
+/// so most acquire() and release() calls touch no shared memory. Each thread creates its own
+/// cache, e.g. as a thread_local; objects may be released through any cache of the same pool.
+/// The cached slots go back to the pool when the cache is destroyed.
+template <typename T, std::size_t N>
+class OptionalPool<T, N>::ThreadCache final {
+public:
+    enum : std::size_t { Batch = 32 };
+
+    explicit ThreadCache(OptionalPool& pool) noexcept
+        : mPool(pool) {}
+
+    ThreadCache(const ThreadCache&) = delete;
+    ThreadCache& operator=(const ThreadCache&) = delete;
+
+    ~ThreadCache() noexcept { drain(mCount); }
+
+    template <typename... TArgs>
+    Optional<T&> acquire(TArgs&&... args) {
+        if (mCount == 0) {
+            mCount = mPool.take(mIndices, Batch);
+            if (mCount == 0) {
+                return NullOptional;
+            }
+        }
+        const std::uint32_t index = mIndices[--mCount];
+        try {
+            return mPool.construct(index, std::forward<TArgs>(args)...);
+        } catch (...) {
+            mIndices[mCount++] = index;
+            throw;
+        }
+    }
+
+    void release(T& object) noexcept {
+        if (mCount == 2 * Batch) {
+            drain(Batch);
+        }
+        mIndices[mCount++] = mPool.destroy(object);
+    }
+
+    /// Number of free slots held by this cache
+    std::size_t cached() const noexcept { return mCount; }
+
+private:
+    /// Gives the \p count most recently cached slots back to the pool
+    void drain(std::size_t count) noexcept {
+        for (; count > 0; --count) {
+            mPool.give(mIndices[--mCount]);
+        }
+    }
+
+    OptionalPool& mPool;
+    std::uint32_t mIndices[2 * Batch];
+    std::size_t mCount = 0;
+};
+
+template <typename T, std::size_t N>
+constexpr std::size_t OptionalPool<T, N>::Words;
+
+} // namespace libOptional
+
+#endif // UTILS_OPTIONAL_POOL_HPP_
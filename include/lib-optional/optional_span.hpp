@@ -0,0 +1,72 @@
+#ifndef UTILS_OPTIONAL_SPAN_HPP_
+#define UTILS_OPTIONAL_SPAN_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace libOptional {
+
+/// Non-owning view over a nullable column stored as a contiguous array of values
+/// and a validity bitmap (bit i set means element i is engaged).
+///
+/// The value of a disengaged element is unspecified, but it must be a valid object,
+/// so kernels are free to read it. A null validity pointer means all elements are engaged.
+template <typename T>
+class OptionalSpan final {
+public:
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    OptionalSpan() noexcept = default;
+
+    OptionalSpan(const T* values, const std::uint64_t* validity, std::size_t size) noexcept
+        : mValues(values)
+        , mValidity(validity)
+        , mSize(size) {}
+
+    std::size_t size() const noexcept { return mSize; }
+
+    bool empty() const noexcept { return mSize == 0; }
+
+    const T* values() const noexcept { return mValues; }
+
+    const std::uint64_t* validity() const noexcept { return mValidity; }
+
+    bool allValid() const noexcept { return mValidity == nullptr; }
+
+    bool isValid(std::size_t index) const noexcept {
+        assert(index < mSize);
+        return mValidity == nullptr || detail::testBit(mValidity, index);
+    }
+
+    Optional<const T&> operator[](std::size_t index) const noexcept {
+        if (!isValid(index)) {
+            return NullOptional;
+        }
+        return mValues[index];
+    }
+
+    /// Elements [offset, offset + count)
+    ///
+    /// \note The offset must be a multiple of 64 so the validity bitmap stays word-aligned
+    OptionalSpan subspan(std::size_t offset, std::size_t count) const noexcept {
+        assert(offset % detail::BitsPerWord == 0);
+        assert(offset + count <= mSize);
+        return OptionalSpan(mValues + offset,
+                            mValidity ? mValidity + detail::wordIndex(offset) : nullptr,
+                            count);
+    }
+
+private:
+    const T* mValues = nullptr;
+    const std::uint64_t* mValidity = nullptr;
+    std::size_t mSize = 0;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_OPTIONAL_SPAN_HPP_
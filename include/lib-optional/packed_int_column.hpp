@@ -0,0 +1,276 @@
+#ifndef UTILS_PACKED_INT_COLUMN_HPP_
+#define UTILS_PACKED_INT_COLUMN_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional_span.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace libOptional {
+
+namespace detail {
+
+    static constexpr std::size_t PackLanes = 4;
+    static constexpr std::size_t PackFrameSize = 256;
+    static constexpr std::size_t PackLaneValues = PackFrameSize / PackLanes;
+
+    inline unsigned bitWidth(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return value == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned width = 0;
+        while (value != 0) {
+            value >>= 1;
+            ++width;
+        }
+        return width;
+#endif
+    }
+
+    /// Packs a frame of PackFrameSize values using \p width bits each into 4 * width words
+    ///
+    /// Value i belongs to lane i % 4 and the lanes are interleaved word by word, so unpacking
+    /// performs the very same shifts on four neighbouring words and vectorizes.
+    inline void packFrame(const std::uint64_t* in, unsigned width, std::uint64_t* out) noexcept {
+        if (width == 0) {
+            return;
+        }
+        std::memset(out, 0, PackLanes * width * sizeof(std::uint64_t));
+        for (std::size_t j = 0; j < PackLaneValues; ++j) {
+            const std::size_t bit = j * width;
+            const std::size_t word = bit / 64;
+            const unsigned shift = unsigned(bit % 64);
+            for (std::size_t lane = 0; lane < PackLanes; ++lane) {
+                const std::uint64_t value = in[j * PackLanes + lane];
+                out[word * PackLanes + lane] |= value << shift;
+                if (shift + width > 64) {
+                    out[(word + 1) * PackLanes + lane] |= value >> (64 - shift);
+                }
+            }
+        }
+    }
+
+    template <unsigned TWidth>
+    void unpackFrame(const std::uint64_t* in, std::uint64_t* out) noexcept {
+        const std::uint64_t mask = lowMask(TWidth);
+        for (std::size_t j = 0; j < PackLaneValues; ++j) {
+            const std::size_t bit = j * TWidth;
+            const std::size_t word = bit / 64;
+            const unsigned shift = unsigned(bit % 64);
+            for (std::size_t lane = 0; lane < PackLanes; ++lane) {
+                std::uint64_t value = in[word * PackLanes + lane] >> shift;
+                if (shift + TWidth > 64) {
+                    value |= in[(word + 1) * PackLanes + lane] << (64 - shift);
+                }
+                out[j * PackLanes + lane] = value & mask;
+            }
+        }
+    }
+
+    template <>
+    inline void unpackFrame<0>(const std::uint64_t*, std::uint64_t* out) noexcept {
+        std::memset(out, 0, PackFrameSize * sizeof(std::uint64_t));
+    }
+
+    using UnpackFunction = void (*)(const std::uint64_t*, std::uint64_t*);
+
+    template <unsigned TWidth>
+    struct UnpackTable {
+        static void fill(UnpackFunction* table) noexcept {
+            table[TWidth] = &unpackFrame<TWidth>;
+            UnpackTable<TWidth - 1>::fill(table);
+        }
+    };
+
+    template <>
+    struct UnpackTable<0> {
+        static void fill(UnpackFunction* table) noexcept { table[0] = &unpackFrame<0>; }
+    };
+
+    /// Unpacks a frame packed by packFrame(), each width has its own fully specialized loop
+    inline void unpackFrame(const std::uint64_t* in, unsigned width, std::uint64_t* out) noexcept {
+        struct Table {
+            Table() noexcept { UnpackTable<64>::fill(functions); }
+
+            UnpackFunction functions[65];
+        };
+        static const Table table;
+        table.functions[width](in, out);
+    }
+
+} // namespace detail
+
+/// Compressed Optional<std::int64_t> column
+///
+/// The validity bitmap is kept as is, only the engaged values are compressed. They are split
+/// into frames of 256 values and every frame is stored either frame-of-reference encoded
+/// (value - frame minimum) or delta encoded (difference to the previous value - minimum
+/// difference), whichever needs fewer bits, and bit-packed with the smallest sufficient width.
+class PackedInt64Column final {
+public:
+    static constexpr std::size_t FrameSize = detail::PackFrameSize;
+
+    PackedInt64Column() = default;
+
+    static PackedInt64Column encode(const OptionalSpan<std::int64_t>& column) {
+        PackedInt64Column result;
+        result.mSize = column.size();
+        result.mValidity.assign(detail::wordCount(column.size()), 0);
+
+        std::vector<std::uint64_t> engaged;
+        engaged.reserve(column.size());
+        for (std::size_t i = 0; i < column.size(); ++i) {
+            if (column.isValid(i)) {
+                engaged.push_back(std::uint64_t(column.values()[i]));
+                detail::setBit(result.mValidity.data(), i);
+            }
+        }
+        result.mEngaged = engaged.size();
+        engaged.resize((engaged.size() + FrameSize - 1) / FrameSize * FrameSize);
+
+        for (std::size_t first = 0; first < result.mEngaged; first += FrameSize) {
+            result.encodeFrame(engaged.data() + first,
+                               std::min(detail::PackFrameSize, result.mEngaged - first));
+        }
+        return result;
+    }
+
+    /// Number of rows
+    std::size_t size() const noexcept { return mSize; }
+
+    /// Number of engaged rows
+    std::size_t engagedCount() const noexcept { return mEngaged; }
+
+    const std::vector<std::uint64_t>& validity() const noexcept { return mValidity; }
+
+    /// Size of the encoded representation in bytes
+    std::size_t byteSize() const noexcept {
+        return mValidity.size() * sizeof(std::uint64_t) + mFrames.size() * sizeof(Frame) +
+               mPacked.size() * sizeof(std::uint64_t);
+    }
+
+    /// Decodes the column into \p values and \p validity, which must hold size() values and
+    /// wordCount(size()) words. Disengaged rows are decoded as zero.
+    void decode(std::int64_t* values, std::uint64_t* validity) const noexcept {
+        if (!mValidity.empty()) {
+            std::memcpy(validity, mValidity.data(), mValidity.size() * sizeof(std::uint64_t));
+        }
+        // The engaged values are decoded densely to the front of the output and then spread to
+        // their rows from the back, which never overwrites a value that wasn't moved yet
+        std::uint64_t* output = reinterpret_cast<std::uint64_t*>(values);
+        for (std::size_t i = 0; i < mFrames.size(); ++i) {
+            const std::size_t first = i * detail::PackFrameSize;
+            if (mEngaged - first >= detail::PackFrameSize) {
+                decodeFrame(i, output + first);
+            } else {
+                std::uint64_t frame[detail::PackFrameSize];
+                decodeFrame(i, frame);
+                std::memcpy(output + first, frame, (mEngaged - first) * sizeof(std::uint64_t));
+            }
+        }
+        if (mEngaged == mSize) {
+            return;
+        }
+        std::size_t engaged = mEngaged;
+        for (std::size_t word = detail::wordCount(mSize); word-- > 0;) {
+            const std::size_t base = word * detail::BitsPerWord;
+            const std::size_t count = std::min(detail::BitsPerWord, mSize - base);
+            const std::uint64_t bits = mValidity[word];
+            if (bits == detail::lowMask(count)) {
+                engaged -= count;
+                std::memmove(output + base, output + engaged, count * sizeof(std::uint64_t));
+            } else if (bits == 0) {
+                std::memset(output + base, 0, count * sizeof(std::uint64_t));
+            } else {
+                for (std::size_t bit = count; bit-- > 0;) {
+                    output[base + bit] = (bits >> bit) & 1 ? output[--engaged] : 0;
+                }
+            }
+        }
+    }
+
+private:
+    enum class Mode : std::uint8_t { FrameOfReference, Delta };
+
+    struct Frame {
+        std::uint64_t reference;
+        std::uint64_t base;
+        std::size_t offset; ///< Position of the packed words in mPacked
+        std::uint8_t width;
+        Mode mode;
+    };
+
+    void encodeFrame(const std::uint64_t* values, std::size_t count) {
+        std::int64_t minimum = std::int64_t(values[0]);
+        std::int64_t maximum = minimum;
+        std::int64_t minimumDelta = 0;
+        std::int64_t maximumDelta = 0;
+        for (std::size_t i = 1; i < count; ++i) {
+            const std::int64_t value = std::int64_t(values[i]);
+            const std::int64_t delta = std::int64_t(values[i] - values[i - 1]);
+            minimum = std::min(minimum, value);
+            maximum = std::max(maximum, value);
+            minimumDelta = i == 1 ? delta : std::min(minimumDelta, delta);
+            maximumDelta = i == 1 ? delta : std::max(maximumDelta, delta);
+        }
+
+        const unsigned referenceWidth = detail::bitWidth(std::uint64_t(maximum) - std::uint64_t(minimum));
+        const unsigned deltaWidth =
+            detail::bitWidth(std::uint64_t(maximumDelta) - std::uint64_t(minimumDelta));
+
+        Frame frame;
+        frame.offset = mPacked.size();
+        std::uint64_t residuals[FrameSize] = {};
+        if (count > 1 && deltaWidth < referenceWidth) {
+            frame.mode = Mode::Delta;
+            frame.width = std::uint8_t(deltaWidth);
+            frame.reference = std::uint64_t(minimumDelta);
+            frame.base = values[0];
+            for (std::size_t i = 1; i < count; ++i) {
+                residuals[i] = values[i] - values[i - 1] - frame.reference;
+            }
+        } else {
+            frame.mode = Mode::FrameOfReference;
+            frame.width = std::uint8_t(referenceWidth);
+            frame.reference = std::uint64_t(minimum);
+            frame.base = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                residuals[i] = values[i] - frame.reference;
+            }
+        }
+        mPacked.resize(mPacked.size() + detail::PackLanes * frame.width);
+        detail::packFrame(residuals, frame.width, mPacked.data() + frame.offset);
+        mFrames.push_back(frame);
+    }
+
+    void decodeFrame(std::size_t index, std::uint64_t* out) const noexcept {
+        const Frame& frame = mFrames[index];
+        detail::unpackFrame(mPacked.data() + frame.offset, frame.width, out);
+        if (frame.mode == Mode::FrameOfReference) {
+            for (std::size_t i = 0; i < FrameSize; ++i) {
+                out[i] += frame.reference;
+            }
+        } else {
+            std::uint64_t value = frame.base;
+            out[0] = value;
+            for (std::size_t i = 1; i < FrameSize; ++i) {
+                value += out[i] + frame.reference;
+                out[i] = value;
+            }
+        }
+    }
+
+    std::size_t mSize = 0;
+    std::size_t mEngaged = 0;
+    std::vector<std::uint64_t> mValidity;
+    std::vector<Frame> mFrames;
+    std::vector<std::uint64_t> mPacked;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_PACKED_INT_COLUMN_HPP_
@@ -0,0 +1,135 @@
+#ifndef UTILS_SEQLOCK_OPTIONAL_HPP_
+#define UTILS_SEQLOCK_OPTIONAL_HPP_
+
+#include "lib-optional/concurrency.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace libOptional {
+
+/// Optional value shared between one writer and any number of readers through a sequence lock
+///
+/// The writer never waits: it makes the sequence odd, stores the payload and makes it even
+/// again. Readers never write shared memory, they copy the payload and retry if the sequence
+/// changed meanwhile, so they don't contend with each other at all. Every load() returns a copy
+/// that is consistent with exactly one store() or reset().
+///
+/// The payload is kept in relaxed atomic words, so the concurrent reads that a seqlock relies on
+/// are not data races.
+///
+/// \note Writes must be serialized by the caller, i.e. there is a single writer at a time.
+///       Readers may starve while the writer updates the value continuously, which is why this
+///       is meant for read-mostly data.
+template <typename T>
+class SeqlockOptional final {
+public:
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "The underlying type of SeqlockOptional must be trivially copyable");
+
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    SeqlockOptional() noexcept = default;
+
+    explicit SeqlockOptional(const T& value) noexcept { store(value); }
+
+    SeqlockOptional(const SeqlockOptional&) = delete;
+    SeqlockOptional& operator=(const SeqlockOptional&) = delete;
+
+    /// Publishes \p value, wait-free
+    void store(const T& value) noexcept {
+        std::uint64_t words[WordCount] = {};
+        std::memcpy(words, &value, sizeof(T));
+        write(words, true);
+    }
+
+    void store(const Optional<T>& value) noexcept {
+        if (value) {
+            store(*value);
+        } else {
+            reset();
+        }
+    }
+
+    /// Publishes the disengaged state, wait-free
+    void reset() noexcept { write(nullptr, false); }
+
+    /// Copy of the value as of the latest completed store() or reset()
+    Optional<T> load() const noexcept {
+        Optional<T> result;
+        std::uint64_t words[WordCount];
+        if (read(words)) {
+            std::memcpy(detail::OptionalAccess::storage(result), words, sizeof(T));
+            detail::OptionalAccess::markInitialized(result);
+        }
+        return result;
+    }
+
+    bool hasValue() const noexcept {
+        for (;;) {
+            const std::uint64_t sequence = mSequence.load(std::memory_order_acquire);
+            const bool engaged = mEngaged.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((sequence & 1) == 0 && mSequence.load(std::memory_order_relaxed) == sequence) {
+                return engaged;
+            }
+            detail::cpuRelax();
+        }
+    }
+
+    /// Number of completed writes, can be used by readers to detect changes cheaply
+    std::uint64_t version() const noexcept { return mSequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr std::size_t WordCount =
+        (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    void write(const std::uint64_t* words, bool engaged) noexcept {
+        const std::uint64_t sequence = mSequence.load(std::memory_order_relaxed);
+        mSequence.store(sequence + 1, std::memory_order_relaxed);
+        // Orders the odd sequence before the payload stores
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; engaged && i < WordCount; ++i) {
+            mWords[i].store(words[i], std::memory_order_relaxed);
+        }
+        mEngaged.store(engaged, std::memory_order_relaxed);
+        mSequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /// Copies a consistent snapshot into \p words, returns whether it is engaged
+    bool read(std::uint64_t* words) const noexcept {
+        for (;;) {
+            const std::uint64_t sequence = mSequence.load(std::memory_order_acquire);
+            if ((sequence & 1) == 0) {
+                const bool engaged = mEngaged.load(std::memory_order_relaxed);
+                if (engaged) {
+                    for (std::size_t i = 0; i < WordCount; ++i) {
+                        words[i] = mWords[i].load(std::memory_order_relaxed);
+                    }
+                }
+                // Orders the payload loads before the sequence re-check
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (mSequence.load(std::memory_order_relaxed) == sequence) {
+                    return engaged;
+                }
+            }
+            detail::cpuRelax();
+        }
+    }
+
+    alignas(detail::CacheLineSize) std::atomic<std::uint64_t> mSequence{ 0 };
+    std::atomic<bool> mEngaged{ false };
+    std::atomic<std::uint64_t> mWords[WordCount];
+};
+
+template <typename T>
+constexpr std::size_t SeqlockOptional<T>::WordCount;
+
+} // namespace libOptional
+
+#endif // UTILS_SEQLOCK_OPTIONAL_HPP_
@@ -0,0 +1,290 @@
+#ifndef UTILS_SERIALIZATION_HPP_
+#define UTILS_SERIALIZATION_HPP_
+
+#include "lib-optional/optional.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace libOptional {
+
+class SerializationError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/// Writer appending to a byte vector
+class BufferWriter final {
+public:
+    explicit BufferWriter(std::vector<unsigned char>& buffer) noexcept
+        : mBuffer(buffer) {}
+
+    void write(const void* data, std::size_t size) {
+        const std::size_t offset = mBuffer.size();
+        mBuffer.resize(offset + size);
+        std::memcpy(mBuffer.data() + offset, data, size);
+    }
+
+private:
+    std::vector<unsigned char>& mBuffer;
+};
+
+/// Reader consuming a contiguous block of bytes
+class BufferReader final {
+public:
+    BufferReader(const void* data, std::size_t size) noexcept
+        : mData(static_cast<const unsigned char*>(data))
+        , mEnd(mData + size) {}
+
+    explicit BufferReader(const std::vector<unsigned char>& buffer) noexcept
+        : BufferReader(buffer.data(), buffer.size()) {}
+
+    void read(void* data, std::size_t size) {
+        if (std::size_t(mEnd - mData) < size) {
+            throw SerializationError("Unexpected end of serialized data");
+        }
+        std::memcpy(data, mData, size);
+        mData += size;
+    }
+
+    std::size_t remaining() const noexcept { return std::size_t(mEnd - mData); }
+
+private:
+    const unsigned char* mData;
+    const unsigned char* mEnd;
+};
+
+/// Customization point describing how a T is written and read
+///
+/// A specialization provides `static void write(TWriter&, const T&)` and `static T read(TReader&)`.
+/// TWriter must have `write(const void*, std::size_t)` and TReader `read(void*, std::size_t)`.
+/// Trivially copyable types are written as their raw bytes in the native byte order unless
+/// Serializer is specialized for them, bool as one byte that must be 0 or 1.
+template <typename T, typename = void>
+struct Serializer;
+
+namespace detail {
+
+    /// Raw-bytes Serializer of trivially copyable types, code reading into an Optional bypasses
+    /// Serializer<T>::read() only when Serializer<T> is this one and not a user specialization
+    template <typename T>
+    struct RawSerializer {
+        template <typename TWriter>
+        static void write(TWriter& writer, const T& value) {
+            writer.write(&value, sizeof(T));
+        }
+
+        template <typename TReader>
+        static T read(TReader& reader) {
+            T value;
+            reader.read(&value, sizeof(T));
+            return value;
+        }
+    };
+
+    template <typename T>
+    using IsRawSerialized = std::is_base_of<RawSerializer<T>, Serializer<T>>;
+
+} // namespace detail
+
+template <typename T>
+struct Serializer<T, detail::EnableIf<std::is_trivially_copyable<T>::value>> : detail::RawSerializer<T> {};
+
+template <>
+struct Serializer<bool> {
+    template <typename TWriter>
+    static void write(TWriter& writer, bool value) {
+        const unsigned char byte = value ? 1 : 0;
+        writer.write(&byte, 1);
+    }
+
+    template <typename TReader>
+    static bool read(TReader& reader) {
+        unsigned char byte;
+        reader.read(&byte, 1);
+        if (byte > 1) {
+            throw SerializationError("Invalid bool byte");
+        }
+        return byte == 1;
+    }
+};
+
+template <>
+struct Serializer<std::string> {
+    template <typename TWriter>
+    static void write(TWriter& writer, const std::string& value) {
+        const std::uint64_t size = value.size();
+        writer.write(&size, sizeof(size));
+        writer.write(value.data(), value.size());
+    }
+
+    template <typename TReader>
+    static std::string read(TReader& reader) {
+        std::uint64_t size;
+        reader.read(&size, sizeof(size));
+        std::string value(std::size_t(size), '\0');
+        if (size != 0) {
+            reader.read(&value[0], value.size());
+        }
+        return value;
+    }
+};
+
+namespace detail {
+
+    template <typename T>
+    struct IsOptional : std::false_type {};
+
+    template <typename T>
+    struct IsOptional<Optional<T>> : std::true_type {};
+
+    /// Reads a T straight into the storage of the disengaged \p optional
+    template <typename T, typename TReader>
+    EnableIf<IsRawSerialized<T>::value> readInto(TReader& reader, Optional<T>& optional) {
+        reader.read(OptionalAccess::storage(optional), sizeof(T));
+        OptionalAccess::markInitialized(optional);
+    }
+
+    template <typename T, typename TReader>
+    DisableIf<IsRawSerialized<T>::value> readInto(TReader& reader, Optional<T>& optional) {
+        OptionalAccess::construct(optional, Serializer<T>::read(reader));
+    }
+
+} // namespace detail
+
+/// An Optional is written as one presence byte followed by the payload if it's engaged
+///
+/// Reading constructs the payload directly in the Optional's storage, payloads using the default
+/// raw-bytes Serializer are copied there byte by byte without any temporary.
+template <typename T>
+struct Serializer<Optional<T>> {
+    static_assert(!std::is_reference<T>::value, "Optional references cannot be serialized");
+
+    template <typename TWriter>
+    static void write(TWriter& writer, const Optional<T>& value) {
+        const unsigned char present = value ? 1 : 0;
+        writer.write(&present, 1);
+        if (value) {
+            Serializer<T>::write(writer, *value);
+        }
+    }
+
+    template <typename TReader>
+    static Optional<T> read(TReader& reader) {
+        Optional<T> value;
+        read(reader, value);
+        return value;
+    }
+
+    template <typename TReader>
+    static void read(TReader& reader, Optional<T>& value) {
+        unsigned char present;
+        reader.read(&present, 1);
+        value.reset();
+        if (present == 1) {
+            detail::readInto(reader, value);
+        } else if (present != 0) {
+            throw SerializationError("Invalid Optional presence byte");
+        }
+    }
+};
+
+template <typename TWriter, typename T>
+void serialize(TWriter& writer, const T& value) {
+    Serializer<T>::write(writer, value);
+}
+
+template <typename TReader, typename T>
+detail::DisableIf<detail::IsOptional<T>::value> deserialize(TReader& reader, T& value) {
+    value = Serializer<T>::read(reader);
+}
+
+template <typename TReader, typename T>
+void deserialize(TReader& reader, Optional<T>& value) {
+    Serializer<Optional<T>>::read(reader, value);
+}
+
+namespace detail {
+
+    template <typename... Ts>
+    struct OptionalCount;
+
+    template <>
+    struct OptionalCount<> {
+        static constexpr std::size_t value = 0;
+    };
+
+    template <typename T, typename... Ts>
+    struct OptionalCount<T, Ts...> {
+        static constexpr std::size_t value = (IsOptional<T>::value ? 1 : 0) + OptionalCount<Ts...>::value;
+    };
+
+    template <typename T>
+    void collectPresence(unsigned char*, std::size_t&, const T&) {}
+
+    template <typename T>
+    void collectPresence(unsigned char* bits, std::size_t& index, const Optional<T>& field) {
+        if (field) {
+            bits[index / 8] |= static_cast<unsigned char>(1u << (index % 8));
+        }
+        ++index;
+    }
+
+    template <typename TWriter, typename T>
+    void writeField(TWriter& writer, const T& field) {
+        Serializer<T>::write(writer, field);
+    }
+
+    template <typename TWriter, typename T>
+    void writeField(TWriter& writer, const Optional<T>& field) {
+        if (field) {
+            Serializer<T>::write(writer, *field);
+        }
+    }
+
+    template <typename TReader, typename T>
+    void readField(TReader& reader, const unsigned char*, std::size_t&, T& field) {
+        field = Serializer<T>::read(reader);
+    }
+
+    template <typename TReader, typename T>
+    void readField(TReader& reader, const unsigned char* bits, std::size_t& index, Optional<T>& field) {
+        field.reset();
+        if (bits[index / 8] & (1u << (index % 8))) {
+            readInto(reader, field);
+        }
+        ++index;
+    }
+
+    using Expand = int[];
+
+} // namespace detail
+
+/// Writes an aggregate of fields with the presence of all Optional fields packed into a bitmask
+/// of ceil(optionals / 8) bytes in front of the payloads. Disengaged fields take no other space.
+template <typename TWriter, typename... TFields>
+void serializeFields(TWriter& writer, const TFields&... fields) {
+    unsigned char bits[(detail::OptionalCount<TFields...>::value + 7) / 8 + 1] = {};
+    std::size_t index = 0;
+    (void)detail::Expand{ 0, (detail::collectPresence(bits, index, fields), 0)... };
+    writer.write(bits, (detail::OptionalCount<TFields...>::value + 7) / 8);
+    (void)detail::Expand{ 0, (detail::writeField(writer, fields), 0)... };
+}
+
+/// Reads fields written by serializeFields(), engaged Optional fields are constructed in place
+template <typename TReader, typename... TFields>
+void deserializeFields(TReader& reader, TFields&... fields) {
+    unsigned char bits[(detail::OptionalCount<TFields...>::value + 7) / 8 + 1] = {};
+    reader.read(bits, (detail::OptionalCount<TFields...>::value + 7) / 8);
+    std::size_t index = 0;
+    (void)detail::Expand{ 0, (detail::readField(reader, bits, index, fields), 0)... };
+}
+
+} // namespace libOptional
+
+#endif // UTILS_SERIALIZATION_HPP_
@@ -0,0 +1,193 @@
+#ifndef UTILS_SET_ASSOCIATIVE_CACHE_HPP_
+#define UTILS_SET_ASSOCIATIVE_CACHE_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/hashing.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace libOptional {
+
+/// Fixed-size N-way set-associative cache, a lossy map meant to sit in front of a slower lookup
+///
+/// A key can only live in the TWays slots of the set its hash selects; inserting into a full set
+/// evicts one of them, round-robin. One-byte hash tags, keys and values are kept in separate
+/// arrays, so a lookup compares the tags of the whole set at once (one SSE2 instruction for 8
+/// and 16 ways) and only touches the keys of matching tags and the one value it returns.
+///
+/// \note lookup() returns a reference into the cache, it is invalidated by the next insert()
+///       into the same set, erase() or clear().
+template <typename TKey,
+          typename TValue,
+          std::size_t TWays = 8,
+          typename THash = std::hash<TKey>,
+          typename TEqual = std::equal_to<TKey>>
+class SetAssociativeCache final {
+public:
+    static_assert(TWays >= 1 && TWays <= 32, "SetAssociativeCache supports 1 to 32 ways");
+
+    using KeyType = TKey;
+    using ValueType = TValue;
+    using key_type = KeyType;      // std traits
+    using mapped_type = ValueType; // std traits
+
+    /// \param capacity Number of entries, rounded up so that the number of sets is a power of two
+    explicit SetAssociativeCache(std::size_t capacity,
+                                 const THash& hash = THash(),
+                                 const TEqual& equal = TEqual())
+        : mSetMask(setCount(capacity) - 1)
+        , mTags(new std::uint8_t[setCount(capacity) * TWays]())
+        , mKeys(new Optional<TKey>[setCount(capacity) * TWays])
+        , mValues(new Optional<TValue>[setCount(capacity) * TWays])
+        , mVictims(new std::uint8_t[setCount(capacity)]())
+        , mHash(hash)
+        , mEqual(equal) {}
+
+    SetAssociativeCache(const SetAssociativeCache&) = delete;
+    SetAssociativeCache& operator=(const SetAssociativeCache&) = delete;
+
+    /// The cached value of \p key, without copying it
+    Optional<TValue&> lookup(const TKey& key) noexcept {
+        const std::size_t slot = find(key);
+        if (slot == NotFound) {
+            return NullOptional;
+        }
+        return *mValues[slot];
+    }
+
+    Optional<const TValue&> lookup(const TKey& key) const noexcept {
+        const std::size_t slot = find(key);
+        if (slot == NotFound) {
+            return NullOptional;
+        }
+        return *mValues[slot];
+    }
+
+    /// Stores \p value under \p key, replacing the value of the key if it is cached and otherwise
+    /// evicting an entry of its set if the set is full
+    ///
+    /// \note If assigning the key or the value of a new entry throws, the way picked for it is
+    ///       left empty, so a full set loses its round-robin victim.
+    /// \return The stored value
+    template <typename TArg>
+    TValue& insert(const TKey& key, TArg&& value) {
+        const std::uint64_t hash = detail::mixHash(mHash(key));
+        const std::size_t set = std::size_t(hash) & mSetMask;
+        const std::uint8_t tag = detail::hashTag(hash);
+        std::size_t slot = match(set, tag, key);
+        if (slot != NotFound) {
+            mValues[slot] = std::forward<TArg>(value);
+            return *mValues[slot];
+        }
+        const std::uint32_t empty = detail::matchTags<TWays>(&mTags[set * TWays], 0);
+        if (empty != 0) {
+            slot = set * TWays + detail::countTrailingZeros(empty);
+            ++mSize;
+        } else {
+            slot = set * TWays + mVictims[set];
+            mVictims[set] = std::uint8_t((mVictims[set] + 1) % TWays);
+            ++mEvictions;
+        }
+        try {
+            mValues[slot] = std::forward<TArg>(value);
+            mKeys[slot] = key;
+        } catch (...) {
+            // The way may hold a mix of the evicted entry and the new one, drop it
+            mTags[slot] = 0;
+            mKeys[slot].reset();
+            mValues[slot].reset();
+            --mSize;
+            throw;
+        }
+        mTags[slot] = tag;
+        return *mValues[slot];
+    }
+
+    /// Removes \p key, returns false if it was not cached
+    bool erase(const TKey& key) noexcept {
+        const std::size_t slot = find(key);
+        if (slot == NotFound) {
+            return false;
+        }
+        mTags[slot] = 0;
+        mKeys[slot].reset();
+        mValues[slot].reset();
+        --mSize;
+        return true;
+    }
+
+    void clear() noexcept {
+        for (std::size_t i = 0; i < capacity(); ++i) {
+            mTags[i] = 0;
+            mKeys[i].reset();
+            mValues[i].reset();
+        }
+        mSize = 0;
+    }
+
+    std::size_t size() const noexcept { return mSize; }
+
+    std::size_t capacity() const noexcept { return (mSetMask + 1) * TWays; }
+
+    static constexpr std::size_t ways() noexcept { return TWays; }
+
+    /// Number of entries insert() has evicted to make room
+    std::uint64_t evictions() const noexcept { return mEvictions; }
+
+private:
+    static constexpr std::size_t NotFound = ~std::size_t(0);
+
+    static std::size_t setCount(std::size_t capacity) noexcept {
+        std::size_t sets = 1;
+        while (sets * TWays < capacity) {
+            sets *= 2;
+        }
+        return sets;
+    }
+
+    std::size_t find(const TKey& key) const noexcept {
+        const std::uint64_t hash = detail::mixHash(mHash(key));
+        return match(std::size_t(hash) & mSetMask, detail::hashTag(hash), key);
+    }
+
+    std::size_t match(std::size_t set, std::uint8_t tag, const TKey& key) const noexcept {
+        std::uint32_t candidates = detail::matchTags<TWays>(&mTags[set * TWays], tag);
+        while (candidates != 0) {
+            const std::size_t slot = set * TWays + detail::countTrailingZeros(candidates);
+            if (mEqual(*mKeys[slot], key)) {
+                return slot;
+            }
+            candidates &= candidates - 1;
+        }
+        return NotFound;
+    }
+
+    std::size_t mSetMask;
+    std::unique_ptr<std::uint8_t[]> mTags;
+    std::unique_ptr<Optional<TKey>[]> mKeys;
+    std::unique_ptr<Optional<TValue>[]> mValues;
+    std::unique_ptr<std::uint8_t[]> mVictims;
+    std::size_t mSize = 0;
+    std::uint64_t mEvictions = 0;
+    THash mHash;
+    TEqual mEqual;
+};
+
+template <typename TKey, typename TValue, std::size_t TWays, typename THash, typename TEqual>
+constexpr std::size_t SetAssociativeCache<TKey, TValue, TWays, THash, TEqual>::NotFound;
+
+/// Direct-mapped cache, every key has exactly one slot it can be cached in
+template <typename TKey,
+          typename TValue,
+          typename THash = std::hash<TKey>,
+          typename TEqual = std::equal_to<TKey>>
+using DirectMappedCache = SetAssociativeCache<TKey, TValue, 1, THash, TEqual>;
+
+} // namespace libOptional
+
+#endif // UTILS_SET_ASSOCIATIVE_CACHE_HPP_
@@ -0,0 +1,218 @@
+#ifndef UTILS_SLOT_MAP_HPP_
+#define UTILS_SLOT_MAP_HPP_
+
+#include "lib-optional/bitmap.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace libOptional {
+
+/// Stable reference to an element of a SlotMap, it never refers to a different element once its
+/// own element is erased
+struct SlotHandle {
+    constexpr SlotHandle() noexcept = default;
+
+    constexpr SlotHandle(std::uint32_t slotIndex, std::uint32_t slotGeneration) noexcept
+        : index(slotIndex)
+        , generation(slotGeneration) {}
+
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0; ///< Zero only in handles that were never issued
+
+    bool operator==(const SlotHandle& other) const noexcept {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const SlotHandle& other) const noexcept { return !(*this == other); }
+};
+
+/// Container of T addressed by generational handles, with the values stored densely
+///
+/// Each slot holds the position of its value in the dense array and a generation that is bumped
+/// whenever the slot's element is erased, so a stale handle is recognized instead of silently
+/// reaching the element that reused the slot. Free slots are marked in a bitmask with a summary
+/// bitmask of its non-zero words on top, so the lowest free slot is found with two
+/// count-trailing-zeros after skipping whole summary words of 4096 slots at a time. Erasing
+/// moves the last value into the hole, so iteration is always a contiguous walk over the live
+/// values only.
+///
+/// \note Erasing reorders the values and invalidates references and iterators to them, handles
+///       stay valid.
+template <typename T>
+class SlotMap final {
+public:
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+    using Handle = SlotHandle;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /// Constructs an element from \p args and returns its handle
+    ///
+    /// \throw std::length_error if the map already holds 2^32 - 1 elements
+    template <typename... TArgs>
+    Handle emplace(TArgs&&... args) {
+        if (mValues.size() >= NoSlot) {
+            throw std::length_error("A SlotMap holds at most 2^32 - 1 elements");
+        }
+        const std::uint32_t index = freeSlot();
+        mValueSlots.push_back(index);
+        try {
+            mValues.emplace_back(std::forward<TArgs>(args)...);
+        } catch (...) {
+            mValueSlots.pop_back();
+            throw;
+        }
+        markUsed(index);
+        Slot& slot = mSlots[index];
+        slot.dense = std::uint32_t(mValues.size() - 1);
+        return Handle{ index, slot.generation };
+    }
+
+    Handle insert(const T& value) { return emplace(value); }
+
+    Handle insert(T&& value) { return emplace(std::move(value)); }
+
+    /// Erases the element of \p handle, returns false if the handle is stale
+    bool erase(Handle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        Slot& slot = mSlots[handle.index];
+        const std::uint32_t dense = slot.dense;
+        if (dense + 1 != mValues.size()) {
+            mValues[dense] = std::move(mValues.back());
+            mValueSlots[dense] = mValueSlots.back();
+            mSlots[mValueSlots[dense]].dense = dense;
+        }
+        mValues.pop_back();
+        mValueSlots.pop_back();
+        slot.dense = NoSlot;
+        // Zero is reserved for handles that were never issued
+        slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+        markFree(handle.index);
+        return true;
+    }
+
+    bool contains(Handle handle) const noexcept {
+        return handle.index < mSlots.size() && mSlots[handle.index].generation == handle.generation &&
+               mSlots[handle.index].dense != NoSlot;
+    }
+
+    /// The element of \p handle, empty if the handle is stale
+    Optional<T&> get(Handle handle) noexcept {
+        if (!contains(handle)) {
+            return NullOptional;
+        }
+        return mValues[mSlots[handle.index].dense];
+    }
+
+    Optional<const T&> get(Handle handle) const noexcept {
+        if (!contains(handle)) {
+            return NullOptional;
+        }
+        return mValues[mSlots[handle.index].dense];
+    }
+
+    /// Handle of the element at \p position of the dense iteration order
+    Handle handleAt(std::size_t position) const noexcept {
+        const std::uint32_t index = mValueSlots[position];
+        return Handle{ index, mSlots[index].generation };
+    }
+
+    iterator begin() noexcept { return mValues.begin(); }
+
+    iterator end() noexcept { return mValues.end(); }
+
+    const_iterator begin() const noexcept { return mValues.begin(); }
+
+    const_iterator end() const noexcept { return mValues.end(); }
+
+    T* data() noexcept { return mValues.data(); }
+
+    const T* data() const noexcept { return mValues.data(); }
+
+    std::size_t size() const noexcept { return mValues.size(); }
+
+    bool empty() const noexcept { return mValues.empty(); }
+
+    /// Number of slots ever used, the live ones plus the free ones waiting for reuse
+    std::size_t slotCount() const noexcept { return mSlots.size(); }
+
+    void reserve(std::size_t capacity) {
+        mValues.reserve(capacity);
+        mValueSlots.reserve(capacity);
+        mSlots.reserve(capacity);
+        mFree.reserve(detail::wordCount(capacity));
+        mFreeSummary.reserve(detail::wordCount(detail::wordCount(capacity)));
+    }
+
+    /// Erases all elements, their handles become stale
+    void clear() {
+        while (!mValues.empty()) {
+            erase(handleAt(mValues.size() - 1));
+        }
+    }
+
+private:
+    static constexpr std::uint32_t NoSlot = 0xffffffffu;
+
+    struct Slot {
+        std::uint32_t dense;
+        std::uint32_t generation;
+    };
+
+    /// Index of the lowest free slot, appending one if there is none
+    std::uint32_t freeSlot() {
+        for (; mSummaryHint < mFreeSummary.size(); ++mSummaryHint) {
+            const std::uint64_t summary = mFreeSummary[mSummaryHint];
+            if (summary != 0) {
+                const std::size_t word =
+                    mSummaryHint * detail::BitsPerWord + detail::countTrailingZeros(summary);
+                return std::uint32_t(word * detail::BitsPerWord + detail::countTrailingZeros(mFree[word]));
+            }
+        }
+        const std::uint32_t index = std::uint32_t(mSlots.size());
+        mSlots.push_back(Slot{ NoSlot, 1 });
+        mFree.resize(detail::wordCount(mSlots.size()));
+        mFreeSummary.resize(detail::wordCount(mFree.size()));
+        markFree(index);
+        return index;
+    }
+
+    void markFree(std::uint32_t index) noexcept {
+        detail::setBit(mFree.data(), index);
+        const std::size_t word = detail::wordIndex(index);
+        detail::setBit(mFreeSummary.data(), word);
+        if (detail::wordIndex(word) < mSummaryHint) {
+            mSummaryHint = detail::wordIndex(word);
+        }
+    }
+
+    void markUsed(std::uint32_t index) noexcept {
+        detail::clearBit(mFree.data(), index);
+        const std::size_t word = detail::wordIndex(index);
+        if (mFree[word] == 0) {
+            detail::clearBit(mFreeSummary.data(), word);
+        }
+    }
+
+    std::vector<T> mValues;
+    std::vector<std::uint32_t> mValueSlots;
+    std::vector<Slot> mSlots;
+    std::vector<std::uint64_t> mFree;
+    std::vector<std::uint64_t> mFreeSummary;
+    std::size_t mSummaryHint = 0; ///< No summary word before it has a bit set
+};
+
+template <typename T>
+constexpr std::uint32_t SlotMap<T>::NoSlot;
+
+} // namespace libOptional
+
+#endif // UTILS_SLOT_MAP_HPP_
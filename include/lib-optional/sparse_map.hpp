@@ -0,0 +1,181 @@
+#ifndef UTILS_SPARSE_MAP_HPP_
+#define UTILS_SPARSE_MAP_HPP_
+
+#include "lib-optional/optional.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace libOptional {
+
+/// Map from integer ids to values built on a sparse set
+///
+/// The values and their ids are stored densely in insertion order, minus the erased ones, and a
+/// sparse array indexed by id holds the dense position of each present id. Lookup, insertion and
+/// erasure (which moves the last value into the hole) are O(1), and iteration only walks the
+/// present values. The sparse array is split into pages of PageSize positions that are only
+/// allocated once an id in their range is inserted, so a few large ids cost a few pages rather
+/// than a slot for every smaller id.
+///
+/// \note Erasing reorders the values and invalidates references and iterators to them.
+template <typename TValue>
+class SparseMap final {
+public:
+    using KeyType = std::uint32_t;
+    using ValueType = TValue;
+    using key_type = KeyType;      // std traits
+    using mapped_type = ValueType; // std traits
+    using iterator = typename std::vector<TValue>::iterator;
+    using const_iterator = typename std::vector<TValue>::const_iterator;
+
+    enum : std::size_t { PageSize = 4096 };
+
+    /// Constructs the value of \p id from \p args unless \p id is already present
+    ///
+    /// \return The value of \p id and whether it was inserted; \p args are left untouched when
+    ///         it was not
+    template <typename... TArgs>
+    std::pair<TValue&, bool> tryEmplace(KeyType id, TArgs&&... args) {
+        std::uint32_t& position = slot(id);
+        if (position != Absent) {
+            return std::pair<TValue&, bool>(mValues[position], false);
+        }
+        mIds.push_back(id);
+        try {
+            mValues.emplace_back(std::forward<TArgs>(args)...);
+        } catch (...) {
+            mIds.pop_back();
+            throw;
+        }
+        position = std::uint32_t(mValues.size() - 1);
+        return std::pair<TValue&, bool>(mValues.back(), true);
+    }
+
+    /// Stores \p value under \p id, assigning it to the present value if there is one
+    ///
+    /// \return The value of \p id
+    template <typename TArg>
+    TValue& insert(KeyType id, TArg&& value) {
+        const std::uint32_t position = lookup(id);
+        if (position != Absent) {
+            mValues[position] = std::forward<TArg>(value);
+            return mValues[position];
+        }
+        return tryEmplace(id, std::forward<TArg>(value)).first;
+    }
+
+    /// The value of \p id, empty if \p id is not present
+    Optional<TValue&> find(KeyType id) noexcept {
+        const std::uint32_t position = lookup(id);
+        if (position == Absent) {
+            return NullOptional;
+        }
+        return mValues[position];
+    }
+
+    Optional<const TValue&> find(KeyType id) const noexcept {
+        const std::uint32_t position = lookup(id);
+        if (position == Absent) {
+            return NullOptional;
+        }
+        return mValues[position];
+    }
+
+    bool contains(KeyType id) const noexcept { return lookup(id) != Absent; }
+
+    /// Removes \p id, returns false if it was not present
+    bool erase(KeyType id) {
+        const std::uint32_t position = lookup(id);
+        if (position == Absent) {
+            return false;
+        }
+        if (position + 1 != mValues.size()) {
+            mValues[position] = std::move(mValues.back());
+            mIds[position] = mIds.back();
+            slot(mIds[position]) = position;
+        }
+        mValues.pop_back();
+        mIds.pop_back();
+        mPages[id / PageSize][id % PageSize] = Absent;
+        return true;
+    }
+
+    /// Removes all values, the allocated pages are kept for reuse
+    void clear() noexcept {
+        for (KeyType id : mIds) {
+            mPages[id / PageSize][id % PageSize] = Absent;
+        }
+        mIds.clear();
+        mValues.clear();
+    }
+
+    iterator begin() noexcept { return mValues.begin(); }
+
+    iterator end() noexcept { return mValues.end(); }
+
+    const_iterator begin() const noexcept { return mValues.begin(); }
+
+    const_iterator end() const noexcept { return mValues.end(); }
+
+    /// The present ids, in the same order as the values
+    const KeyType* ids() const noexcept { return mIds.data(); }
+
+    TValue* values() noexcept { return mValues.data(); }
+
+    const TValue* values() const noexcept { return mValues.data(); }
+
+    std::size_t size() const noexcept { return mValues.size(); }
+
+    bool empty() const noexcept { return mValues.empty(); }
+
+    void reserve(std::size_t capacity) {
+        mIds.reserve(capacity);
+        mValues.reserve(capacity);
+    }
+
+    /// Bytes used by the sparse pages and the dense arrays, without the values' own allocations
+    std::size_t memoryUsage() const noexcept {
+        std::size_t pages = 0;
+        for (const std::unique_ptr<std::uint32_t[]>& page : mPages) {
+            pages += page ? 1 : 0;
+        }
+        return pages * PageSize * sizeof(std::uint32_t) + mPages.capacity() * sizeof(mPages[0]) +
+               mIds.capacity() * sizeof(KeyType) + mValues.capacity() * sizeof(TValue);
+    }
+
+private:
+    enum : std::uint32_t { Absent = 0xffffffffu };
+
+    std::uint32_t lookup(KeyType id) const noexcept {
+        const std::size_t page = id / PageSize;
+        if (page >= mPages.size() || !mPages[page]) {
+            return Absent;
+        }
+        return mPages[page][id % PageSize];
+    }
+
+    /// Position entry of \p id, allocating its page if needed
+    std::uint32_t& slot(KeyType id) {
+        const std::size_t page = id / PageSize;
+        if (page >= mPages.size()) {
+            mPages.resize(page + 1);
+        }
+        if (!mPages[page]) {
+            mPages[page].reset(new std::uint32_t[PageSize]);
+            std::fill(mPages[page].get(), mPages[page].get() + PageSize, std::uint32_t(Absent));
+        }
+        return mPages[page][id % PageSize];
+    }
+
+    std::vector<std::unique_ptr<std::uint32_t[]>> mPages;
+    std::vector<KeyType> mIds;
+    std::vector<TValue> mValues;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_SPARSE_MAP_HPP_
@@ -0,0 +1,129 @@
+#ifndef UTILS_SPSC_MAILBOX_HPP_
+#define UTILS_SPSC_MAILBOX_HPP_
+
+#include "lib-optional/concurrency.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace libOptional {
+
+/// What SpscMailbox::tryPut() does when the previous message was not taken yet
+enum class MailboxMode {
+    Reject,   ///< The new message is refused
+    Overwrite ///< The new message replaces the old one, the consumer only ever sees the latest
+};
+
+/// Single-slot mailbox passing "the latest message or nothing" from one producer thread to one
+/// consumer thread without locks and without heap allocation
+///
+/// The message lives in an Optional<T> and an atomic state tells which side owns it. In the
+/// Reject mode both operations are wait-free. In the Overwrite mode the producer may have to
+/// wait for a consumer that is in the middle of moving the message out, which is bounded by
+/// the move constructor of T.
+///
+/// The state and the message, the producer's counters and the consumer's counters are placed on
+/// separate cache lines.
+template <typename T, MailboxMode TMode = MailboxMode::Reject>
+class SpscMailbox final {
+public:
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    SpscMailbox() = default;
+    SpscMailbox(const SpscMailbox&) = delete;
+    SpscMailbox& operator=(const SpscMailbox&) = delete;
+
+    /// Producer side, returns false if the message was refused because the slot is full
+    ///
+    /// \note Never fails in the Overwrite mode, an unread message is destroyed instead
+    bool tryPut(T&& value) { return put(std::move(value)); }
+
+    bool tryPut(const T& value) { return put(value); }
+
+    /// Consumer side, takes the message out of the slot if there is one
+    Optional<T> tryTake() {
+        if (mState.load(std::memory_order_acquire) != Full) {
+            return NullOptional;
+        }
+        if (TMode == MailboxMode::Overwrite) {
+            // The producer may be replacing the message right now
+            State expected = Full;
+            if (!mState.compare_exchange_strong(expected, Reading, std::memory_order_acquire)) {
+                return NullOptional;
+            }
+        }
+        Optional<T> result;
+        try {
+            detail::OptionalAccess::construct(result, std::move(*mSlot));
+        } catch (...) {
+            // The message stays for the next attempt
+            mState.store(Full, std::memory_order_release);
+            throw;
+        }
+        mSlot.reset();
+        mState.store(Empty, std::memory_order_release);
+        mTaken.store(mTaken.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return result;
+    }
+
+    /// Whether a message is waiting, only a hint while the other side is active
+    bool full() const noexcept { return mState.load(std::memory_order_acquire) != Empty; }
+
+    /// Number of unread messages replaced by newer ones, written by the producer
+    std::uint64_t overwrittenCount() const noexcept { return mOverwritten.load(std::memory_order_relaxed); }
+
+    /// Number of messages taken, written by the consumer
+    std::uint64_t takenCount() const noexcept { return mTaken.load(std::memory_order_relaxed); }
+
+private:
+    enum State : unsigned char { Empty, Writing, Full, Reading };
+
+    template <typename TValue>
+    bool put(TValue&& value) {
+        State state = mState.load(std::memory_order_acquire);
+        if (state == Empty) {
+            // Only the producer leaves the Empty state, so the slot is ours and disengaged
+            detail::OptionalAccess::construct(mSlot, std::forward<TValue>(value));
+            mState.store(Full, std::memory_order_release);
+            return true;
+        }
+        if (TMode == MailboxMode::Reject) {
+            return false;
+        }
+        for (;;) {
+            if (state == Full && mState.compare_exchange_weak(state, Writing, std::memory_order_acquire)) {
+                mSlot.reset();
+                mOverwritten.store(mOverwritten.load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_relaxed);
+                break;
+            }
+            if (state == Empty) {
+                break;
+            }
+            detail::cpuRelax();
+            state = mState.load(std::memory_order_acquire);
+        }
+        try {
+            detail::OptionalAccess::construct(mSlot, std::forward<TValue>(value));
+        } catch (...) {
+            // The replaced message is already gone, the slot is left empty
+            mState.store(Empty, std::memory_order_release);
+            throw;
+        }
+        mState.store(Full, std::memory_order_release);
+        return true;
+    }
+
+    alignas(detail::CacheLineSize) std::atomic<State> mState{ Empty };
+    Optional<T> mSlot;
+    alignas(detail::CacheLineSize) std::atomic<std::uint64_t> mOverwritten{ 0 };
+    alignas(detail::CacheLineSize) std::atomic<std::uint64_t> mTaken{ 0 };
+};
+
+} // namespace libOptional
+
+#endif // UTILS_SPSC_MAILBOX_HPP_
@@ -0,0 +1,108 @@
+#ifndef UTILS_STRING_REF_HPP_
+#define UTILS_STRING_REF_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace libOptional {
+
+/// Non-owning reference to a sequence of characters, a C++11 stand-in for std::string_view
+class StringRef final {
+public:
+    constexpr StringRef() noexcept
+        : mData(nullptr)
+        , mSize(0) {}
+
+    constexpr StringRef(const char* data, std::size_t size) noexcept
+        : mData(data)
+        , mSize(size) {}
+
+    StringRef(const char* string) noexcept
+        : mData(string)
+        , mSize(std::strlen(string)) {}
+
+    StringRef(const std::string& string) noexcept
+        : mData(string.data())
+        , mSize(string.size()) {}
+
+    constexpr const char* data() const noexcept { return mData; }
+
+    constexpr std::size_t size() const noexcept { return mSize; }
+
+    constexpr bool empty() const noexcept { return mSize == 0; }
+
+    const char* begin() const noexcept { return mData; }
+
+    const char* end() const noexcept { return mData + mSize; }
+
+    char operator[](std::size_t index) const noexcept { return mData[index]; }
+
+    std::string str() const { return std::string(mData, mSize); }
+
+    int compare(StringRef other) const noexcept {
+        const std::size_t common = std::min(mSize, other.mSize);
+        const int result = common == 0 ? 0 : std::memcmp(mData, other.mData, common);
+        return result != 0 ? result : mSize < other.mSize ? -1 : mSize > other.mSize ? 1 : 0;
+    }
+
+private:
+    const char* mData;
+    std::size_t mSize;
+};
+
+inline bool operator==(StringRef lhs, StringRef rhs) noexcept {
+    return lhs.size() == rhs.size() &&
+           (lhs.size() == 0 || std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+}
+
+inline bool operator!=(StringRef lhs, StringRef rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+inline bool operator<(StringRef lhs, StringRef rhs) noexcept {
+    return lhs.compare(rhs) < 0;
+}
+
+inline std::ostream& operator<<(std::ostream& stream, StringRef string) {
+    return stream.write(string.data(), std::streamsize(string.size()));
+}
+
+namespace detail {
+
+    /// FNV-1a with a final avalanche, good enough for short keys such as dictionary strings
+    inline std::uint64_t hashBytes(const void* data, std::size_t size) noexcept {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        std::uint64_t hash = 0xCBF29CE484222325ULL;
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+        }
+        hash ^= hash >> 32;
+        hash *= 0xD6E8FEB86659FD93ULL;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+} // namespace detail
+
+} // namespace libOptional
+
+namespace std {
+
+template <>
+struct hash<libOptional::StringRef> {
+    using argument_type = libOptional::StringRef;
+    using result_type = std::size_t;
+
+    result_type operator()(const argument_type& string) const noexcept {
+        return result_type(libOptional::detail::hashBytes(string.data(), string.size()));
+    }
+};
+
+} // namespace std
+
+#endif // UTILS_STRING_REF_HPP_
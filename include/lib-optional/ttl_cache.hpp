@@ -0,0 +1,289 @@
+#ifndef UTILS_TTL_CACHE_HPP_
+#define UTILS_TTL_CACHE_HPP_
+
+#include "lib-optional/hashing.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace libOptional {
+
+/// Fixed-capacity cache whose entries expire a given time after they were stored
+///
+/// Expiry is driven by a hashed timing wheel: every entry sits in the bucket of the tick it
+/// expires in, and advancing the wheel only visits the buckets of the ticks that passed since the
+/// last advance, so removing expired entries costs O(1) amortized per entry instead of periodic
+/// sweeps over the whole cache. The wheel advances on put() and expire(); get() additionally
+/// checks the expiry time of the entry it finds, so an expired value is never returned.
+///
+/// Nodes, links and the key index are allocated up front as in LruCache. When the cache is full
+/// even after expiring, put() evicts an entry from the bucket that expires next.
+///
+/// \tparam TClock Anything with the std::chrono clock interface whose now() may be called on an
+///                instance, which lets tests pass a manually driven clock
+template <typename TKey,
+          typename TValue,
+          typename TClock = std::chrono::steady_clock,
+          typename THash = std::hash<TKey>,
+          typename TEqual = std::equal_to<TKey>>
+class TtlCache final {
+public:
+    using KeyType = TKey;
+    using ValueType = TValue;
+    using key_type = KeyType;      // std traits
+    using mapped_type = ValueType; // std traits
+    using Clock = TClock;
+    using Duration = typename TClock::duration;
+    using TimePoint = typename TClock::time_point;
+
+    /// \param capacity Maximum number of entries
+    /// \param ttl Time to live of the entries stored without an explicit one; the wheel ticks
+    ///            TicksPerTtl times per this duration
+    /// \throw std::invalid_argument if \p capacity is zero or \p ttl is not positive
+    TtlCache(std::size_t capacity,
+             Duration ttl,
+             const TClock& clock = TClock(),
+             const THash& hash = THash(),
+             const TEqual& equal = TEqual())
+        : mCapacity(capacity)
+        , mTtl(ttl)
+        , mResolution(std::max(ttl / typename Duration::rep(TicksPerTtl), Duration(1)))
+        , mIndex(capacity)
+        , mPrevious(new std::uint32_t[capacity + Buckets])
+        , mNext(new std::uint32_t[capacity + Buckets])
+        , mHashes(new std::uint32_t[capacity])
+        , mExpiry(new TimePoint[capacity])
+        , mKeys(new Optional<TKey>[capacity])
+        , mValues(new Optional<TValue>[capacity])
+        , mClock(clock)
+        , mHash(hash)
+        , mEqual(equal) {
+        if (capacity == 0) {
+            throw std::invalid_argument("The capacity of a TtlCache must not be zero");
+        }
+        if (ttl <= Duration::zero()) {
+            throw std::invalid_argument("The time to live of a TtlCache must be positive");
+        }
+        mTick = tick(mClock.now());
+        resetLinks();
+    }
+
+    TtlCache(const TtlCache&) = delete;
+    TtlCache& operator=(const TtlCache&) = delete;
+
+    /// The value of \p key if it is cached and has not expired yet
+    Optional<TValue&> get(const TKey& key) {
+        const std::uint32_t node = find(detail::mixHash(mHash(key)), key);
+        if (node == detail::NodeIndex::NotFound) {
+            return NullOptional;
+        }
+        if (mExpiry[node] <= mClock.now()) {
+            remove(node);
+            return NullOptional;
+        }
+        return *mValues[node];
+    }
+
+    /// Stores \p value under \p key for the default time to live
+    template <typename TArg>
+    TValue& put(const TKey& key, TArg&& value) {
+        return put(key, std::forward<TArg>(value), mTtl);
+    }
+
+    /// Stores \p value under \p key for \p ttl, replacing the value and the expiry time of the key
+    /// if it is cached
+    ///
+    /// \note If constructing the key or the value throws, nothing is added to the wheel; a full
+    ///       cache has already given up the entry that was closest to expiring.
+    /// \throw std::invalid_argument If \p ttl is not positive, as in the constructor
+    /// \return The stored value
+    template <typename TArg>
+    TValue& put(const TKey& key, TArg&& value, Duration ttl) {
+        if (ttl <= Duration::zero()) {
+            throw std::invalid_argument("The time to live of a TtlCache entry must be positive");
+        }
+        const TimePoint now = mClock.now();
+        advance(now);
+        const std::uint64_t hash = detail::mixHash(mHash(key));
+        std::uint32_t node = find(hash, key);
+        if (node != detail::NodeIndex::NotFound) {
+            mValues[node] = std::forward<TArg>(value);
+            unlink(node);
+        } else {
+            if (mSize == mCapacity) {
+                evictSoonest();
+            }
+            node = mFree;
+            mKeys[node].emplace(key);
+            try {
+                mValues[node].emplace(std::forward<TArg>(value));
+            } catch (...) {
+                mKeys[node].reset();
+                throw;
+            }
+            mFree = mNext[node];
+            mHashes[node] = std::uint32_t(hash);
+            mIndex.insert(hash, node);
+            ++mSize;
+        }
+        mExpiry[node] = now + ttl;
+        link(node, bucket(tick(mExpiry[node])));
+        return *mValues[node];
+    }
+
+    /// Removes \p key, returns false if it was not cached
+    bool erase(const TKey& key) {
+        const std::uint32_t node = find(detail::mixHash(mHash(key)), key);
+        if (node == detail::NodeIndex::NotFound) {
+            return false;
+        }
+        remove(node);
+        return true;
+    }
+
+    /// Advances the wheel to the current time, removing the entries that expired meanwhile
+    ///
+    /// \return The number of entries removed
+    std::size_t expire() {
+        const std::size_t before = mSize;
+        advance(mClock.now());
+        return before - mSize;
+    }
+
+    void clear() noexcept {
+        for (std::size_t i = 0; i < mCapacity; ++i) {
+            mKeys[i].reset();
+            mValues[i].reset();
+        }
+        mIndex.clear();
+        mSize = 0;
+        resetLinks();
+    }
+
+    /// Number of stored entries, including expired ones the wheel has not reached yet
+    std::size_t size() const noexcept { return mSize; }
+
+    bool empty() const noexcept { return mSize == 0; }
+
+    std::size_t capacity() const noexcept { return mCapacity; }
+
+    Duration ttl() const noexcept { return mTtl; }
+
+    /// Number of live entries put() has evicted because the cache was full
+    std::uint64_t evictions() const noexcept { return mEvictions; }
+
+    enum : std::size_t {
+        Buckets = 1024,   ///< Number of buckets of the timing wheel
+        TicksPerTtl = 256 ///< Wheel ticks per default time to live, entries stored with it never wrap
+    };
+
+private:
+    std::uint64_t tick(TimePoint time) const noexcept {
+        return std::uint64_t(time.time_since_epoch() / mResolution);
+    }
+
+    /// Index of the list head of the bucket of \p tick
+    std::uint32_t bucket(std::uint64_t tick) const noexcept {
+        return std::uint32_t(mCapacity + (tick & (Buckets - 1)));
+    }
+
+    std::uint32_t find(std::uint64_t hash, const TKey& key) const {
+        return mIndex.find(hash, [this, &key](std::uint32_t node) { return mEqual(*mKeys[node], key); });
+    }
+
+    /// Empties the buckets of all ticks that ended before \p now, each bucket is visited at most
+    /// once however much time passed
+    void advance(TimePoint now) {
+        const std::uint64_t current = tick(now);
+        const std::uint64_t last = current - mTick > Buckets ? mTick + Buckets : current;
+        for (; mTick < last; ++mTick) {
+            const std::uint32_t head = bucket(mTick);
+            for (std::uint32_t node = mNext[head]; node != head;) {
+                const std::uint32_t next = mNext[node];
+                // Entries more than a wheel turn away share the bucket and stay
+                if (mExpiry[node] <= now) {
+                    remove(node);
+                }
+                node = next;
+            }
+        }
+        mTick = current;
+    }
+
+    /// Evicts the head of the first non-empty bucket, starting at the current tick
+    void evictSoonest() {
+        for (std::uint64_t t = mTick;; ++t) {
+            const std::uint32_t head = bucket(t);
+            if (mNext[head] != head) {
+                remove(mNext[head]);
+                ++mEvictions;
+                return;
+            }
+        }
+    }
+
+    void resetLinks() noexcept {
+        for (std::size_t i = 0; i < Buckets; ++i) {
+            mPrevious[mCapacity + i] = std::uint32_t(mCapacity + i);
+            mNext[mCapacity + i] = std::uint32_t(mCapacity + i);
+        }
+        for (std::size_t i = 0; i < mCapacity; ++i) {
+            mNext[i] = std::uint32_t(i + 1);
+        }
+        mFree = 0;
+    }
+
+    /// Inserts \p node at the end of the list headed by \p head
+    void link(std::uint32_t node, std::uint32_t head) noexcept {
+        const std::uint32_t previous = mPrevious[head];
+        mPrevious[node] = previous;
+        mNext[node] = head;
+        mNext[previous] = node;
+        mPrevious[head] = node;
+    }
+
+    void unlink(std::uint32_t node) noexcept {
+        mNext[mPrevious[node]] = mNext[node];
+        mPrevious[mNext[node]] = mPrevious[node];
+    }
+
+    /// Returns \p node to the free list
+    void remove(std::uint32_t node) noexcept {
+        unlink(node);
+        mIndex.erase(mHashes[node], node);
+        mKeys[node].reset();
+        mValues[node].reset();
+        mNext[node] = mFree;
+        mFree = node;
+        --mSize;
+    }
+
+    const std::size_t mCapacity;
+    const Duration mTtl;
+    const Duration mResolution;
+    detail::NodeIndex mIndex;
+    std::unique_ptr<std::uint32_t[]> mPrevious;
+    std::unique_ptr<std::uint32_t[]> mNext;
+    std::unique_ptr<std::uint32_t[]> mHashes;
+    std::unique_ptr<TimePoint[]> mExpiry;
+    std::unique_ptr<Optional<TKey>[]> mKeys;
+    std::unique_ptr<Optional<TValue>[]> mValues;
+    std::uint64_t mTick = 0;
+    std::uint32_t mFree = 0;
+    std::size_t mSize = 0;
+    std::uint64_t mEvictions = 0;
+    TClock mClock;
+    THash mHash;
+    TEqual mEqual;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_TTL_CACHE_HPP_
@@ -0,0 +1,152 @@
+#ifndef UTILS_WORK_STEALING_DEQUE_HPP_
+#define UTILS_WORK_STEALING_DEQUE_HPP_
+
+#include "lib-optional/concurrency.hpp"
+#include "lib-optional/optional.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace libOptional {
+
+/// Lock-free Chase-Lev work-stealing deque
+///
+/// The owning thread pushes and pops at the bottom like a stack, any other thread steals from
+/// the top. The implementation follows the C11 formulation by Lê, Pop, Cohen and Zappa Nardelli
+/// ("Correct and Efficient Work-Stealing for Weak Memory Models", PPoPP 2013). The circular
+/// storage doubles when full; replaced arrays are kept until the deque is destroyed because a
+/// thief may still be reading from them.
+///
+/// \note A thief reads the element before it knows whether it won the race for it, so T must be
+///       trivially copyable, typically a pointer to a task.
+template <typename T>
+class WorkStealingDeque final {
+public:
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "The underlying type of WorkStealingDeque must be trivially copyable");
+
+    using ValueType = T;
+    using value_type = ValueType; // std traits
+
+    /// \param capacity Initial capacity, rounded up to a power of two
+    explicit WorkStealingDeque(std::size_t capacity = 64) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        mArrays.emplace_back(new Array(size));
+        mArray.store(mArrays.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /// Owner only, adds \p value at the bottom, growing the storage if needed
+    void push(const T& value) {
+        const std::int64_t bottom = mBottom.load(std::memory_order_relaxed);
+        const std::int64_t top = mTop.load(std::memory_order_acquire);
+        Array* array = mArray.load(std::memory_order_relaxed);
+        if (bottom - top > std::int64_t(array->mask)) {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /// Owner only, removes the most recently pushed element
+    Optional<T> pop() {
+        const std::int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        Array* array = mArray.load(std::memory_order_relaxed);
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = mTop.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return NullOptional;
+        }
+        Optional<T> result = array->get(bottom);
+        if (top == bottom) {
+            // The last element, a thief may be taking it at the same time
+            if (!mTop.compare_exchange_strong(
+                    top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                result.reset();
+            }
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    /// Any thread, removes the least recently pushed element
+    ///
+    /// \return Empty if the deque is empty or another thread took the element first
+    Optional<T> steal() {
+        std::int64_t top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = mBottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return NullOptional;
+        }
+        // Acquire instead of consume, which compilers implement as acquire anyway
+        const Array* array = mArray.load(std::memory_order_acquire);
+        Optional<T> result = array->get(top);
+        if (!mTop.compare_exchange_strong(
+                top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return NullOptional;
+        }
+        return result;
+    }
+
+    /// Number of elements, only a snapshot while other threads are active
+    std::size_t sizeApprox() const noexcept {
+        const std::int64_t bottom = mBottom.load(std::memory_order_relaxed);
+        const std::int64_t top = mTop.load(std::memory_order_relaxed);
+        return bottom > top ? std::size_t(bottom - top) : 0;
+    }
+
+    bool emptyApprox() const noexcept { return sizeApprox() == 0; }
+
+    std::size_t capacity() const noexcept { return mArray.load(std::memory_order_relaxed)->mask + 1; }
+
+private:
+    struct Array {
+        explicit Array(std::size_t size)
+            : mask(size - 1)
+            , slots(new std::atomic<T>[size]) {}
+
+        T get(std::int64_t index) const noexcept {
+            return slots[std::size_t(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t index, const T& value) noexcept {
+            slots[std::size_t(index) & mask].store(value, std::memory_order_relaxed);
+        }
+
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Array* grow(const Array* array, std::int64_t top, std::int64_t bottom) {
+        std::unique_ptr<Array> bigger(new Array(2 * (array->mask + 1)));
+        for (std::int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, array->get(i));
+        }
+        mArrays.push_back(std::move(bigger));
+        Array* result = mArrays.back().get();
+        mArray.store(result, std::memory_order_release);
+        return result;
+    }
+
+    alignas(detail::CacheLineSize) std::atomic<std::int64_t> mTop{ 0 };
+    alignas(detail::CacheLineSize) std::atomic<std::int64_t> mBottom{ 0 };
+    std::atomic<Array*> mArray{ nullptr };
+    std::vector<std::unique_ptr<Array>> mArrays;
+};
+
+} // namespace libOptional
+
+#endif // UTILS_WORK_STEALING_DEQUE_HPP_
@@ -0,0 +1,122 @@
+#include "lib-optional/kernels.hpp"
+
+#include <gmock/gmock.h>
+#include <random>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+std::vector<std::uint64_t> bitmapOf(std::size_t size, double density, unsigned seed) {
+    std::vector<std::uint64_t> bitmap(detail::wordCount(size));
+    std::mt19937 random(seed);
+    std::bernoulli_distribution engaged(density);
+    for (std::size_t i = 0; i < size; ++i) {
+        if (engaged(random)) {
+            detail::setBit(bitmap.data(), i);
+        }
+    }
+    return bitmap;
+}
+
+std::vector<int> valuesOf(std::size_t size) {
+    std::vector<int> values(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        values[i] = int(i * 7919 % 1000) - 500;
+    }
+    return values;
+}
+
+} // namespace
+
+TEST(AdaptiveValidityTest, picksSmallestForm) {
+    const std::size_t size = 10000;
+    std::vector<std::uint64_t> full(detail::wordCount(size), ~std::uint64_t(0));
+    std::vector<std::uint64_t> empty(detail::wordCount(size), 0);
+    EXPECT_EQ(AdaptiveValidity::encode(full.data(), size).kind(), AdaptiveValidity::Kind::AllValid);
+    EXPECT_EQ(AdaptiveValidity::encode(nullptr, size).kind(), AdaptiveValidity::Kind::AllValid);
+    EXPECT_EQ(AdaptiveValidity::encode(empty.data(), size).kind(), AdaptiveValidity::Kind::AllNull);
+    EXPECT_EQ(AdaptiveValidity::encode(full.data(), size).byteSize(), 0u);
+
+    AdaptiveValidity sparse = AdaptiveValidity::encode(bitmapOf(size, 0.001, 1).data(), size);
+    EXPECT_EQ(sparse.kind(), AdaptiveValidity::Kind::Runs);
+    AdaptiveValidity dense = AdaptiveValidity::encode(bitmapOf(size, 0.999, 2).data(), size);
+    EXPECT_EQ(dense.kind(), AdaptiveValidity::Kind::Runs);
+    EXPECT_LT(dense.byteSize(), size / 8);
+    AdaptiveValidity mixed = AdaptiveValidity::encode(bitmapOf(size, 0.5, 3).data(), size);
+    EXPECT_EQ(mixed.kind(), AdaptiveValidity::Kind::Bitmap);
+}
+
+TEST(AdaptiveValidityTest, roundTrip) {
+    for (double density : { 0.0, 0.001, 0.3, 0.999, 1.0 }) {
+        for (std::size_t size : { std::size_t(1), std::size_t(63), std::size_t(64), std::size_t(1000) }) {
+            std::vector<std::uint64_t> bitmap = bitmapOf(size, density, unsigned(size));
+            AdaptiveValidity validity = AdaptiveValidity::encode(bitmap.data(), size);
+            EXPECT_EQ(validity.size(), size);
+            EXPECT_EQ(validity.validCount(), detail::countSetBits(bitmap.data(), size));
+            for (std::size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(validity.isValid(i), detail::testBit(bitmap.data(), i)) << i;
+            }
+            std::vector<std::uint64_t> decoded(bitmap.size(), 0x5555);
+            validity.toBitmap(decoded.data());
+            bitmap.back() &= detail::lowMask(size - (bitmap.size() - 1) * 64);
+            EXPECT_EQ(decoded, bitmap);
+        }
+    }
+}
+
+TEST(AdaptiveValidityTest, runsAcrossWords) {
+    std::vector<std::uint64_t> bitmap(16, 0);
+    for (std::size_t i = 60; i < 130; ++i) {
+        detail::setBit(bitmap.data(), i);
+    }
+    detail::setBit(bitmap.data(), 1023);
+    AdaptiveValidity validity = AdaptiveValidity::encode(bitmap.data(), 1024);
+    ASSERT_EQ(validity.kind(), AdaptiveValidity::Kind::Runs);
+    ASSERT_EQ(validity.runs().size(), 2u);
+    EXPECT_EQ(validity.runs()[0].start, 60u);
+    EXPECT_EQ(validity.runs()[0].length, 70u);
+    EXPECT_EQ(validity.runs()[1].start, 1023u);
+    EXPECT_EQ(validity.runs()[1].length, 1u);
+}
+
+TEST(AdaptiveValidityTest, kernelsMatchBitmap) {
+    const std::size_t size = 5000;
+    const std::vector<int> values = valuesOf(size);
+    for (double density : { 0.0, 0.001, 0.5, 0.999, 1.0 }) {
+        std::vector<std::uint64_t> bitmap = bitmapOf(size, density, 11);
+        OptionalSpan<int> span(values.data(), bitmap.data(), size);
+        AdaptiveValidity validity = AdaptiveValidity::encode(span);
+
+        EXPECT_EQ(countValid(validity), countValid(span));
+        EXPECT_EQ(countNull(validity), countNull(span));
+        EXPECT_EQ((sum<int, long>(values.data(), validity)), (sum<int, long>(span)));
+        EXPECT_EQ(min(values.data(), validity), min(span));
+        EXPECT_EQ(max(values.data(), validity), max(span));
+
+        std::vector<std::uint64_t> expected(bitmap.size()), actual(bitmap.size(), ~std::uint64_t(0));
+        auto positive = [](int value) { return value > 0; };
+        EXPECT_EQ(filter(values.data(), validity, positive, actual.data()),
+                  filter(span, positive, expected.data()));
+        EXPECT_EQ(actual, expected);
+
+        std::size_t visited = 0;
+        forEachValid(values.data(), validity, [&](std::size_t i, int value) {
+            EXPECT_TRUE(span.isValid(i));
+            EXPECT_EQ(value, values[i]);
+            ++visited;
+        });
+        EXPECT_EQ(visited, countValid(span));
+    }
+}
+
+TEST(AdaptiveValidityTest, allNullSkipsValues) {
+    AdaptiveValidity validity = AdaptiveValidity::allNull(1000);
+    const int* values = nullptr;
+    EXPECT_EQ(sum(values, validity, 5), 5);
+    EXPECT_FALSE(min(values, validity));
+    std::vector<std::uint64_t> selection(detail::wordCount(1000), ~std::uint64_t(0));
+    EXPECT_EQ(filter(values, validity, [](int) { return true; }, selection.data()), 0u);
+    EXPECT_EQ(detail::countSetBits(selection.data(), 1000), 0u);
+}
@@ -0,0 +1,136 @@
+#include "lib-optional/arrow.hpp"
+#include "lib-optional/kernels.hpp"
+
+#include <gmock/gmock.h>
+#include <cstring>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+std::vector<Optional<std::int64_t>> sample(std::size_t size) {
+    std::vector<Optional<std::int64_t>> result;
+    for (std::size_t i = 0; i < size; ++i) {
+        result.push_back(i % 3 == 0 ? Optional<std::int64_t>() : Optional<std::int64_t>(std::int64_t(i)));
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(ArrowTest, exportSchema) {
+    ArrowSchema schema;
+    exportArrowSchema<double>(&schema, "price");
+    EXPECT_STREQ(schema.format, "g");
+    EXPECT_STREQ(schema.name, "price");
+    EXPECT_EQ(schema.flags, ARROW_FLAG_NULLABLE);
+    EXPECT_EQ(schema.n_children, 0);
+    ASSERT_NE(schema.release, nullptr);
+    schema.release(&schema);
+    EXPECT_EQ(schema.release, nullptr);
+}
+
+TEST(ArrowTest, exportMovesBuffersWithoutCopying) {
+    std::vector<int> values = { 1, 2, 3, 4 };
+    std::vector<std::uint64_t> validity = { 0xB };
+    const int* data = values.data();
+    ArrowArray array;
+    exportArrow(std::move(values), std::move(validity), &array);
+    EXPECT_EQ(array.length, 4);
+    EXPECT_EQ(array.null_count, 1);
+    EXPECT_EQ(array.offset, 0);
+    ASSERT_EQ(array.n_buffers, 2);
+    EXPECT_EQ(array.buffers[1], data);
+    EXPECT_EQ(*static_cast<const std::uint8_t*>(array.buffers[0]), 0xB);
+    array.release(&array);
+    EXPECT_EQ(array.release, nullptr);
+}
+
+TEST(ArrowTest, exportSpanKeepsOwnerAlive) {
+    std::shared_ptr<std::vector<double>> owner = std::make_shared<std::vector<double>>(100, 1.5);
+    ArrowArray array;
+    exportArrow(OptionalSpan<double>(owner->data(), nullptr, owner->size()), owner, &array);
+    EXPECT_EQ(array.null_count, 0);
+    EXPECT_EQ(array.buffers[0], nullptr);
+    EXPECT_EQ(owner.use_count(), 2);
+    array.release(&array);
+    EXPECT_EQ(owner.use_count(), 1);
+}
+
+TEST(ArrowTest, roundTrip) {
+    const std::vector<Optional<std::int64_t>> input = sample(200);
+    ArrowArray array;
+    ArrowSchema schema;
+    exportArrow(input, &array);
+    exportArrowSchema<std::int64_t>(&schema);
+    const void* buffer = array.buffers[1];
+    {
+        ImportedArrowArray<std::int64_t> imported(&array, &schema);
+        EXPECT_EQ(array.release, nullptr);
+        EXPECT_EQ(imported.span().values(), buffer);
+        ASSERT_EQ(imported.size(), input.size());
+        EXPECT_EQ(imported.nullCount(), 67u);
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            EXPECT_EQ(bool(imported[i]), bool(input[i]));
+            if (input[i]) {
+                EXPECT_EQ(*imported[i], *input[i]);
+            }
+        }
+        ImportedArrowArray<std::int64_t> moved(std::move(imported));
+        EXPECT_EQ(imported.size(), 0u);
+        EXPECT_EQ(countValid(moved.span()), 133u);
+    }
+    schema.release(&schema);
+}
+
+namespace {
+
+int gReleased = 0;
+
+/// Array produced by a "foreign" library, with an offset
+void foreignRelease(ArrowArray* array) {
+    ++gReleased;
+    array->release = nullptr;
+}
+
+} // namespace
+
+TEST(ArrowTest, importForeignArrayWithOffset) {
+    static const std::int32_t values[130] = {};
+    static std::uint64_t validity[3] = { 0, ~std::uint64_t(0), 0 };
+    const void* buffers[2] = { validity, values };
+    ArrowArray array;
+    std::memset(&array, 0, sizeof(array));
+    array.length = 66;
+    array.null_count = 2;
+    array.offset = 64;
+    array.n_buffers = 2;
+    array.buffers = buffers;
+    array.release = &foreignRelease;
+    gReleased = 0;
+    {
+        ImportedArrowArray<std::int32_t> imported(&array);
+        EXPECT_EQ(imported.span().values(), values + 64);
+        EXPECT_TRUE(imported[63]);
+        EXPECT_FALSE(imported[64]);
+        EXPECT_EQ(imported.nullCount(), 2u);
+    }
+    EXPECT_EQ(gReleased, 1);
+}
+
+TEST(ArrowTest, importRejectsUnsupportedArrays) {
+    ArrowArray array;
+    exportArrow(sample(10), &array);
+    ArrowSchema schema;
+    exportArrowSchema<double>(&schema);
+    EXPECT_THROW(ImportedArrowArray<std::int64_t>(&array, &schema), ArrowError);
+    EXPECT_NE(array.release, nullptr);
+
+    array.offset = 3;
+    EXPECT_THROW(ImportedArrowArray<std::int64_t>{ &array }, ArrowError);
+    array.offset = 0;
+    array.release(&array);
+    EXPECT_THROW(ImportedArrowArray<std::int64_t>{ &array }, ArrowError);
+    schema.release(&schema);
+}
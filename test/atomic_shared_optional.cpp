@@ -0,0 +1,119 @@
+#include "lib-optional/atomic_shared_optional.hpp"
+
+#include <gmock/gmock.h>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+std::atomic<int> gAlive{ 0 };
+
+/// Payload that counts its live instances and detects use after destruction
+struct Tracked {
+    explicit Tracked(int value)
+        : value(value)
+        , items(100, value) {
+        ++gAlive;
+    }
+
+    Tracked(const Tracked& other)
+        : value(other.value)
+        , items(other.items) {
+        ++gAlive;
+    }
+
+    ~Tracked() {
+        value = -1;
+        --gAlive;
+    }
+
+    bool consistent() const { return value >= 0 && items.front() == value && items.back() == value; }
+
+    int value;
+    std::vector<int> items;
+};
+
+} // namespace
+
+TEST(AtomicSharedOptionalTest, storeLoadReset) {
+    AtomicSharedOptional<std::map<std::string, int>> shared;
+    EXPECT_FALSE(shared.hasValue());
+    EXPECT_FALSE(shared.load());
+
+    shared.emplace(std::map<std::string, int>{ { "a", 1 } });
+    auto handle = shared.load();
+    ASSERT_TRUE(handle);
+    EXPECT_EQ(handle->at("a"), 1);
+    Optional<const std::map<std::string, int>&> view = handle;
+    ASSERT_TRUE(view);
+    EXPECT_EQ(&*view, &*handle);
+
+    shared.reset();
+    EXPECT_FALSE(shared.hasValue());
+    EXPECT_FALSE(shared.load());
+    EXPECT_EQ(handle->size(), 1u);
+}
+
+TEST(AtomicSharedOptionalTest, deferredReclamation) {
+    gAlive = 0;
+    {
+        AtomicSharedOptional<Tracked, 4> shared(Tracked(1));
+        auto first = shared.load();
+        shared.store(Tracked(2));
+        EXPECT_EQ(first->value, 1);
+        EXPECT_EQ(shared.load()->value, 2);
+        EXPECT_EQ(shared.retiredCount(), 1u);
+        EXPECT_EQ(gAlive.load(), 2);
+
+        first.release();
+        EXPECT_EQ(shared.collect(), 0u);
+        EXPECT_EQ(gAlive.load(), 1);
+
+        auto moved = shared.load();
+        auto target = std::move(moved);
+        EXPECT_FALSE(moved);
+        shared.reset();
+        EXPECT_EQ(target->value, 2);
+        EXPECT_EQ(shared.retiredCount(), 1u);
+    }
+    EXPECT_EQ(gAlive.load(), 0);
+}
+
+TEST(AtomicSharedOptionalTest, concurrentReadersAndWriter) {
+    gAlive = 0;
+    {
+        AtomicSharedOptional<Tracked, 8> shared(Tracked(0));
+        std::atomic<bool> done{ false };
+        std::atomic<int> errors{ 0 };
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&] {
+                while (!done.load(std::memory_order_acquire)) {
+                    auto handle = shared.load();
+                    if (handle && !handle->consistent()) {
+                        ++errors;
+                    }
+                }
+            });
+        }
+        for (int i = 1; i <= 5000; ++i) {
+            if (i % 10 == 0) {
+                shared.reset();
+            } else {
+                shared.emplace(i);
+            }
+        }
+        done.store(true, std::memory_order_release);
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        EXPECT_EQ(errors.load(), 0);
+        EXPECT_EQ(shared.collect(), 0u);
+    }
+    EXPECT_EQ(gAlive.load(), 0);
+}
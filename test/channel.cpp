@@ -0,0 +1,113 @@
+#include "lib-optional/channel.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <gmock/gmock.h>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+TEST(ChannelTest, sendReceive) {
+    Channel<std::unique_ptr<int>> channel;
+    EXPECT_FALSE(channel.tryReceive());
+    EXPECT_TRUE(channel.send(std::unique_ptr<int>(new int(1))));
+    EXPECT_TRUE(channel.emplace(new int(2)));
+    EXPECT_EQ(**channel.receive(), 1);
+    EXPECT_EQ(**channel.tryReceive(), 2);
+    EXPECT_FALSE(channel.tryReceive());
+}
+
+TEST(ChannelTest, receiveForTimesOut) {
+    Channel<int> channel(10);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(channel.receiveFor(std::chrono::milliseconds(20)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST(ChannelTest, closeDrainsThenReturnsEmpty) {
+    Channel<int> channel;
+    channel.send(1);
+    channel.close();
+    EXPECT_TRUE(channel.closed());
+    EXPECT_FALSE(channel.send(2));
+    EXPECT_EQ(*channel.receive(), 1);
+    EXPECT_FALSE(channel.receive());
+    EXPECT_FALSE(channel.receiveFor(std::chrono::hours(1)));
+}
+
+TEST(ChannelTest, closeWakesParkedReceiver) {
+    Channel<int> channel(0);
+    std::thread closer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        channel.close();
+    });
+    EXPECT_FALSE(channel.receive());
+    closer.join();
+}
+
+TEST(ChannelTest, receiveMany) {
+    Channel<int> channel;
+    for (int i = 0; i < 5; ++i) {
+        channel.send(i);
+    }
+    std::vector<int> out;
+    EXPECT_EQ(channel.receiveMany(std::back_inserter(out), 3, std::chrono::milliseconds(0)), 3u);
+    EXPECT_EQ(channel.receiveMany(std::back_inserter(out), 3, std::chrono::milliseconds(0)), 2u);
+    EXPECT_EQ(channel.receiveMany(std::back_inserter(out), 3, std::chrono::milliseconds(1)), 0u);
+    EXPECT_EQ(out, (std::vector<int>{ 0, 1, 2, 3, 4 }));
+}
+
+TEST(ChannelTest, manyProducersKeepPerProducerOrder) {
+    Channel<std::pair<int, int>> channel(50);
+    const int producers = 4, count = 20000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < count; ++i) {
+                channel.send(std::make_pair(p, i));
+            }
+        });
+    }
+    std::vector<int> next(producers, 0);
+    std::vector<std::pair<int, int>> batch;
+    for (int received = 0; received < producers * count;) {
+        batch.clear();
+        received += int(channel.receiveMany(std::back_inserter(batch), 64, std::chrono::seconds(10)));
+        for (const std::pair<int, int>& message : batch) {
+            ASSERT_EQ(message.second, next[message.first]++);
+        }
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(channel.tryReceive());
+}
+
+TEST(ChannelTest, closeWhileSendingKeepsAcceptedMessages) {
+    for (int round = 0; round < 50; ++round) {
+        Channel<int> channel(10);
+        const int producers = 4;
+        std::atomic<int> accepted{ 0 };
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&channel, &accepted] {
+                while (channel.send(1)) {
+                    accepted.fetch_add(1);
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        channel.close();
+        int received = 0;
+        while (channel.receive()) {
+            ++received;
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQ(received, accepted.load());
+    }
+}
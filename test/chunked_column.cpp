@@ -0,0 +1,112 @@
+#include "lib-optional/chunked_column.hpp"
+#include "lib-optional/kernels.hpp"
+
+#include <gmock/gmock.h>
+#include <string>
+
+using namespace libOptional;
+
+TEST(ChunkedColumnTest, appendAndAccess) {
+    ChunkedColumn<int, 64> column;
+    EXPECT_TRUE(column.empty());
+
+    for (int i = 0; i < 200; ++i) {
+        if (i % 3 == 0) {
+            column.appendNull();
+        } else {
+            column.append(i);
+        }
+    }
+    EXPECT_EQ(column.size(), 200u);
+    EXPECT_EQ(column.chunkCount(), 4u);
+
+    for (int i = 0; i < 200; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_FALSE(column[i]);
+        } else {
+            ASSERT_TRUE(column[i]);
+            EXPECT_EQ(*column[i], i);
+        }
+    }
+}
+
+TEST(ChunkedColumnTest, appendOptional) {
+    ChunkedColumn<std::string, 64> column;
+    column.append(Optional<std::string>("a"));
+    column.append(Optional<std::string>());
+    column.append(std::string("c"));
+    ASSERT_EQ(column.size(), 3u);
+    EXPECT_EQ(*column[0], "a");
+    EXPECT_FALSE(column[1]);
+    EXPECT_EQ(*column[2], "c");
+
+    *column[2] = "d";
+    EXPECT_EQ(*column[2], "d");
+}
+
+TEST(ChunkedColumnTest, stableAddresses) {
+    ChunkedColumn<int, 64> column;
+    const int& first = column.emplaceBack(1);
+    for (int i = 0; i < 10000; ++i) {
+        column.append(i);
+    }
+    EXPECT_EQ(&first, &*column[0]);
+    EXPECT_EQ(first, 1);
+}
+
+TEST(ChunkedColumnTest, reserve) {
+    ChunkedColumn<int, 64> column;
+    column.reserve(130);
+    EXPECT_EQ(column.capacity(), 192u);
+    EXPECT_EQ(column.size(), 0u);
+    EXPECT_EQ(column.chunkCount(), 0u);
+}
+
+TEST(ChunkedColumnTest, chunks) {
+    ChunkedColumn<int, 64> column;
+    for (int i = 0; i < 100; ++i) {
+        column.append(i % 2 == 0 ? Optional<int>(i) : Optional<int>());
+    }
+
+    EXPECT_EQ(column.chunk(0).size(), 64u);
+    EXPECT_EQ(column.chunk(1).size(), 36u);
+
+    std::size_t valid = 0;
+    long total = 0;
+    column.forEachChunk([&](const OptionalSpan<int>& chunk) {
+        valid += countValid(chunk);
+        total += sum<int, long>(chunk);
+    });
+    EXPECT_EQ(valid, 50u);
+    EXPECT_EQ(total, 2450);
+}
+
+TEST(ChunkedColumnTest, truncate) {
+    ChunkedColumn<int, 64> column;
+    for (int i = 0; i < 100; ++i) {
+        column.append(i);
+    }
+    column.truncate(70);
+    EXPECT_EQ(column.size(), 70u);
+    EXPECT_EQ(*column[69], 69);
+    column.appendNull();
+    EXPECT_FALSE(column[70]);
+    column.truncate(200);
+    EXPECT_EQ(column.size(), 71u);
+}
+
+TEST(ChunkedColumnTest, clearAndMove) {
+    ChunkedColumn<int, 64> column;
+    column.append(1);
+    column.append(2);
+    column.clear();
+    EXPECT_TRUE(column.empty());
+    EXPECT_EQ(column.capacity(), 64u);
+    column.appendNull();
+    EXPECT_FALSE(column[0]);
+
+    ChunkedColumn<int, 64> other(std::move(column));
+    EXPECT_EQ(other.size(), 1u);
+    EXPECT_EQ(column.size(), 0u);
+    EXPECT_EQ(column.capacity(), 0u);
+}
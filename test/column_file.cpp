@@ -0,0 +1,143 @@
+#include "lib-optional/chunked_column.hpp"
+#include "lib-optional/column_file.hpp"
+#include "lib-optional/kernels.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+#include <string>
+
+using namespace libOptional;
+
+namespace {
+
+class ColumnFileTest : public ::testing::Test {
+protected:
+    virtual void SetUp() override {
+        mPath = ::testing::TempDir() + "lib-optional-column-file-" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    virtual void TearDown() override { std::remove(mPath.c_str()); }
+
+    const std::string& path() const { return mPath; }
+
+private:
+    std::string mPath;
+};
+
+ChunkedColumn<std::int64_t, 64> makeColumn(std::size_t rows) {
+    ChunkedColumn<std::int64_t, 64> column;
+    for (std::size_t i = 0; i < rows; ++i) {
+        column.append(i % 4 == 0 ? Optional<std::int64_t>() : Optional<std::int64_t>(std::int64_t(i) * 3));
+    }
+    return column;
+}
+
+} // namespace
+
+TEST_F(ColumnFileTest, roundTrip) {
+    const ChunkedColumn<std::int64_t, 64> column = makeColumn(1000);
+    writeColumnFile(path(), column, 128);
+
+    MappedColumn<std::int64_t> mapped(path());
+    ASSERT_EQ(mapped.size(), 1000u);
+    EXPECT_EQ(mapped.blockRows(), 128u);
+    EXPECT_EQ(mapped.blockCount(), 8u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mapped.span().values()) % 4096, 0u);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(mapped.span()[i], column[i]);
+    }
+    EXPECT_EQ(countValid(mapped.span()), 750u);
+    EXPECT_EQ(mapped.block(7).size(), 104u);
+    EXPECT_EQ(*mapped.block(7)[1], 897 * 3);
+    EXPECT_TRUE(mapped.verify());
+}
+
+TEST_F(ColumnFileTest, fromSpan) {
+    const double values[] = { 1.5, 0.0, 2.5 };
+    const std::uint64_t validity[] = { 0x5 };
+    writeColumnFile(path(), OptionalSpan<double>(values, validity, 3), 64);
+
+    MappedColumn<double> mapped(path());
+    EXPECT_EQ(*mapped.span()[0], 1.5);
+    EXPECT_FALSE(mapped.span()[1]);
+    EXPECT_EQ(*mapped.span()[2], 2.5);
+}
+
+TEST_F(ColumnFileTest, empty) {
+    writeColumnFile(path(), OptionalSpan<int>(), 64);
+    MappedColumn<int> mapped(path());
+    EXPECT_EQ(mapped.size(), 0u);
+    EXPECT_EQ(mapped.blockCount(), 0u);
+    EXPECT_TRUE(mapped.verify());
+}
+
+TEST_F(ColumnFileTest, corruptedBlock) {
+    writeColumnFile(path(), makeColumn(1000), 128);
+    {
+        MappedColumn<std::int64_t> mapped(path());
+        const std::size_t offset = std::size_t(mapped.header().valuesOffset) + 300 * sizeof(std::int64_t);
+        std::fstream file(path(), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(std::streamoff(offset));
+        file.put('x');
+    }
+    MappedColumn<std::int64_t> mapped(path());
+    EXPECT_TRUE(mapped.verifyBlock(0));
+    EXPECT_TRUE(mapped.verifyBlock(1));
+    EXPECT_FALSE(mapped.verifyBlock(2));
+    EXPECT_TRUE(mapped.verifyBlock(3));
+    EXPECT_FALSE(mapped.verify());
+}
+
+TEST_F(ColumnFileTest, invalidFiles) {
+    EXPECT_THROW(MappedColumn<int>{ path() }, std::system_error);
+
+    {
+        std::ofstream file(path(), std::ios::binary);
+        file << std::string(200, 'x');
+    }
+    EXPECT_THROW(MappedColumn<int>{ path() }, ColumnFileError);
+
+    writeColumnFile(path(), makeColumn(10), 64);
+    EXPECT_THROW(MappedColumn<int>{ path() }, ColumnFileError);
+    EXPECT_NO_THROW(MappedColumn<std::int64_t>{ path() });
+
+    EXPECT_THROW(writeColumnFile(path(), makeColumn(10), 100), ColumnFileError);
+}
+
+TEST_F(ColumnFileTest, hostileLayout) {
+    writeColumnFile(path(), makeColumn(10), 64);
+    ColumnFileHeader header;
+    {
+        std::ifstream file(path(), std::ios::binary);
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    }
+    // The layout the unchecked arithmetic derives from these rows wraps around to a tiny file
+    header.rows = ~std::uint64_t(0) - 31;
+    header.validityOffset = 3840;
+    header.checksumsOffset = 3840;
+    header.fileSize = 3840;
+    header.headerChecksum = detail::headerChecksum(header);
+    {
+        std::fstream file(path(), std::ios::in | std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    EXPECT_THROW(MappedColumn<std::int64_t>{ path() }, ColumnFileError);
+    EXPECT_THROW(detail::makeColumnFileHeader(8, header.rows, 64), ColumnFileError);
+    // A block larger than the column still has its one checksum
+    const ColumnFileHeader oneBlock = detail::makeColumnFileHeader(1, 100, ~std::uint64_t(0) - 63);
+    EXPECT_EQ(oneBlock.fileSize, oneBlock.checksumsOffset + 8);
+}
+
+TEST_F(ColumnFileTest, rewriteKeepsExistingMappings) {
+    writeColumnFile(path(), makeColumn(1000), 128);
+    MappedColumn<std::int64_t> before(path());
+    writeColumnFile(path(), makeColumn(10), 64);
+    // The old mapping still sees the old file rather than a truncated one
+    EXPECT_EQ(before.size(), 1000u);
+    EXPECT_EQ(*before.span()[999], 999 * 3);
+    EXPECT_TRUE(before.verify());
+    EXPECT_EQ(MappedColumn<std::int64_t>(path()).size(), 10u);
+    EXPECT_FALSE(std::ifstream(path() + ".tmp").good());
+}
@@ -0,0 +1,115 @@
+#include "lib-optional/chunked_column.hpp"
+#include "lib-optional/column_stream.hpp"
+#include "lib-optional/kernels.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+#include <string>
+
+using namespace libOptional;
+
+namespace {
+
+class ColumnFileStreamTest : public ::testing::Test {
+protected:
+    virtual void SetUp() override {
+        mPath = ::testing::TempDir() + "lib-optional-column-stream-" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        ChunkedColumn<std::int32_t, 64> column;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            column.append(i % 3 == 0 ? Optional<std::int32_t>() : Optional<std::int32_t>(std::int32_t(i)));
+        }
+        writeColumnFile(mPath, column, 128);
+    }
+
+    virtual void TearDown() override { std::remove(mPath.c_str()); }
+
+    const std::string& path() const { return mPath; }
+
+private:
+    std::string mPath;
+};
+
+} // namespace
+
+TEST_F(ColumnFileStreamTest, readsAllBlocks) {
+    ColumnFileStream<std::int32_t> stream(path());
+    EXPECT_EQ(stream.size(), 1000u);
+    EXPECT_EQ(stream.blockCount(), 8u);
+
+    std::size_t rows = 0;
+    std::size_t blocks = 0;
+    while (Optional<OptionalSpan<std::int32_t>> block = stream.next()) {
+        for (std::size_t i = 0; i < block->size(); ++i) {
+            const std::size_t row = rows + i;
+            if (row % 3 == 0) {
+                EXPECT_FALSE((*block)[i]);
+            } else {
+                EXPECT_EQ(*(*block)[i], std::int32_t(row));
+            }
+        }
+        rows += block->size();
+        ++blocks;
+    }
+    EXPECT_EQ(rows, 1000u);
+    EXPECT_EQ(blocks, 8u);
+    EXPECT_FALSE(stream.next());
+}
+
+TEST_F(ColumnFileStreamTest, abandonEarly) {
+    ColumnFileStream<std::int32_t> stream(path());
+    Optional<OptionalSpan<std::int32_t>> block = stream.next();
+    ASSERT_TRUE(block);
+    EXPECT_EQ(countValid(*block), 85u);
+}
+
+TEST_F(ColumnFileStreamTest, corruptedBlock) {
+    {
+        ColumnFileStream<std::int32_t> stream(path());
+        std::fstream file(path(), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(std::streamoff(stream.header().valuesOffset + 500 * sizeof(std::int32_t)));
+        file.put('x');
+    }
+
+    ColumnFileStream<std::int32_t> stream(path());
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(stream.next());
+    }
+    EXPECT_THROW(stream.next(), ColumnFileError);
+
+    ColumnFileStream<std::int32_t> unverified(path(), false);
+    std::size_t blocks = 0;
+    while (unverified.next()) {
+        ++blocks;
+    }
+    EXPECT_EQ(blocks, 8u);
+}
+
+TEST_F(ColumnFileStreamTest, wrongType) {
+    EXPECT_THROW(ColumnFileStream<std::int64_t>{ path() }, ColumnFileError);
+}
+
+TEST_F(ColumnFileStreamTest, hugeBlocksInSmallFile) {
+    ColumnFileHeader header;
+    {
+        std::ifstream file(path(), std::ios::binary);
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    }
+    // A valid layout whose single block claims 2^40 rows, the buffers must follow the 1000 rows
+    header.blockRows = std::uint64_t(1) << 40;
+    header.fileSize = header.checksumsOffset + 8;
+    header.headerChecksum = detail::headerChecksum(header);
+    {
+        std::fstream file(path(), std::ios::in | std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    ColumnFileStream<std::int32_t> stream(path(), false);
+    EXPECT_EQ(stream.blockCount(), 1u);
+    Optional<OptionalSpan<std::int32_t>> block = stream.next();
+    ASSERT_TRUE(block);
+    ASSERT_EQ(block->size(), 1000u);
+    EXPECT_EQ(*(*block)[998], 998);
+    EXPECT_FALSE((*block)[999]);
+    EXPECT_FALSE(stream.next());
+}
@@ -0,0 +1,104 @@
+#include "lib-optional/concurrent_column.hpp"
+#include "lib-optional/kernels.hpp"
+
+#include <gmock/gmock.h>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+TEST(ConcurrentColumnTest, append) {
+    ConcurrentColumn<int> column(100);
+    EXPECT_EQ(column.capacity(), 100u);
+    EXPECT_EQ(column.size(), 0u);
+
+    EXPECT_TRUE(column.append(Optional<int>(1)));
+    EXPECT_TRUE(column.append(Optional<int>()));
+    std::vector<Optional<int>> rows = { 3, NullOptional, 5 };
+    EXPECT_TRUE(column.append(rows.begin(), rows.end()));
+
+    ASSERT_EQ(column.size(), 5u);
+    EXPECT_EQ(*column[0], 1);
+    EXPECT_FALSE(column[1]);
+    EXPECT_EQ(*column[2], 3);
+    EXPECT_FALSE(column[3]);
+    EXPECT_EQ(*column[4], 5);
+    EXPECT_EQ(countValid(column.view()), 3u);
+}
+
+TEST(ConcurrentColumnTest, reserveAndCommit) {
+    ConcurrentColumn<int> column(10);
+    Optional<std::size_t> first = column.reserve(3);
+    Optional<std::size_t> second = column.reserve(2);
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_EQ(*first, 0u);
+    EXPECT_EQ(*second, 3u);
+
+    column.set(*first, 7);
+    column.set(*first + 2, Optional<int>(9));
+    column.commit(*first, 3);
+    EXPECT_EQ(column.size(), 3u);
+    EXPECT_EQ(*column[0], 7);
+    EXPECT_FALSE(column[1]);
+    EXPECT_EQ(*column[2], 9);
+
+    column.commit(*second, 2);
+    EXPECT_EQ(column.size(), 5u);
+}
+
+TEST(ConcurrentColumnTest, commitOutOfOrder) {
+    ConcurrentColumn<int> column(200);
+    Optional<std::size_t> first = column.reserve(70);
+    Optional<std::size_t> second = column.reserve(100);
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+
+    column.commit(*second, 100);
+    EXPECT_EQ(column.size(), 0u);
+    column.commit(*first, 70);
+    EXPECT_EQ(column.size(), 170u);
+}
+
+TEST(ConcurrentColumnTest, full) {
+    ConcurrentColumn<int> column(3);
+    EXPECT_TRUE(column.append(Optional<int>(1)));
+    EXPECT_FALSE(column.reserve(3));
+    EXPECT_EQ(column.size(), 1u);
+}
+
+TEST(ConcurrentColumnTest, failedReserveKeepsRemainingSlots) {
+    ConcurrentColumn<int> column(6);
+    EXPECT_EQ(*column.reserve(4), 0u);
+    EXPECT_FALSE(column.reserve(4));
+    EXPECT_FALSE(column.reserve(std::size_t(-1)));
+    EXPECT_EQ(*column.reserve(2), 4u);
+    EXPECT_FALSE(column.reserve(1));
+}
+
+TEST(ConcurrentColumnTest, concurrentProducers) {
+    const std::size_t producers = 4;
+    const std::size_t batches = 500;
+    const std::size_t batchSize = 10;
+    ConcurrentColumn<long> column(producers * batches * batchSize);
+
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&column, p] {
+            std::vector<Optional<long>> rows(batchSize);
+            for (std::size_t b = 0; b < batches; ++b) {
+                for (std::size_t i = 0; i < batchSize; ++i) {
+                    rows[i] = i % 2 == 0 ? Optional<long>(long(p)) : Optional<long>();
+                }
+                ASSERT_TRUE(column.append(rows.begin(), rows.end()));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(column.size(), producers * batches * batchSize);
+    EXPECT_EQ(countValid(column.view()), column.size() / 2);
+    EXPECT_EQ(sum(column.view()), long(batches * batchSize / 2 * (0 + 1 + 2 + 3)));
+}
@@ -0,0 +1,155 @@
+#include "lib-optional/csv_reader.hpp"
+
+#include <gmock/gmock.h>
+#include <cmath>
+#include <fstream>
+#include <string>
+
+using namespace libOptional;
+
+namespace {
+
+CsvStats load(const std::string& text,
+              ChunkedColumn<std::int64_t>& ints,
+              ChunkedColumn<double>& doubles,
+              const CsvOptions& options = CsvOptions()) {
+    std::vector<CsvColumn> columns = { CsvColumn::int64(ints), CsvColumn::float64(doubles) };
+    return loadCsv(text.data(), text.size(), columns, options);
+}
+
+double parsedDouble(const std::string& text) {
+    double value = 0.0;
+    EXPECT_TRUE(detail::parseDouble(text.data(), text.data() + text.size(), value)) << text;
+    return value;
+}
+
+} // namespace
+
+TEST(CsvReaderTest, emptyFieldsAreDisengaged) {
+    ChunkedColumn<std::int64_t> ints;
+    ChunkedColumn<double> doubles;
+    const CsvStats stats = load("id,price\n1,2.5\n,3\n-7,\n,\n", ints, doubles);
+    EXPECT_EQ(stats.rows, 4u);
+    ASSERT_EQ(ints.size(), 4u);
+    ASSERT_EQ(doubles.size(), 4u);
+    EXPECT_EQ(*ints[0], 1);
+    EXPECT_FALSE(ints[1]);
+    EXPECT_EQ(*ints[2], -7);
+    EXPECT_FALSE(ints[3]);
+    EXPECT_EQ(*doubles[0], 2.5);
+    EXPECT_EQ(*doubles[1], 3.0);
+    EXPECT_FALSE(doubles[2]);
+    EXPECT_FALSE(doubles[3]);
+}
+
+TEST(CsvReaderTest, lineEndingsAndOptions) {
+    ChunkedColumn<std::int64_t> ints;
+    ChunkedColumn<double> doubles;
+    CsvOptions options;
+    options.delimiter = ';';
+    options.header = false;
+    load("1;1e3\r\n2;\r\n3;-0.125", ints, doubles, options);
+    ASSERT_EQ(ints.size(), 3u);
+    EXPECT_EQ(*ints[2], 3);
+    EXPECT_EQ(*doubles[0], 1000.0);
+    EXPECT_FALSE(doubles[1]);
+    EXPECT_EQ(*doubles[2], -0.125);
+}
+
+TEST(CsvReaderTest, spansManyBlocks) {
+    std::string text = "a,b\n";
+    for (int i = 0; i < 1000; ++i) {
+        text += (i % 3 == 0 ? std::string() : std::to_string(i * 1000003LL)) + "," +
+                (i % 4 == 0 ? std::string() : std::to_string(i) + ".25") + "\n";
+    }
+    ChunkedColumn<std::int64_t> ints;
+    ChunkedColumn<double> doubles;
+    EXPECT_EQ(load(text, ints, doubles).bytes, text.size());
+    ASSERT_EQ(ints.size(), 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(bool(ints[i]), i % 3 != 0);
+        EXPECT_EQ(bool(doubles[i]), i % 4 != 0);
+        if (ints[i]) {
+            EXPECT_EQ(*ints[i], i * 1000003LL);
+        }
+        if (doubles[i]) {
+            EXPECT_EQ(*doubles[i], i + 0.25);
+        }
+    }
+}
+
+TEST(CsvReaderTest, ignoredColumns) {
+    ChunkedColumn<double> doubles;
+    std::vector<CsvColumn> columns = { CsvColumn::ignored(), CsvColumn::float64(doubles) };
+    const std::string text = "name,value\nfoo,1.5\n\"bar, baz\"x,2\n";
+    EXPECT_THROW(loadCsv(text.data(), text.size(), columns), CsvError);
+    ASSERT_EQ(doubles.size(), 1u);
+    EXPECT_EQ(*doubles[0], 1.5);
+}
+
+TEST(CsvReaderTest, errors) {
+    ChunkedColumn<std::int64_t> ints;
+    ChunkedColumn<double> doubles;
+    EXPECT_THROW(load("a,b\n1,2,3\n", ints, doubles), CsvError);
+    EXPECT_THROW(load("a,b\n1\n", ints, doubles), CsvError);
+    EXPECT_THROW(load("a,b\n1x,2\n", ints, doubles), CsvError);
+    EXPECT_THROW(load("a,b\n1,2.5.1\n", ints, doubles), CsvError);
+    EXPECT_THROW(load("a,b\n9223372036854775808,1\n", ints, doubles), CsvError);
+    EXPECT_THROW(load("a,b\n1, 2\n", ints, doubles), CsvError);
+    try {
+        load("a,b\n1,2\n3,oops\n", ints, doubles);
+        FAIL();
+    } catch (const CsvError& error) {
+        EXPECT_THAT(error.what(), ::testing::HasSubstr("line 3"));
+    }
+}
+
+TEST(CsvReaderTest, errorsKeepColumnsAligned) {
+    const char* inputs[] = { "a,b\n1,2\n3,x\n", "a,b\n1,2\n3\n", "a,b\n1,2\n3,4,5\n", "a,b\n1,2\nx,4\n" };
+    for (const char* input : inputs) {
+        ChunkedColumn<std::int64_t> ints;
+        ChunkedColumn<double> doubles;
+        EXPECT_THROW(load(input, ints, doubles), CsvError) << input;
+        EXPECT_EQ(ints.size(), 1u) << input;
+        EXPECT_EQ(doubles.size(), 1u) << input;
+        EXPECT_EQ(*ints[0], 1);
+        EXPECT_EQ(*doubles[0], 2.0);
+    }
+}
+
+TEST(CsvReaderTest, parseInt64) {
+    std::int64_t value = 0;
+    const std::string min = "-9223372036854775808";
+    ASSERT_TRUE(detail::parseInt64(min.data(), min.data() + min.size(), value));
+    EXPECT_EQ(value, std::numeric_limits<std::int64_t>::min());
+    const std::string max = "+9223372036854775807";
+    ASSERT_TRUE(detail::parseInt64(max.data(), max.data() + max.size(), value));
+    EXPECT_EQ(value, std::numeric_limits<std::int64_t>::max());
+    const std::string sign = "-";
+    EXPECT_FALSE(detail::parseInt64(sign.data(), sign.data() + sign.size(), value));
+}
+
+TEST(CsvReaderTest, parseDoubleMatchesStrtod) {
+    for (const char* text : { "0", "-0.0", "3.14159", "1e22", "1e-22", "123456789012345678", ".5", "5.",
+                              "0.1", "2.2250738585072014e-308", "1.7976931348623157e308",
+                              "12345678901234567890123", "4.9e-324", "1E+5" }) {
+        EXPECT_EQ(parsedDouble(text), std::strtod(text, nullptr)) << text;
+    }
+    EXPECT_TRUE(std::isinf(parsedDouble("inf")));
+    EXPECT_TRUE(std::isnan(parsedDouble("nan")));
+}
+
+TEST(CsvReaderTest, loadFile) {
+    const std::string path = ::testing::TempDir() + "lib-optional-csv-reader.csv";
+    {
+        std::ofstream file(path);
+        file << "x\n1\n\n3\n";
+    }
+    ChunkedColumn<std::int64_t> ints;
+    std::vector<CsvColumn> columns = { CsvColumn::int64(ints) };
+    EXPECT_EQ(loadCsvFile(path, columns).rows, 3u);
+    EXPECT_FALSE(ints[1]);
+    EXPECT_EQ(*ints[2], 3);
+    std::remove(path.c_str());
+    EXPECT_THROW(loadCsvFile(path, columns), CsvError);
+}
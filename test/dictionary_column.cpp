@@ -0,0 +1,127 @@
+#include "lib-optional/dictionary_column.hpp"
+
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+using namespace libOptional;
+
+TEST(StringRefTest, basics) {
+    const std::string owned("region");
+    StringRef ref(owned);
+    EXPECT_EQ(ref.size(), 6u);
+    EXPECT_EQ(ref.str(), owned);
+    EXPECT_TRUE(ref == StringRef("region"));
+    EXPECT_TRUE(ref != StringRef("regio"));
+    EXPECT_TRUE(StringRef("abc") < StringRef("abd"));
+    EXPECT_TRUE(StringRef("ab") < StringRef("abc"));
+    EXPECT_TRUE(StringRef().empty());
+    EXPECT_EQ(std::hash<StringRef>{}(StringRef("x")), std::hash<StringRef>{}(StringRef(std::string("x"))));
+}
+
+TEST(DictionaryColumnTest, encode) {
+    DictionaryColumn column;
+    column.append("EU");
+    column.append(Optional<std::string>("US"));
+    column.appendNull();
+    column.append(std::string("EU"));
+    column.append(Optional<StringRef>());
+
+    EXPECT_EQ(column.size(), 5u);
+    EXPECT_EQ(column.dictionarySize(), 2u);
+    EXPECT_EQ(column.code(0), column.code(3));
+    EXPECT_EQ(column.code(2), DictionaryColumn::NullCode);
+    EXPECT_EQ(column[0], Optional<StringRef>("EU"));
+    EXPECT_FALSE(column[2]);
+    EXPECT_EQ(column.string(1), Optional<std::string>("US"));
+    EXPECT_FALSE(column.string(4));
+    EXPECT_EQ(column.nullCount(), 2u);
+}
+
+TEST(DictionaryColumnTest, findCode) {
+    DictionaryColumn column;
+    EXPECT_FALSE(column.findCode("EU"));
+    const DictionaryColumn::Code eu = column.encode("EU");
+    EXPECT_EQ(column.findCode("EU"), eu);
+    EXPECT_FALSE(column.findCode("US"));
+    EXPECT_EQ(column.decode(eu), StringRef("EU"));
+
+    column.appendCode(eu);
+    column.appendCode(DictionaryColumn::NullCode);
+    EXPECT_THROW(column.appendCode(7), std::out_of_range);
+    EXPECT_EQ(column.size(), 2u);
+}
+
+TEST(DictionaryColumnTest, manyDistinct) {
+    DictionaryColumn column;
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            column.append("value-" + std::to_string(i));
+        }
+    }
+    EXPECT_EQ(column.dictionarySize(), 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(column.code(std::size_t(i)), column.code(std::size_t(i + 1000)));
+        EXPECT_EQ(*column[std::size_t(i)], StringRef("value-" + std::to_string(i)));
+    }
+    column.append("");
+    EXPECT_EQ(*column[2000], StringRef(""));
+    EXPECT_EQ(column.dictionarySize(), 1001u);
+}
+
+TEST(DictionaryColumnTest, roundTrip) {
+    const std::vector<Optional<std::string>> input = {
+        std::string("a"), NullOptional, std::string("b"), std::string("a"), NullOptional, std::string("c")
+    };
+    DictionaryColumn column(input.begin(), input.end());
+    EXPECT_EQ(column.toOptionals(), input);
+}
+
+TEST(DictionaryColumnTest, filters) {
+    DictionaryColumn column;
+    for (int i = 0; i < 100; ++i) {
+        if (i % 10 == 0) {
+            column.appendNull();
+        } else {
+            column.append(i % 3 == 0 ? "open" : i % 3 == 1 ? "closed" : "halted");
+        }
+    }
+
+    std::vector<std::uint64_t> selection(detail::wordCount(column.size()));
+    EXPECT_EQ(column.filterEqual("open", selection.data()), 30u);
+    EXPECT_TRUE(detail::testBit(selection.data(), 3));
+    EXPECT_FALSE(detail::testBit(selection.data(), 30));
+    EXPECT_EQ(column.filterEqual("unknown", selection.data()), 0u);
+
+    int evaluated = 0;
+    const std::size_t selected = column.filter(
+        [&](StringRef value) {
+            ++evaluated;
+            return value.size() == 6;
+        },
+        selection.data());
+    EXPECT_EQ(evaluated, 3);
+    EXPECT_EQ(selected, 60u);
+
+    const std::vector<std::size_t> counts = column.countByCode();
+    ASSERT_EQ(counts.size(), 3u);
+    EXPECT_EQ(counts[*column.findCode("open")], 30u);
+    EXPECT_EQ(counts[*column.findCode("closed")], 30u);
+    EXPECT_EQ(counts[*column.findCode("halted")], 30u);
+    EXPECT_EQ(column.nullCount(), 10u);
+}
+
+TEST(DictionaryColumnTest, encodePrefixOfDecodedEntry) {
+    const std::string alphabet = "abcdefghijklmnopqrstuvwxyz";
+    DictionaryColumn column;
+    column.encode(alphabet);
+    // Every new entry points into the arena it is appended to, which may move while it grows
+    for (std::size_t length = alphabet.size() - 1; length > 0; --length) {
+        const StringRef previous = column.decode(DictionaryColumn::Code(alphabet.size() - 1 - length));
+        EXPECT_EQ(column.encode(StringRef(previous.data(), length)), alphabet.size() - length);
+    }
+    for (std::size_t code = 0; code < alphabet.size(); ++code) {
+        EXPECT_EQ(column.decode(DictionaryColumn::Code(code)),
+                  StringRef(alphabet.data(), alphabet.size() - code));
+    }
+}
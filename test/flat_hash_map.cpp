@@ -0,0 +1,215 @@
+#include "lib-optional/flat_hash_map.hpp"
+
+#include "fragile.hpp"
+
+#include <cstring>
+#include <gmock/gmock.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+using namespace libOptional;
+
+namespace {
+
+/// Hashes std::string and C strings alike, so either can look up a std::string key
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(const char* string) const { return hash(string, std::strlen(string)); }
+
+    std::size_t operator()(const std::string& string) const { return hash(string.data(), string.size()); }
+
+    static std::size_t hash(const char* data, std::size_t size) {
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ std::uint8_t(data[i])) * 0x100000001b3ULL;
+        }
+        return std::size_t(hash);
+    }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+
+    bool operator()(const std::string& a, const std::string& b) const { return a == b; }
+
+    bool operator()(const std::string& a, const char* b) const { return a == b; }
+};
+
+/// Counts the std::string keys constructed, to check that lookups do not create any
+struct CountingString : std::string {
+    static int constructed;
+
+    CountingString(const char* string)
+        : std::string(string) {
+        ++constructed;
+    }
+};
+
+int CountingString::constructed = 0;
+
+} // namespace
+
+TEST(FlatHashMapTest, findReturnsReference) {
+    FlatHashMap<std::string, int> map;
+    EXPECT_FALSE(map.find("missing"));
+    EXPECT_TRUE(map.tryEmplace("one", 1).second);
+    EXPECT_TRUE(map.tryEmplace(std::string("two"), 2).second);
+    Optional<int&> value = map.find("two");
+    ASSERT_TRUE(value);
+    EXPECT_EQ(*value, 2);
+    *value = 22;
+    EXPECT_EQ(*map.find("two"), 22);
+    EXPECT_FALSE(map.find("three"));
+
+    const FlatHashMap<std::string, int>& constMap = map;
+    EXPECT_EQ(*constMap.find("one"), 1);
+    EXPECT_TRUE(constMap.contains("one"));
+    EXPECT_FALSE(constMap.contains("three"));
+    EXPECT_EQ(map.size(), 2u);
+}
+
+TEST(FlatHashMapTest, tryEmplaceKeepsPresentValue) {
+    FlatHashMap<int, std::string> map;
+    std::pair<std::string&, bool> first = map.tryEmplace(1, 3, 'a');
+    EXPECT_TRUE(first.second);
+    EXPECT_EQ(first.first, "aaa");
+    std::string replacement = "replacement";
+    std::pair<std::string&, bool> second = map.tryEmplace(1, std::move(replacement));
+    EXPECT_FALSE(second.second);
+    EXPECT_EQ(second.first, "aaa");
+    // Nothing was moved from the arguments
+    EXPECT_EQ(replacement, "replacement");
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(FlatHashMapTest, extractMovesValueOut) {
+    FlatHashMap<int, std::unique_ptr<int>> map;
+    map.tryEmplace(5, new int(50));
+    EXPECT_FALSE(map.extract(6));
+    Optional<std::unique_ptr<int>> value = map.extract(5);
+    ASSERT_TRUE(value);
+    EXPECT_EQ(**value, 50);
+    EXPECT_FALSE(map.find(5));
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.erase(5));
+}
+
+TEST(FlatHashMapTest, transparentLookupsConstructNoKeys) {
+    FlatHashMap<std::string, int, StringHash, StringEqual> map;
+    static_assert(FlatHashMap<std::string, int, StringHash, StringEqual>::Transparent, "");
+    static_assert(!FlatHashMap<std::string, int>::Transparent, "");
+    const char* key = "key";
+    EXPECT_TRUE(map.tryEmplace(key, 1).second);
+    EXPECT_FALSE(map.tryEmplace(key, 2).second);
+    EXPECT_EQ(*map.find(key), 1);
+    EXPECT_TRUE(map.contains(key));
+    EXPECT_EQ(*map.extract(key), 1);
+    EXPECT_FALSE(map.erase(key));
+
+    FlatHashMap<CountingString, int, StringHash, StringEqual> counting;
+    counting.tryEmplace("a", 1);
+    counting.tryEmplace("b", 2);
+    CountingString::constructed = 0;
+    EXPECT_EQ(*counting.find("a"), 1);
+    EXPECT_FALSE(counting.tryEmplace("b", 3).second);
+    EXPECT_TRUE(counting.erase("a"));
+    EXPECT_EQ(CountingString::constructed, 0);
+}
+
+TEST(FlatHashMapTest, growsAndReusesErasedSlots) {
+    FlatHashMap<int, int> map;
+    EXPECT_EQ(map.capacity(), 0u);
+    for (int i = 0; i < 1000; ++i) {
+        map.tryEmplace(i, i * 2);
+    }
+    EXPECT_EQ(map.size(), 1000u);
+    const std::size_t capacity = map.capacity();
+    EXPECT_GE(capacity / 8 * 7, 1000u);
+    // Churning through many more keys than the capacity must not grow the table
+    for (int i = 1000; i < 100000; ++i) {
+        EXPECT_TRUE(map.erase(i - 1000));
+        map.tryEmplace(i, i * 2);
+    }
+    EXPECT_EQ(map.capacity(), capacity);
+    for (int i = 99000; i < 100000; ++i) {
+        ASSERT_EQ(*map.find(i), i * 2);
+    }
+    EXPECT_FALSE(map.find(0));
+
+    long sum = 0;
+    map.forEach([&sum](const int& key, int& value) { sum += value - 2 * key; });
+    EXPECT_EQ(sum, 0);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.find(99999));
+    map.tryEmplace(1, 1);
+    EXPECT_EQ(*map.find(1), 1);
+}
+
+TEST(FlatHashMapTest, throwingRehashKeepsAllEntries) {
+    // Moving the values may throw, so growing copies them and copying the first one throws
+    FlatHashMap<int, test::MoveMayThrowFragile> map;
+    map.tryEmplace(0, 0, true);
+    int key = 1;
+    while (map.size() < map.capacity() / 8 * 7) {
+        map.tryEmplace(key, key);
+        ++key;
+    }
+    const std::size_t capacity = map.capacity();
+    EXPECT_THROW(map.tryEmplace(key, key), std::runtime_error);
+    EXPECT_EQ(map.capacity(), capacity);
+    EXPECT_EQ(map.size(), std::size_t(key));
+    for (int i = 0; i < key; ++i) {
+        ASSERT_TRUE(map.find(i));
+        EXPECT_EQ(map.find(i)->value, i);
+    }
+    EXPECT_FALSE(map.find(key));
+    EXPECT_TRUE(map.erase(0));
+    EXPECT_TRUE(map.tryEmplace(key, key).second);
+}
+
+TEST(FlatHashMapTest, reserveAvoidsRehashing) {
+    FlatHashMap<int, int> map(5000);
+    const std::size_t capacity = map.capacity();
+    for (int i = 0; i < 5000; ++i) {
+        map.tryEmplace(i, i);
+    }
+    EXPECT_EQ(map.capacity(), capacity);
+
+    FlatHashMap<int, int> moved(std::move(map));
+    EXPECT_EQ(moved.size(), 5000u);
+    EXPECT_EQ(*moved.find(4999), 4999);
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.find(1));
+    map = std::move(moved);
+    EXPECT_EQ(*map.find(7), 7);
+}
+
+TEST(FlatHashMapTest, matchesUnorderedMap) {
+    FlatHashMap<std::uint64_t, std::uint64_t> map;
+    std::unordered_map<std::uint64_t, std::uint64_t> reference;
+    std::mt19937_64 random(3);
+    for (std::uint64_t i = 0; i < 50000; ++i) {
+        // Keys sharing their low bits stress the tag matching
+        const std::uint64_t key = (random() % 5000) << 20;
+        switch (random() % 3) {
+        case 0:
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+            break;
+        case 1:
+            EXPECT_EQ(map.tryEmplace(key, i).second, reference.emplace(key, i).second);
+            break;
+        default:
+            ASSERT_EQ(bool(map.find(key)), reference.count(key) == 1);
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    for (const auto& entry : reference) {
+        EXPECT_EQ(*map.find(entry.first), entry.second);
+    }
+}
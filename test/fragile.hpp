@@ -0,0 +1,71 @@
+#ifndef TEST_FRAGILE_HPP_
+#define TEST_FRAGILE_HPP_
+
+#include <stdexcept>
+
+namespace test {
+
+/// Value type for exception-safety tests
+///
+/// Constructing one from a negative number throws std::runtime_error, and so does copying one
+/// constructed with throwOnCopy. With TNothrowMove the move constructor is noexcept, without it
+/// moving such a value throws as well.
+template <bool TNothrowMove>
+struct BasicFragile {
+    /// \param throwOnCopy Whether copies of this value throw
+    BasicFragile(int value, bool throwOnCopy = false)
+        : value(value)
+        , throwOnCopy(throwOnCopy) {
+        if (value < 0) {
+            throw std::runtime_error("negative value");
+        }
+    }
+
+    BasicFragile(const BasicFragile& other)
+        : value(other.value)
+        , throwOnCopy(other.throwOnCopy) {
+        if (throwOnCopy) {
+            throw std::runtime_error("copy failed");
+        }
+    }
+
+    BasicFragile(BasicFragile&& other) noexcept(TNothrowMove)
+        : value(other.value)
+        , throwOnCopy(other.throwOnCopy) {
+        if (!TNothrowMove && throwOnCopy) {
+            failMove();
+        }
+    }
+
+    BasicFragile& operator=(const BasicFragile& other) {
+        if (other.throwOnCopy) {
+            throw std::runtime_error("copy failed");
+        }
+        value = other.value;
+        throwOnCopy = false;
+        return *this;
+    }
+
+    BasicFragile& operator=(BasicFragile&& other) noexcept(TNothrowMove) {
+        value = other.value;
+        throwOnCopy = other.throwOnCopy;
+        return *this;
+    }
+
+    bool operator==(const BasicFragile& other) const noexcept { return value == other.value; }
+
+    int value;
+    bool throwOnCopy = false;
+
+private:
+    // Out of line, as the noexcept move constructor of Fragile never reaches it
+    static void failMove() { throw std::runtime_error("move failed"); }
+};
+
+using Fragile = BasicFragile<true>;
+
+using MoveMayThrowFragile = BasicFragile<false>;
+
+} // namespace test
+
+#endif // TEST_FRAGILE_HPP_
@@ -0,0 +1,110 @@
+#include "lib-optional/future.hpp"
+
+#include <gmock/gmock.h>
+#include <memory>
+#include <string>
+
+using namespace libOptional;
+
+TEST(FutureTest, tryGetIsEmptyUntilTheValueIsSet) {
+    Promise<std::string> promise;
+    Future<std::string> future = promise.getFuture();
+    EXPECT_TRUE(future.valid());
+    EXPECT_FALSE(future.ready());
+    EXPECT_FALSE(future.tryGet());
+
+    promise.setValue(3, 'x');
+    EXPECT_TRUE(promise.satisfied());
+    ASSERT_TRUE(future.tryGet());
+    EXPECT_EQ(*future.tryGet(), "xxx");
+
+    // The value stays in the promise and can be modified through the reference
+    *future.tryGet() += "y";
+    EXPECT_EQ(*future.tryGet(), "xxxy");
+}
+
+TEST(FutureTest, misuseThrows) {
+    Promise<int> promise;
+    Future<int> future = promise.getFuture();
+    EXPECT_THROW(promise.getFuture(), FutureError);
+    promise.setValue(1);
+    EXPECT_THROW(promise.setValue(2), FutureError);
+    EXPECT_THROW(Future<int>().then([](int&) {}), FutureError);
+}
+
+TEST(FutureTest, continuationRunsOnCompletion) {
+    Promise<std::unique_ptr<int>> promise;
+    Future<std::unique_ptr<int>> future = promise.getFuture();
+    int seen = 0;
+    future.then([&seen](std::unique_ptr<int>& value) { seen = *value; });
+    EXPECT_THROW(future.then([](std::unique_ptr<int>&) {}), FutureError);
+    EXPECT_EQ(seen, 0);
+    promise.setValue(new int(7));
+    EXPECT_EQ(seen, 7);
+}
+
+TEST(FutureTest, continuationRunsImmediatelyWhenReady) {
+    Promise<int> promise;
+    Future<int> future = promise.getFuture();
+    promise.setValue(5);
+    int seen = 0;
+    future.then([&seen](int& value) { seen = value; });
+    EXPECT_EQ(seen, 5);
+}
+
+TEST(FutureTest, continuationIsDestroyed) {
+    std::shared_ptr<int> captured = std::make_shared<int>(0);
+    {
+        Promise<int> promise;
+        Future<int> future = promise.getFuture();
+        future.then([captured](int& value) { *captured = value; });
+        EXPECT_EQ(captured.use_count(), 2);
+        promise.setValue(3);
+        EXPECT_EQ(captured.use_count(), 1);
+        EXPECT_EQ(*captured, 3);
+    }
+    {
+        Promise<int> promise;
+        promise.getFuture().then([captured](int&) {});
+        EXPECT_EQ(captured.use_count(), 2);
+    }
+    EXPECT_EQ(captured.use_count(), 1);
+}
+
+TEST(FutureTest, chaining) {
+    Promise<int> first;
+    Promise<std::string> second;
+    Promise<std::size_t> third;
+    Future<std::size_t> last = first.getFuture()
+                                   .then(second, [](int& value) { return std::string(value, '*'); })
+                                   .then(third, [](std::string& value) { return value.size() * 10; });
+    EXPECT_FALSE(last.tryGet());
+    first.setValue(4);
+    ASSERT_TRUE(second.satisfied());
+    ASSERT_TRUE(last.tryGet());
+    EXPECT_EQ(*last.tryGet(), 40u);
+}
+
+TEST(FutureTest, movedFutureStaysConnected) {
+    Promise<int> promise;
+    Future<int> future = promise.getFuture();
+    Future<int> moved(std::move(future));
+    EXPECT_FALSE(future.valid());
+    Future<int> assigned;
+    assigned = std::move(moved);
+    promise.setValue(9);
+    ASSERT_TRUE(assigned.tryGet());
+    EXPECT_EQ(*assigned.tryGet(), 9);
+}
+
+TEST(FutureTest, destroyedPromiseInvalidatesTheFuture) {
+    Future<int> future;
+    {
+        Promise<int> promise;
+        future = promise.getFuture();
+        promise.setValue(1);
+        EXPECT_TRUE(future.ready());
+    }
+    EXPECT_FALSE(future.valid());
+    EXPECT_FALSE(future.tryGet());
+}
@@ -0,0 +1,108 @@
+#include "lib-optional/kernels.hpp"
+
+#include <gmock/gmock.h>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Nullable {
+    std::vector<int> values;
+    std::vector<std::uint64_t> validity;
+
+    explicit Nullable(const std::vector<Optional<int>>& input)
+        : values(input.size())
+        , validity(detail::wordCount(input.size())) {
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            if (input[i]) {
+                values[i] = *input[i];
+                detail::setBit(validity.data(), i);
+            }
+        }
+    }
+
+    OptionalSpan<int> span() const {
+        return OptionalSpan<int>(values.data(), validity.data(), values.size());
+    }
+};
+
+std::vector<Optional<int>> pattern(std::size_t size) {
+    std::vector<Optional<int>> result;
+    for (std::size_t i = 0; i < size; ++i) {
+        result.push_back(i % 5 == 0 ? Optional<int>() : Optional<int>(int(i)));
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(OptionalSpanTest, access) {
+    Nullable column(pattern(10));
+    OptionalSpan<int> span = column.span();
+    EXPECT_EQ(span.size(), 10u);
+    EXPECT_FALSE(span.allValid());
+    EXPECT_FALSE(span[0]);
+    EXPECT_EQ(*span[1], 1);
+
+    const int values[] = { 1, 2, 3 };
+    OptionalSpan<int> dense(values, nullptr, 3);
+    EXPECT_TRUE(dense.allValid());
+    EXPECT_EQ(*dense[2], 3);
+}
+
+TEST(OptionalSpanTest, subspan) {
+    Nullable column(pattern(200));
+    OptionalSpan<int> tail = column.span().subspan(128, 72);
+    EXPECT_EQ(tail.size(), 72u);
+    EXPECT_FALSE(tail[2]);
+    EXPECT_EQ(*tail[3], 131);
+}
+
+TEST(KernelsTest, count) {
+    Nullable column(pattern(130));
+    EXPECT_EQ(countValid(column.span()), 104u);
+    EXPECT_EQ(countNull(column.span()), 26u);
+}
+
+TEST(KernelsTest, sum) {
+    Nullable column(pattern(130));
+    long expected = 0;
+    for (int i = 0; i < 130; ++i) {
+        expected += i % 5 == 0 ? 0 : i;
+    }
+    EXPECT_EQ((sum<int, long>(column.span())), expected);
+    EXPECT_EQ((sum<int, long>(column.span(), 10)), expected + 10);
+}
+
+TEST(KernelsTest, minMax) {
+    Nullable column(pattern(130));
+    EXPECT_EQ(min(column.span()), 1);
+    EXPECT_EQ(max(column.span()), 129);
+
+    Nullable empty(std::vector<Optional<int>>(5));
+    EXPECT_FALSE(min(empty.span()));
+    EXPECT_FALSE(max(empty.span()));
+}
+
+TEST(KernelsTest, forEachValid) {
+    Nullable column(pattern(70));
+    std::size_t count = 0;
+    forEachValid(column.span(), [&](std::size_t index, int value) {
+        EXPECT_NE(index % 5, 0u);
+        EXPECT_EQ(value, int(index));
+        ++count;
+    });
+    EXPECT_EQ(count, 56u);
+}
+
+TEST(KernelsTest, filter) {
+    Nullable column(pattern(130));
+    std::vector<std::uint64_t> selection(detail::wordCount(130));
+    const std::size_t selected = filter(column.span(), [](int v) { return v % 2 == 0; }, selection.data());
+    EXPECT_EQ(selected, detail::countSetBits(selection.data(), 130));
+    EXPECT_EQ(selected, 52u);
+    EXPECT_FALSE(detail::testBit(selection.data(), 0));
+    EXPECT_TRUE(detail::testBit(selection.data(), 2));
+    EXPECT_FALSE(detail::testBit(selection.data(), 3));
+}
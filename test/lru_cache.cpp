@@ -0,0 +1,133 @@
+#include "lib-optional/lru_cache.hpp"
+
+#include "fragile.hpp"
+
+#include <gmock/gmock.h>
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+using namespace libOptional;
+
+TEST(LruCacheTest, getReturnsReference) {
+    LruCache<std::string, std::string> cache(4);
+    EXPECT_TRUE(cache.empty());
+    EXPECT_FALSE(cache.get("key"));
+    cache.put("key", std::string("value"));
+    Optional<std::string&> value = cache.get("key");
+    ASSERT_TRUE(value);
+    *value += "!";
+    EXPECT_EQ(*cache.peek("key"), "value!");
+    cache.put("key", "replaced");
+    EXPECT_EQ(*cache.get("key"), "replaced");
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_THROW((LruCache<int, int>(0)), std::invalid_argument);
+}
+
+TEST(LruCacheTest, evictsLeastRecentlyUsed) {
+    LruCache<int, int> cache(3);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    EXPECT_EQ(*cache.leastRecent(), 1);
+    EXPECT_TRUE(cache.get(1));
+    EXPECT_EQ(*cache.leastRecent(), 2);
+    // peek() does not refresh the entry
+    EXPECT_TRUE(cache.peek(2));
+    cache.put(4, 40);
+    EXPECT_EQ(cache.evictions(), 1u);
+    EXPECT_FALSE(cache.get(2));
+    EXPECT_EQ(*cache.get(1), 10);
+    EXPECT_EQ(*cache.get(3), 30);
+    EXPECT_EQ(*cache.get(4), 40);
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(LruCacheTest, eraseAndClear) {
+    LruCache<int, std::string> cache(2);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_FALSE(cache.erase(1));
+    cache.put(3, "three");
+    EXPECT_EQ(cache.evictions(), 0u);
+    EXPECT_EQ(*cache.get(2), "two");
+    cache.clear();
+    EXPECT_TRUE(cache.empty());
+    EXPECT_FALSE(cache.leastRecent());
+    EXPECT_FALSE(cache.get(2));
+    cache.put(4, "four");
+    EXPECT_EQ(*cache.get(4), "four");
+}
+
+namespace {
+
+struct FragileHash {
+    std::size_t operator()(const test::Fragile& key) const noexcept { return std::size_t(key.value); }
+};
+
+} // namespace
+
+TEST(LruCacheTest, throwingKeyKeepsTheFreeNode) {
+    LruCache<test::Fragile, int, FragileHash> cache(2);
+    cache.put(1, 10);
+    EXPECT_THROW(cache.put(test::Fragile(2, true), 20), std::runtime_error);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_FALSE(cache.peek(2));
+    EXPECT_EQ((*cache.leastRecent()).value, 1);
+    // The node the failed put() picked is still free, filling the cache evicts nothing
+    cache.put(2, 20);
+    EXPECT_EQ(cache.evictions(), 0u);
+    cache.put(3, 30);
+    EXPECT_EQ(cache.evictions(), 1u);
+    EXPECT_FALSE(cache.peek(1));
+    EXPECT_EQ(*cache.get(2), 20);
+    EXPECT_EQ(*cache.get(3), 30);
+}
+
+TEST(LruCacheTest, matchesListAndMapModel) {
+    const std::size_t capacity = 64;
+    LruCache<int, int> cache(capacity);
+    std::list<std::pair<int, int>> order;
+    std::unordered_map<int, std::list<std::pair<int, int>>::iterator> model;
+    std::mt19937 random(7);
+    for (int i = 0; i < 20000; ++i) {
+        const int key = int(random() % 200);
+        const auto it = model.find(key);
+        switch (random() % 3) {
+        case 0: {
+            cache.put(key, i);
+            if (it != model.end()) {
+                order.erase(it->second);
+            } else if (model.size() == capacity) {
+                model.erase(order.back().first);
+                order.pop_back();
+            }
+            order.emplace_front(key, i);
+            model[key] = order.begin();
+            break;
+        }
+        case 1: {
+            Optional<int&> value = cache.get(key);
+            ASSERT_EQ(bool(value), it != model.end());
+            if (value) {
+                EXPECT_EQ(*value, it->second->second);
+                order.splice(order.begin(), order, it->second);
+            }
+            break;
+        }
+        default:
+            ASSERT_EQ(cache.erase(key), it != model.end());
+            if (it != model.end()) {
+                order.erase(it->second);
+                model.erase(it);
+            }
+        }
+        ASSERT_EQ(cache.size(), model.size());
+        if (!order.empty()) {
+            ASSERT_EQ(*cache.leastRecent(), order.back().first);
+        }
+    }
+}
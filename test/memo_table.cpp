@@ -0,0 +1,109 @@
+#include "lib-optional/memo_table.hpp"
+
+#include "fragile.hpp"
+
+#include <atomic>
+#include <gmock/gmock.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+TEST(MemoTableTest, computesOncePerKey) {
+    MemoTable<std::string, std::size_t> table(16);
+    int calls = 0;
+    auto length = [&calls](const std::string& key) {
+        ++calls;
+        return key.size();
+    };
+    EXPECT_FALSE(table.find("abc"));
+    EXPECT_EQ(table.getOrCompute("abc", length), 3u);
+    EXPECT_EQ(table.getOrCompute("abc", length), 3u);
+    EXPECT_EQ(table.getOrCompute("hello", length), 5u);
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(table.size(), 2u);
+    ASSERT_TRUE(table.find("hello"));
+    EXPECT_EQ(*table.find("hello"), 5u);
+    EXPECT_FALSE(table.find("missing"));
+}
+
+TEST(MemoTableTest, returnedReferencesStayValid) {
+    MemoTable<int, std::string> table(64);
+    const std::string& first = table.getOrCompute(1, [](int) { return std::string("one"); });
+    for (int i = 2; i < 40; ++i) {
+        table.getOrCompute(i, [](int key) { return std::to_string(key); });
+    }
+    EXPECT_EQ(first, "one");
+    EXPECT_EQ(&first, &*table.find(1));
+}
+
+TEST(MemoTableTest, capacity) {
+    EXPECT_THROW((MemoTable<int, int>(12)), std::invalid_argument);
+    MemoTable<int, int> table(4);
+    EXPECT_EQ(table.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        table.getOrCompute(i, [](int key) { return key; });
+    }
+    EXPECT_THROW(table.getOrCompute(4, [](int key) { return key; }), MemoTableError);
+    // Known keys are still found in a full table
+    EXPECT_EQ(table.getOrCompute(3, [](int) { return -1; }), 3);
+}
+
+TEST(MemoTableTest, failedComputationIsRetried) {
+    MemoTable<int, int> table(8);
+    EXPECT_THROW(table.getOrCompute(1, [](int) -> int { throw std::runtime_error("failed"); }),
+                 std::runtime_error);
+    EXPECT_FALSE(table.find(1));
+    EXPECT_EQ(table.getOrCompute(1, [](int key) { return key * 10; }), 10);
+}
+
+namespace {
+
+/// Sends every key to the same slot
+struct CollidingHash {
+    std::size_t operator()(const test::Fragile&) const noexcept { return 0; }
+};
+
+} // namespace
+
+TEST(MemoTableTest, throwingKeyCopyGivesTheSlotBack) {
+    MemoTable<test::Fragile, int, CollidingHash> table(4);
+    auto value = [](const test::Fragile& key) { return key.value * 10; };
+    EXPECT_THROW(table.getOrCompute(test::Fragile(1, true), value), std::runtime_error);
+    EXPECT_EQ(table.size(), 0u);
+    // Every key probes the slot the failed copy claimed first, it must be usable again
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(table.getOrCompute(test::Fragile(i), value), i * 10);
+    }
+    EXPECT_EQ(table.size(), 4u);
+    EXPECT_EQ(*table.find(test::Fragile(1)), 10);
+}
+
+TEST(MemoTableTest, eachKeyIsComputedOnceUnderContention) {
+    MemoTable<int, int> table(1024);
+    std::atomic<int> calls{ 0 };
+    std::atomic<bool> mismatch{ false };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 500; ++i) {
+                const int key = (i * 7 + t) % 300;
+                const int value = table.getOrCompute(key, [&calls](int k) {
+                    calls.fetch_add(1);
+                    return k * k;
+                });
+                if (value != key * key) {
+                    mismatch = true;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(mismatch.load());
+    EXPECT_EQ(calls.load(), 300);
+    EXPECT_EQ(table.size(), 300u);
+}
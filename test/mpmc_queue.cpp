@@ -0,0 +1,148 @@
+#include "lib-optional/mpmc_queue.hpp"
+
+#include "fragile.hpp"
+
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct NoDefault {
+    explicit NoDefault(int value)
+        : value(value) {}
+
+    int value;
+};
+
+} // namespace
+
+TEST(MpmcQueueTest, pushPopInOrder) {
+    MpmcQueue<std::unique_ptr<int>> queue(4);
+    EXPECT_EQ(queue.capacity(), 4u);
+    EXPECT_FALSE(queue.tryPop());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(std::unique_ptr<int>(new int(i))));
+    }
+    EXPECT_FALSE(queue.tryPush(std::unique_ptr<int>(new int(4))));
+    EXPECT_EQ(queue.sizeApprox(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        Optional<std::unique_ptr<int>> value = queue.tryPop();
+        ASSERT_TRUE(value);
+        EXPECT_EQ(**value, i);
+    }
+    EXPECT_FALSE(queue.tryPop());
+    EXPECT_TRUE(queue.tryPush(std::unique_ptr<int>(new int(5))));
+}
+
+TEST(MpmcQueueTest, emplaceWithoutDefaultConstructor) {
+    MpmcQueue<NoDefault> queue(2);
+    EXPECT_TRUE(queue.tryEmplace(7));
+    EXPECT_EQ(queue.tryPop()->value, 7);
+}
+
+TEST(MpmcQueueTest, throwingConstructorLeavesTombstone) {
+    MpmcQueue<test::Fragile> queue(4);
+    EXPECT_TRUE(queue.tryEmplace(1));
+    EXPECT_THROW(queue.tryEmplace(-1), std::runtime_error);
+    EXPECT_TRUE(queue.tryEmplace(2));
+    EXPECT_EQ(queue.tryPop()->value, 1);
+    // The tombstone is skipped
+    EXPECT_EQ(queue.tryPop()->value, 2);
+    EXPECT_FALSE(queue.tryPop());
+
+    EXPECT_THROW(queue.tryEmplace(-2), std::runtime_error);
+    EXPECT_TRUE(queue.tryEmplace(3));
+    EXPECT_THROW(queue.tryEmplace(-3), std::runtime_error);
+    std::vector<test::Fragile> out;
+    EXPECT_EQ(queue.tryPopMany(std::back_inserter(out), 8), 1u);
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].value, 3);
+    // All slots were released, the queue can be filled again
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryEmplace(i));
+    }
+    EXPECT_FALSE(queue.tryEmplace(4));
+}
+
+TEST(MpmcQueueTest, invalidCapacity) {
+    EXPECT_THROW(MpmcQueue<int>(3), std::invalid_argument);
+    EXPECT_THROW(MpmcQueue<int>(0), std::invalid_argument);
+}
+
+TEST(MpmcQueueTest, popMany) {
+    MpmcQueue<int> queue(8);
+    for (int i = 0; i < 6; ++i) {
+        queue.tryPush(i);
+    }
+    std::vector<int> out;
+    EXPECT_EQ(queue.tryPopMany(std::back_inserter(out), 4), 4u);
+    EXPECT_EQ(queue.tryPopMany(std::back_inserter(out), 4), 2u);
+    EXPECT_EQ(queue.tryPopMany(std::back_inserter(out), 4), 0u);
+    EXPECT_EQ(out, (std::vector<int>{ 0, 1, 2, 3, 4, 5 }));
+}
+
+TEST(MpmcQueueTest, destroysRemainingElements) {
+    std::shared_ptr<int> counter = std::make_shared<int>(0);
+    {
+        MpmcQueue<std::shared_ptr<int>> queue(4);
+        queue.tryPush(counter);
+        queue.tryPush(counter);
+        EXPECT_EQ(counter.use_count(), 3);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(MpmcQueueTest, concurrentProducersAndConsumers) {
+    MpmcQueue<std::uint64_t> queue(64);
+    const std::uint64_t perProducer = 20000;
+    const int producers = 3, consumers = 3;
+    std::atomic<std::uint64_t> sum{ 0 };
+    std::atomic<std::uint64_t> popped{ 0 };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (std::uint64_t i = 0; i < perProducer; ++i) {
+                while (!queue.tryPush(std::uint64_t(p) * perProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            std::vector<std::uint64_t> batch;
+            while (popped.load() < producers * perProducer) {
+                batch.clear();
+                std::size_t count = 0;
+                if (c == 0) {
+                    count = queue.tryPopMany(std::back_inserter(batch), 16);
+                } else if (Optional<std::uint64_t> value = queue.tryPop()) {
+                    batch.push_back(*value);
+                    count = 1;
+                }
+                if (count == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (std::uint64_t value : batch) {
+                    sum += value;
+                }
+                popped += count;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const std::uint64_t total = producers * perProducer;
+    EXPECT_EQ(popped.load(), total);
+    EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+}
@@ -0,0 +1,50 @@
+#include "lib-optional/once_optional.hpp"
+
+#include <atomic>
+#include <gmock/gmock.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+TEST(OnceOptionalTest, initializesOnce) {
+    OnceOptional<std::string> once;
+    EXPECT_FALSE(once.hasValue());
+    EXPECT_FALSE(once.get());
+    EXPECT_EQ(once.getOrInit([] { return std::string("first"); }), "first");
+    EXPECT_EQ(once.getOrInit([] { return std::string("second"); }), "first");
+    ASSERT_TRUE(once.get());
+    EXPECT_EQ(*once.get(), "first");
+}
+
+TEST(OnceOptionalTest, throwingInitializerLeavesItEmpty) {
+    OnceOptional<int> once;
+    EXPECT_THROW(once.getOrInit([]() -> int { throw std::runtime_error("failed"); }), std::runtime_error);
+    EXPECT_FALSE(once.hasValue());
+    EXPECT_EQ(once.getOrInit([] { return 2; }), 2);
+}
+
+TEST(OnceOptionalTest, concurrentCallersShareOneInitialization) {
+    OnceOptional<int> once;
+    std::atomic<int> calls{ 0 };
+    std::vector<std::thread> threads;
+    std::vector<int> seen(8);
+    for (std::size_t t = 0; t < seen.size(); ++t) {
+        threads.emplace_back([&, t] {
+            seen[t] = once.getOrInit([&] {
+                calls.fetch_add(1);
+                std::this_thread::yield();
+                return int(t) + 100;
+            });
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(calls.load(), 1);
+    for (int value : seen) {
+        EXPECT_EQ(value, *once.get());
+    }
+}
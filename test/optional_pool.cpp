@@ -0,0 +1,149 @@
+#include "lib-optional/optional_pool.hpp"
+
+#include <gmock/gmock.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Tracked {
+    explicit Tracked(int& liveCount, int value = 0)
+        : live(liveCount)
+        , value(value) {
+        ++live;
+    }
+
+    ~Tracked() { --live; }
+
+    int& live;
+    int value;
+};
+
+struct Throwing {
+    explicit Throwing(bool fail) {
+        if (fail) {
+            throw std::runtime_error("failed");
+        }
+    }
+};
+
+} // namespace
+
+TEST(OptionalPoolTest, acquireAndRelease) {
+    int live = 0;
+    std::unique_ptr<OptionalPool<Tracked, 3>> pool(new OptionalPool<Tracked, 3>());
+    EXPECT_EQ(pool->available(), 3u);
+    Optional<Tracked&> a = pool->acquire(live, 1);
+    Optional<Tracked&> b = pool->acquire(live, 2);
+    Optional<Tracked&> c = pool->acquire(live, 3);
+    ASSERT_TRUE(a && b && c);
+    EXPECT_EQ(live, 3);
+    EXPECT_EQ(b->value, 2);
+    EXPECT_FALSE(pool->acquire(live));
+    EXPECT_EQ(pool->available(), 0u);
+    EXPECT_TRUE(pool->owns(*b));
+    Tracked outside(live);
+    EXPECT_FALSE(pool->owns(outside));
+
+    pool->release(*b);
+    EXPECT_EQ(live, 3);
+    Optional<Tracked&> d = pool->acquire(live, 4);
+    ASSERT_TRUE(d);
+    // The freed slot is the only one, so it is reused
+    EXPECT_EQ(&*d, &*b);
+    pool->release(*a);
+    pool->release(*c);
+    pool->release(*d);
+    EXPECT_EQ(live, 1);
+    EXPECT_EQ(pool->available(), 3u);
+}
+
+TEST(OptionalPoolTest, throwingConstructorKeepsTheSlotFree) {
+    OptionalPool<Throwing, 1> pool;
+    EXPECT_THROW(pool.acquire(true), std::runtime_error);
+    EXPECT_EQ(pool.available(), 1u);
+    Optional<Throwing&> object = pool.acquire(false);
+    ASSERT_TRUE(object);
+    pool.release(*object);
+}
+
+TEST(OptionalPoolTest, manyWords) {
+    std::unique_ptr<OptionalPool<std::string, 200>> pool(new OptionalPool<std::string, 200>());
+    std::vector<std::string*> objects;
+    for (int i = 0; i < 200; ++i) {
+        Optional<std::string&> object = pool->acquire(std::to_string(i));
+        ASSERT_TRUE(object);
+        objects.push_back(&*object);
+    }
+    EXPECT_FALSE(pool->acquire());
+    EXPECT_EQ(*objects[150], "150");
+    for (std::string* object : objects) {
+        pool->release(*object);
+    }
+    EXPECT_EQ(pool->available(), 200u);
+}
+
+TEST(OptionalPoolTest, threadCache) {
+    std::unique_ptr<OptionalPool<int, 100>> pool(new OptionalPool<int, 100>());
+    {
+        OptionalPool<int, 100>::ThreadCache cache(*pool);
+        Optional<int&> first = cache.acquire(7);
+        ASSERT_TRUE(first);
+        EXPECT_EQ(*first, 7);
+        EXPECT_EQ(cache.cached(), (std::size_t(OptionalPool<int, 100>::ThreadCache::Batch) - 1));
+        EXPECT_EQ(pool->available(), (100u - OptionalPool<int, 100>::ThreadCache::Batch));
+
+        std::vector<int*> objects;
+        while (Optional<int&> object = cache.acquire(1)) {
+            objects.push_back(&*object);
+        }
+        EXPECT_EQ(objects.size(), 99u);
+        EXPECT_EQ(pool->available(), 0u);
+        // Released objects are cached, overflowing batches go back to the pool
+        for (int* object : objects) {
+            cache.release(*object);
+        }
+        cache.release(*first);
+        EXPECT_LE(cache.cached(), std::size_t(2 * OptionalPool<int, 100>::ThreadCache::Batch));
+        EXPECT_EQ(pool->available() + cache.cached(), 100u);
+    }
+    EXPECT_EQ(pool->available(), 100u);
+}
+
+TEST(OptionalPoolTest, concurrentThreadCaches) {
+    using Pool = OptionalPool<std::uint64_t, 1024>;
+    std::unique_ptr<Pool> pool(new Pool());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, t] {
+            Pool::ThreadCache cache(*pool);
+            std::vector<std::uint64_t*> held;
+            for (std::uint64_t i = 0; i < 20000; ++i) {
+                if (held.size() < 100) {
+                    Optional<std::uint64_t&> object = cache.acquire(i * 4 + std::uint64_t(t));
+                    if (object) {
+                        held.push_back(&*object);
+                    }
+                } else {
+                    for (std::uint64_t* object : held) {
+                        EXPECT_EQ(*object % 4, std::uint64_t(t));
+                        cache.release(*object);
+                    }
+                    held.clear();
+                }
+            }
+            for (std::uint64_t* object : held) {
+                cache.release(*object);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(pool->available(), 1024u);
+}
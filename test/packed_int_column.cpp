@@ -0,0 +1,92 @@
+#include "lib-optional/packed_int_column.hpp"
+
+#include <gmock/gmock.h>
+#include <limits>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Nullable {
+    std::vector<std::int64_t> values;
+    std::vector<std::uint64_t> validity;
+
+    explicit Nullable(std::size_t size)
+        : values(size)
+        , validity(detail::wordCount(size)) {}
+
+    void set(std::size_t index, std::int64_t value) {
+        values[index] = value;
+        detail::setBit(validity.data(), index);
+    }
+
+    OptionalSpan<std::int64_t> span() const {
+        return OptionalSpan<std::int64_t>(values.data(), validity.data(), values.size());
+    }
+};
+
+void expectRoundTrip(const Nullable& input) {
+    const PackedInt64Column packed = PackedInt64Column::encode(input.span());
+    EXPECT_EQ(packed.size(), input.values.size());
+
+    std::vector<std::int64_t> values(packed.size(), -1);
+    std::vector<std::uint64_t> validity(detail::wordCount(packed.size()));
+    packed.decode(values.data(), validity.data());
+    EXPECT_EQ(validity, input.validity);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        const std::int64_t expected = detail::testBit(input.validity.data(), i) ? input.values[i] : 0;
+        ASSERT_EQ(values[i], expected) << "row " << i;
+    }
+}
+
+} // namespace
+
+TEST(PackedInt64ColumnTest, empty) {
+    Nullable input(0);
+    expectRoundTrip(input);
+    EXPECT_EQ(PackedInt64Column::encode(input.span()).byteSize(), 0u);
+}
+
+TEST(PackedInt64ColumnTest, denseTimestamps) {
+    Nullable input(10000);
+    for (std::size_t i = 0; i < input.values.size(); ++i) {
+        input.set(i, 1600000000000000000LL + std::int64_t(i) * 1000 + std::int64_t(i % 7));
+    }
+    expectRoundTrip(input);
+    const PackedInt64Column packed = PackedInt64Column::encode(input.span());
+    EXPECT_EQ(packed.engagedCount(), 10000u);
+    EXPECT_LT(packed.byteSize(), input.values.size() * 2);
+}
+
+TEST(PackedInt64ColumnTest, sparse) {
+    Nullable input(5000);
+    for (std::size_t i = 0; i < input.values.size(); i += 97) {
+        input.set(i, std::int64_t(i % 13) - 6);
+    }
+    expectRoundTrip(input);
+    EXPECT_EQ(PackedInt64Column::encode(input.span()).engagedCount(), 52u);
+}
+
+TEST(PackedInt64ColumnTest, extremes) {
+    Nullable input(600);
+    for (std::size_t i = 0; i < input.values.size(); ++i) {
+        if (i % 3 != 0) {
+            input.set(i,
+                      i % 2 == 0 ? std::numeric_limits<std::int64_t>::min()
+                                 : std::numeric_limits<std::int64_t>::max());
+        }
+    }
+    expectRoundTrip(input);
+}
+
+TEST(PackedInt64ColumnTest, allWidths) {
+    for (unsigned width = 0; width <= 64; ++width) {
+        Nullable input(300);
+        for (std::size_t i = 0; i < input.values.size(); ++i) {
+            const std::uint64_t value = (std::uint64_t(i) * 0x9E3779B97F4A7C15ULL) & detail::lowMask(width);
+            input.set(i, std::int64_t(value));
+        }
+        expectRoundTrip(input);
+    }
+}
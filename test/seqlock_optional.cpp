@@ -0,0 +1,88 @@
+#include "lib-optional/seqlock_optional.hpp"
+
+#include <gmock/gmock.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+/// Every field holds the same value, so a torn read is detectable
+struct Snapshot {
+    std::uint64_t fields[25];
+    std::uint8_t tail;
+
+    explicit Snapshot(std::uint64_t value = 0) noexcept {
+        for (std::uint64_t& field : fields) {
+            field = value;
+        }
+        tail = std::uint8_t(value);
+    }
+
+    bool consistent() const noexcept {
+        for (std::uint64_t field : fields) {
+            if (field != fields[0]) {
+                return false;
+            }
+        }
+        return tail == std::uint8_t(fields[0]);
+    }
+};
+
+} // namespace
+
+TEST(SeqlockOptionalTest, storeLoadReset) {
+    SeqlockOptional<Snapshot> shared;
+    EXPECT_FALSE(shared.load());
+    EXPECT_FALSE(shared.hasValue());
+    EXPECT_EQ(shared.version(), 0u);
+
+    shared.store(Snapshot(7));
+    Optional<Snapshot> loaded = shared.load();
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(loaded->fields[24], 7u);
+    EXPECT_EQ(loaded->tail, 7u);
+    EXPECT_TRUE(shared.hasValue());
+
+    shared.store(Optional<Snapshot>());
+    EXPECT_FALSE(shared.load());
+    EXPECT_EQ(shared.version(), 2u);
+
+    SeqlockOptional<int> initialized(42);
+    EXPECT_EQ(*initialized.load(), 42);
+}
+
+TEST(SeqlockOptionalTest, readersSeeConsistentSnapshots) {
+    SeqlockOptional<Snapshot> shared;
+    std::atomic<bool> done{ false };
+    std::atomic<std::size_t> torn{ 0 };
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&] {
+            std::uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const Optional<Snapshot> snapshot = shared.load();
+                if (snapshot) {
+                    if (!snapshot->consistent() || snapshot->fields[0] < last) {
+                        ++torn;
+                    }
+                    last = snapshot->fields[0];
+                }
+            }
+        });
+    }
+    for (std::uint64_t i = 1; i <= 20000; ++i) {
+        if (i % 100 == 0) {
+            shared.reset();
+        } else {
+            shared.store(Snapshot(i));
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(torn.load(), 0u);
+}
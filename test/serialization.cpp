@@ -0,0 +1,169 @@
+#include "lib-optional/serialization.hpp"
+
+#include <cstdint>
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+using namespace libOptional;
+
+namespace {
+
+struct Point {
+    int x;
+    int y;
+};
+
+/// Trivially copyable type with its own Serializer, stored big-endian
+struct BigEndian {
+    std::uint32_t value;
+};
+
+} // namespace
+
+namespace libOptional {
+
+template <>
+struct Serializer<BigEndian> {
+    template <typename TWriter>
+    static void write(TWriter& writer, const BigEndian& value) {
+        const unsigned char bytes[4] = { static_cast<unsigned char>(value.value >> 24),
+                                         static_cast<unsigned char>(value.value >> 16),
+                                         static_cast<unsigned char>(value.value >> 8),
+                                         static_cast<unsigned char>(value.value) };
+        writer.write(bytes, 4);
+    }
+
+    template <typename TReader>
+    static BigEndian read(TReader& reader) {
+        unsigned char bytes[4];
+        reader.read(bytes, 4);
+        return BigEndian{ std::uint32_t(bytes[0]) << 24 | std::uint32_t(bytes[1]) << 16 |
+                          std::uint32_t(bytes[2]) << 8 | std::uint32_t(bytes[3]) };
+    }
+};
+
+} // namespace libOptional
+
+TEST(SerializationTest, optionalTrivial) {
+    std::vector<unsigned char> buffer;
+    BufferWriter writer(buffer);
+    serialize(writer, Optional<std::int64_t>(42));
+    serialize(writer, Optional<std::int64_t>());
+    EXPECT_EQ(buffer.size(), 1 + sizeof(std::int64_t) + 1);
+
+    BufferReader reader(buffer);
+    Optional<std::int64_t> engaged;
+    Optional<std::int64_t> disengaged(7);
+    deserialize(reader, engaged);
+    deserialize(reader, disengaged);
+    EXPECT_EQ(engaged, std::int64_t(42));
+    EXPECT_FALSE(disengaged);
+    EXPECT_EQ(reader.remaining(), 0u);
+}
+
+TEST(SerializationTest, optionalStruct) {
+    std::vector<unsigned char> buffer;
+    BufferWriter writer(buffer);
+    serialize(writer, Optional<Point>(Point{ 1, 2 }));
+
+    BufferReader reader(buffer);
+    Optional<Point> point = Serializer<Optional<Point>>::read(reader);
+    ASSERT_TRUE(point);
+    EXPECT_EQ(point->x, 1);
+    EXPECT_EQ(point->y, 2);
+}
+
+TEST(SerializationTest, optionalString) {
+    std::vector<unsigned char> buffer;
+    BufferWriter writer(buffer);
+    serialize(writer, Optional<std::string>("hello"));
+    serialize(writer, Optional<std::string>());
+
+    BufferReader reader(buffer);
+    Optional<std::string> first;
+    Optional<std::string> second("x");
+    deserialize(reader, first);
+    deserialize(reader, second);
+    EXPECT_EQ(first, std::string("hello"));
+    EXPECT_FALSE(second);
+}
+
+TEST(SerializationTest, fields) {
+    std::vector<unsigned char> buffer;
+    BufferWriter writer(buffer);
+    const int id = 5;
+    const Optional<double> price(1.5);
+    const Optional<int> quantity;
+    const Optional<std::string> venue("XNAS");
+    serializeFields(writer, id, price, quantity, venue);
+    EXPECT_EQ(buffer.size(), 1 + sizeof(int) + sizeof(double) + sizeof(std::uint64_t) + 4);
+
+    BufferReader reader(buffer);
+    int readId = 0;
+    Optional<double> readPrice;
+    Optional<int> readQuantity(3);
+    Optional<std::string> readVenue;
+    deserializeFields(reader, readId, readPrice, readQuantity, readVenue);
+    EXPECT_EQ(readId, 5);
+    EXPECT_EQ(readPrice, 1.5);
+    EXPECT_FALSE(readQuantity);
+    EXPECT_EQ(readVenue, std::string("XNAS"));
+}
+
+TEST(SerializationTest, manyFieldsPresenceBytes) {
+    std::vector<unsigned char> buffer;
+    BufferWriter writer(buffer);
+    Optional<char> f[9];
+    f[8] = 'z';
+    serializeFields(writer, f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8]);
+    EXPECT_EQ(buffer.size(), 3u);
+
+    BufferReader reader(buffer);
+    Optional<char> g[9];
+    g[0] = 'a';
+    deserializeFields(reader, g[0], g[1], g[2], g[3], g[4], g[5], g[6], g[7], g[8]);
+    EXPECT_FALSE(g[0]);
+    EXPECT_EQ(g[8], 'z');
+}
+
+TEST(SerializationTest, errors) {
+    std::vector<unsigned char> buffer = { 1, 0 };
+    BufferReader reader(buffer);
+    Optional<int> value;
+    EXPECT_THROW(deserialize(reader, value), SerializationError);
+    EXPECT_FALSE(value);
+
+    std::vector<unsigned char> invalid = { 2 };
+    BufferReader invalidReader(invalid);
+    EXPECT_THROW(deserialize(invalidReader, value), SerializationError);
+}
+
+TEST(SerializationTest, specializedTrivialType) {
+    std::vector<unsigned char> buffer;
+    BufferWriter writer(buffer);
+    serialize(writer, Optional<BigEndian>(BigEndian{ 0x01020304 }));
+    serializeFields(writer, Optional<BigEndian>(BigEndian{ 0x0a0b0c0d }));
+    EXPECT_EQ(buffer[1], 0x01);
+    EXPECT_EQ(buffer[4], 0x04);
+
+    // Both Optional paths read through the specialization rather than copying the raw bytes
+    BufferReader reader(buffer);
+    Optional<BigEndian> value;
+    Optional<BigEndian> field;
+    deserialize(reader, value);
+    deserializeFields(reader, field);
+    ASSERT_TRUE(value);
+    ASSERT_TRUE(field);
+    EXPECT_EQ(value->value, 0x01020304u);
+    EXPECT_EQ(field->value, 0x0a0b0c0du);
+}
+
+TEST(SerializationTest, invalidBool) {
+    std::vector<unsigned char> buffer = { 1, 1, 1, 7 };
+    BufferReader reader(buffer);
+    Optional<bool> value;
+    deserialize(reader, value);
+    EXPECT_EQ(value, true);
+    EXPECT_THROW(deserialize(reader, value), SerializationError);
+}
@@ -0,0 +1,118 @@
+#include "lib-optional/set_associative_cache.hpp"
+
+#include "fragile.hpp"
+
+#include <gmock/gmock.h>
+#include <stdexcept>
+#include <string>
+
+using namespace libOptional;
+
+namespace {
+
+/// Sends every key to the same set
+struct ConstantHash {
+    std::size_t operator()(int) const noexcept { return 42; }
+};
+
+} // namespace
+
+TEST(SetAssociativeCacheTest, tagMatching) {
+    std::uint8_t tags[16] = { 0x81, 0x82, 0x81, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x81 };
+    EXPECT_EQ(detail::matchTags<16>(tags, 0x81), 0x8005u);
+    EXPECT_EQ(detail::matchTags<8>(tags, 0x81), 0x05u);
+    EXPECT_EQ(detail::matchTags<4>(tags, 0), 0x08u);
+    EXPECT_EQ(detail::matchTags<16>(tags, 0x81), detail::matchTagsScalar(tags, 16, 0x81));
+    EXPECT_EQ(detail::hashTag(0) & 0x80, 0x80);
+}
+
+TEST(SetAssociativeCacheTest, lookupReturnsReference) {
+    SetAssociativeCache<std::string, std::string, 4> cache(64);
+    EXPECT_EQ(cache.capacity(), 64u);
+    EXPECT_FALSE(cache.lookup("key"));
+    cache.insert("key", std::string("value"));
+    Optional<std::string&> value = cache.lookup("key");
+    ASSERT_TRUE(value);
+    EXPECT_EQ(*value, "value");
+    *value += "!";
+    EXPECT_EQ(*cache.lookup("key"), "value!");
+
+    cache.insert("key", "replaced");
+    EXPECT_EQ(*cache.lookup("key"), "replaced");
+    EXPECT_EQ(cache.size(), 1u);
+
+    EXPECT_TRUE(cache.erase("key"));
+    EXPECT_FALSE(cache.erase("key"));
+    EXPECT_FALSE(cache.lookup("key"));
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(SetAssociativeCacheTest, fullSetEvictsRoundRobin) {
+    SetAssociativeCache<int, int, 8, ConstantHash> cache(64);
+    for (int i = 0; i < 8; ++i) {
+        cache.insert(i, i * 10);
+    }
+    EXPECT_EQ(cache.evictions(), 0u);
+    cache.insert(8, 80);
+    EXPECT_EQ(cache.evictions(), 1u);
+    EXPECT_FALSE(cache.lookup(0));
+    cache.insert(9, 90);
+    EXPECT_FALSE(cache.lookup(1));
+    for (int i = 2; i < 10; ++i) {
+        ASSERT_TRUE(cache.lookup(i));
+        EXPECT_EQ(*cache.lookup(i), i * 10);
+    }
+    EXPECT_EQ(cache.size(), 8u);
+}
+
+TEST(SetAssociativeCacheTest, throwingValueDropsTheWay) {
+    SetAssociativeCache<int, test::Fragile, 2, ConstantHash> cache(2);
+    cache.insert(0, 0);
+    cache.insert(1, 10);
+    // The victim way is dropped rather than mapping the new key to the evicted value
+    EXPECT_THROW(cache.insert(2, -1), std::runtime_error);
+    EXPECT_FALSE(cache.lookup(0));
+    EXPECT_FALSE(cache.lookup(2));
+    EXPECT_EQ(cache.lookup(1)->value, 10);
+    EXPECT_EQ(cache.size(), 1u);
+    cache.insert(2, 20);
+    EXPECT_EQ(cache.lookup(2)->value, 20);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.evictions(), 1u);
+}
+
+TEST(SetAssociativeCacheTest, directMapped) {
+    DirectMappedCache<int, int> cache(16);
+    EXPECT_EQ(cache.ways(), 1u);
+    EXPECT_EQ(cache.capacity(), 16u);
+    for (int i = 0; i < 1000; ++i) {
+        cache.insert(i, -i);
+        ASSERT_TRUE(cache.lookup(i));
+        EXPECT_EQ(*cache.lookup(i), -i);
+    }
+    EXPECT_LE(cache.size(), 16u);
+    EXPECT_EQ(cache.size() + cache.evictions(), 1000u);
+
+    const DirectMappedCache<int, int>& constCache = cache;
+    EXPECT_EQ(*constCache.lookup(999), -999);
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_FALSE(cache.lookup(999));
+}
+
+TEST(SetAssociativeCacheTest, sixteenWays) {
+    SetAssociativeCache<int, int, 16> cache(1024);
+    for (int i = 0; i < 512; ++i) {
+        cache.insert(i, i);
+    }
+    int hits = 0;
+    for (int i = 0; i < 512; ++i) {
+        Optional<int&> value = cache.lookup(i);
+        if (value) {
+            EXPECT_EQ(*value, i);
+            ++hits;
+        }
+    }
+    EXPECT_EQ(std::size_t(hits), cache.size());
+    EXPECT_GT(hits, 480);
+}
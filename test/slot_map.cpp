@@ -0,0 +1,104 @@
+#include "lib-optional/slot_map.hpp"
+
+#include <algorithm>
+#include <gmock/gmock.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace libOptional;
+
+TEST(SlotMapTest, getReturnsReference) {
+    SlotMap<std::string> map;
+    EXPECT_FALSE(map.get(SlotHandle()));
+    const SlotHandle a = map.insert("a");
+    const SlotHandle b = map.emplace(3, 'b');
+    EXPECT_NE(a, b);
+    EXPECT_EQ(map.size(), 2u);
+    Optional<std::string&> value = map.get(b);
+    ASSERT_TRUE(value);
+    EXPECT_EQ(*value, "bbb");
+    *value = "changed";
+    EXPECT_EQ(*map.get(b), "changed");
+
+    const SlotMap<std::string>& constMap = map;
+    EXPECT_EQ(*constMap.get(a), "a");
+}
+
+TEST(SlotMapTest, staleHandlesAreRejected) {
+    SlotMap<int> map;
+    const SlotHandle first = map.insert(1);
+    EXPECT_TRUE(map.erase(first));
+    EXPECT_FALSE(map.erase(first));
+    // The slot is reused with a new generation
+    const SlotHandle second = map.insert(2);
+    EXPECT_EQ(second.index, first.index);
+    EXPECT_NE(second.generation, first.generation);
+    EXPECT_FALSE(map.get(first));
+    EXPECT_FALSE(map.contains(first));
+    EXPECT_EQ(*map.get(second), 2);
+    EXPECT_EQ(map.slotCount(), 1u);
+    EXPECT_FALSE(map.get(SlotHandle{ 5, 1 }));
+}
+
+TEST(SlotMapTest, lowestFreeSlotIsReused) {
+    SlotMap<int> map;
+    std::vector<SlotHandle> handles;
+    for (int i = 0; i < 200; ++i) {
+        handles.push_back(map.insert(i));
+    }
+    map.erase(handles[150]);
+    map.erase(handles[70]);
+    map.erase(handles[130]);
+    EXPECT_EQ(map.insert(-1).index, 70u);
+    EXPECT_EQ(map.insert(-2).index, 130u);
+    EXPECT_EQ(map.insert(-3).index, 150u);
+    EXPECT_EQ(map.insert(-4).index, 200u);
+}
+
+TEST(SlotMapTest, iterationIsDenseOverLiveValues) {
+    SlotMap<int> map;
+    std::vector<SlotHandle> handles;
+    for (int i = 0; i < 10; ++i) {
+        handles.push_back(map.insert(i));
+    }
+    for (int i = 0; i < 10; i += 2) {
+        map.erase(handles[std::size_t(i)]);
+    }
+    std::vector<int> values(map.begin(), map.end());
+    std::sort(values.begin(), values.end());
+    EXPECT_THAT(values, ::testing::ElementsAre(1, 3, 5, 7, 9));
+    for (std::size_t i = 0; i < map.size(); ++i) {
+        EXPECT_EQ(*map.get(map.handleAt(i)), map.data()[i]);
+    }
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.get(handles[1]));
+}
+
+TEST(SlotMapTest, randomOperationsKeepHandlesConsistent) {
+    SlotMap<std::unique_ptr<int>> map;
+    std::vector<std::pair<SlotHandle, int>> live;
+    std::vector<SlotHandle> dead;
+    std::mt19937 random(3);
+    for (int i = 0; i < 5000; ++i) {
+        if (live.empty() || random() % 3 != 0) {
+            live.emplace_back(map.emplace(new int(i)), i);
+        } else {
+            const std::size_t victim = random() % live.size();
+            ASSERT_TRUE(map.erase(live[victim].first));
+            dead.push_back(live[victim].first);
+            live[victim] = live.back();
+            live.pop_back();
+        }
+    }
+    ASSERT_EQ(map.size(), live.size());
+    for (const auto& entry : live) {
+        ASSERT_TRUE(map.get(entry.first));
+        EXPECT_EQ(**map.get(entry.first), entry.second);
+    }
+    for (const SlotHandle& handle : dead) {
+        EXPECT_FALSE(map.get(handle));
+    }
+}
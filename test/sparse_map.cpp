@@ -0,0 +1,121 @@
+#include "lib-optional/sparse_map.hpp"
+
+#include <algorithm>
+#include <gmock/gmock.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace libOptional;
+
+TEST(SparseMapTest, findReturnsReference) {
+    SparseMap<std::string> map;
+    EXPECT_FALSE(map.find(0));
+    map.insert(7, "seven");
+    EXPECT_TRUE(map.tryEmplace(3, 2, 'x').second);
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_FALSE(map.find(0));
+    EXPECT_FALSE(map.find(5));
+    Optional<std::string&> value = map.find(3);
+    ASSERT_TRUE(value);
+    EXPECT_EQ(*value, "xx");
+    *value = "changed";
+    EXPECT_EQ(*map.find(3), "changed");
+
+    const SparseMap<std::string>& constMap = map;
+    EXPECT_EQ(*constMap.find(7), "seven");
+    EXPECT_TRUE(constMap.contains(7));
+    EXPECT_FALSE(constMap.contains(8));
+}
+
+TEST(SparseMapTest, tryEmplaceKeepsPresentValue) {
+    SparseMap<std::string> map;
+    map.insert(1, "a");
+    std::string replacement = "replacement";
+    std::pair<std::string&, bool> result = map.tryEmplace(1, std::move(replacement));
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(result.first, "a");
+    EXPECT_EQ(replacement, "replacement");
+
+    // insert() assigns to the present value
+    EXPECT_EQ(map.insert(1, "b"), "b");
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_EQ(*map.find(1), "b");
+}
+
+TEST(SparseMapTest, eraseMovesLastValueIntoHole) {
+    SparseMap<int> map;
+    for (std::uint32_t id = 0; id < 5; ++id) {
+        map.insert(id * 10, int(id));
+    }
+    EXPECT_TRUE(map.erase(10));
+    EXPECT_FALSE(map.erase(10));
+    EXPECT_FALSE(map.erase(11));
+    EXPECT_FALSE(map.find(10));
+    EXPECT_EQ(map.size(), 4u);
+    // The value of id 40 took the place of the erased one
+    EXPECT_EQ(map.ids()[1], 40u);
+    EXPECT_EQ(map.values()[1], 4);
+    EXPECT_EQ(*map.find(40), 4);
+
+    // Erasing the last value leaves the others where they are
+    EXPECT_TRUE(map.erase(30));
+    EXPECT_EQ(std::vector<int>(map.begin(), map.end()), (std::vector<int>{ 0, 4, 2 }));
+}
+
+TEST(SparseMapTest, largeIdsOnlyAllocateTheirPages) {
+    SparseMap<int> map;
+    const std::uint32_t large = 0xfffffffeu;
+    map.insert(large, 1);
+    map.insert(5, 2);
+    EXPECT_EQ(*map.find(large), 1);
+    EXPECT_FALSE(map.find(large - 1));
+    EXPECT_FALSE(map.find(0xffffffffu));
+    EXPECT_FALSE(map.find(SparseMap<int>::PageSize * 7));
+    EXPECT_LT(map.memoryUsage(), std::size_t(1) << 24);
+}
+
+TEST(SparseMapTest, clearKeepsMapUsable) {
+    SparseMap<int> map;
+    for (std::uint32_t id = 0; id < 100; ++id) {
+        map.insert(id * 3, int(id));
+    }
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.find(3));
+    map.insert(3, 42);
+    EXPECT_EQ(*map.find(3), 42);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(SparseMapTest, matchesStdMap) {
+    SparseMap<int> map;
+    std::map<std::uint32_t, int> reference;
+    std::mt19937 random(7);
+    for (int i = 0; i < 20000; ++i) {
+        const std::uint32_t id = random() % 10000;
+        if (random() % 3 == 0) {
+            EXPECT_EQ(map.erase(id), reference.erase(id) == 1);
+        } else {
+            map.insert(id, i);
+            reference[id] = i;
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    for (std::uint32_t id = 0; id < 10000; ++id) {
+        const auto it = reference.find(id);
+        const Optional<int&> value = map.find(id);
+        ASSERT_EQ(bool(value), it != reference.end());
+        if (value) {
+            EXPECT_EQ(*value, it->second);
+        }
+    }
+    std::vector<std::uint32_t> ids(map.ids(), map.ids() + map.size());
+    std::sort(ids.begin(), ids.end());
+    std::vector<std::uint32_t> expected;
+    for (const auto& entry : reference) {
+        expected.push_back(entry.first);
+    }
+    EXPECT_EQ(ids, expected);
+}
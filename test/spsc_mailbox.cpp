@@ -0,0 +1,102 @@
+#include "lib-optional/spsc_mailbox.hpp"
+
+#include "fragile.hpp"
+
+#include <gmock/gmock.h>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+using namespace libOptional;
+
+TEST(SpscMailboxTest, reject) {
+    SpscMailbox<std::unique_ptr<int>> mailbox;
+    EXPECT_FALSE(mailbox.full());
+    EXPECT_TRUE(mailbox.tryPut(std::unique_ptr<int>(new int(1))));
+    EXPECT_TRUE(mailbox.full());
+    EXPECT_FALSE(mailbox.tryPut(std::unique_ptr<int>(new int(2))));
+
+    Optional<std::unique_ptr<int>> taken = mailbox.tryTake();
+    ASSERT_TRUE(taken);
+    EXPECT_EQ(**taken, 1);
+    EXPECT_FALSE(mailbox.full());
+    EXPECT_FALSE(mailbox.tryTake());
+    EXPECT_EQ(mailbox.takenCount(), 1u);
+}
+
+TEST(SpscMailboxTest, overwrite) {
+    SpscMailbox<std::string, MailboxMode::Overwrite> mailbox;
+    const std::string first = "first";
+    EXPECT_TRUE(mailbox.tryPut(first));
+    EXPECT_TRUE(mailbox.tryPut(std::string("second")));
+    EXPECT_EQ(mailbox.overwrittenCount(), 1u);
+    EXPECT_EQ(*mailbox.tryTake(), "second");
+    EXPECT_FALSE(mailbox.tryTake());
+}
+
+TEST(SpscMailboxTest, throwingCopyLeavesMailboxUsable) {
+    SpscMailbox<test::Fragile, MailboxMode::Overwrite> mailbox;
+    const test::Fragile fragile(0, true);
+    EXPECT_THROW(mailbox.tryPut(fragile), std::runtime_error);
+    EXPECT_FALSE(mailbox.full());
+    EXPECT_TRUE(mailbox.tryPut(test::Fragile(1)));
+    // Replacing the unread message fails after it was destroyed, the slot ends up empty
+    EXPECT_THROW(mailbox.tryPut(fragile), std::runtime_error);
+    EXPECT_FALSE(mailbox.full());
+    EXPECT_FALSE(mailbox.tryTake());
+    EXPECT_TRUE(mailbox.tryPut(test::Fragile(2)));
+    EXPECT_TRUE(mailbox.tryPut(test::Fragile(3)));
+    Optional<test::Fragile> taken = mailbox.tryTake();
+    ASSERT_TRUE(taken);
+    EXPECT_EQ(taken->value, 3);
+}
+
+TEST(SpscMailboxTest, sidesOnSeparateCacheLines) {
+    EXPECT_GE(sizeof(SpscMailbox<int>), 3 * detail::CacheLineSize);
+    EXPECT_EQ(alignof(SpscMailbox<int>), detail::CacheLineSize);
+}
+
+TEST(SpscMailboxTest, rejectDeliversEverythingInOrder) {
+    SpscMailbox<std::uint64_t> mailbox;
+    const std::uint64_t count = 100000;
+    std::thread producer([&] {
+        for (std::uint64_t i = 1; i <= count; ++i) {
+            while (!mailbox.tryPut(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::uint64_t expected = 1;
+    while (expected <= count) {
+        Optional<std::uint64_t> value = mailbox.tryTake();
+        if (value) {
+            ASSERT_EQ(*value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+TEST(SpscMailboxTest, overwriteKeepsLatest) {
+    SpscMailbox<std::uint64_t, MailboxMode::Overwrite> mailbox;
+    const std::uint64_t count = 100000;
+    std::thread producer([&] {
+        for (std::uint64_t i = 1; i <= count; ++i) {
+            mailbox.tryPut(i);
+        }
+    });
+    std::uint64_t last = 0;
+    while (last != count) {
+        Optional<std::uint64_t> value = mailbox.tryTake();
+        if (value) {
+            ASSERT_GT(*value, last);
+            last = *value;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_EQ(mailbox.takenCount() + mailbox.overwrittenCount(), count);
+}
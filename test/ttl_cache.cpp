@@ -0,0 +1,153 @@
+#include "lib-optional/ttl_cache.hpp"
+
+#include "fragile.hpp"
+
+#include <chrono>
+#include <gmock/gmock.h>
+#include <stdexcept>
+#include <string>
+
+using namespace libOptional;
+
+namespace {
+
+/// Clock that only moves when the test says so
+struct ManualClock {
+    using duration = std::chrono::milliseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+
+    time_point now() const noexcept { return time_point(*current); }
+
+    const duration* current;
+};
+
+using Cache = TtlCache<int, std::string, ManualClock>;
+
+} // namespace
+
+TEST(TtlCacheTest, expiredEntriesAreNotReturned) {
+    std::chrono::milliseconds now(1000);
+    Cache cache(16, std::chrono::milliseconds(100), ManualClock{ &now });
+    cache.put(1, "one");
+    cache.put(2, std::string("two"), std::chrono::milliseconds(300));
+    Optional<std::string&> value = cache.get(1);
+    ASSERT_TRUE(value);
+    *value += "!";
+    EXPECT_EQ(*cache.get(1), "one!");
+
+    now += std::chrono::milliseconds(99);
+    EXPECT_TRUE(cache.get(1));
+    now += std::chrono::milliseconds(1);
+    EXPECT_FALSE(cache.get(1));
+    EXPECT_EQ(*cache.get(2), "two");
+    EXPECT_EQ(cache.size(), 1u);
+    now += std::chrono::milliseconds(200);
+    EXPECT_FALSE(cache.get(2));
+    EXPECT_TRUE(cache.empty());
+}
+
+TEST(TtlCacheTest, wheelRemovesExpiredEntries) {
+    std::chrono::milliseconds now(0);
+    Cache cache(1024, std::chrono::milliseconds(2560), ManualClock{ &now });
+    for (int i = 0; i < 60; ++i) {
+        now = std::chrono::milliseconds(i * 10);
+        cache.put(i, std::to_string(i));
+    }
+    EXPECT_EQ(cache.expire(), 0u);
+    // Entry i expires at 2560 + 10i, in tick 256 + i of 10ms
+    now = std::chrono::milliseconds(2665);
+    EXPECT_EQ(cache.expire(), 10u);
+    EXPECT_EQ(cache.size(), 50u);
+    EXPECT_FALSE(cache.get(9));
+    // Expired but in the current tick, only get() notices
+    EXPECT_FALSE(cache.get(10));
+    EXPECT_EQ(*cache.get(11), "11");
+    // Far more than a wheel turn later everything is gone
+    now = std::chrono::milliseconds(1000000);
+    EXPECT_EQ(cache.expire(), 49u);
+    EXPECT_TRUE(cache.empty());
+}
+
+TEST(TtlCacheTest, longTtlSurvivesWheelTurns) {
+    std::chrono::milliseconds now(0);
+    Cache cache(16, std::chrono::milliseconds(256), ManualClock{ &now });
+    // 1ms ticks and 1024 buckets, the two entries share a bucket
+    cache.put(1, "long", std::chrono::milliseconds(1400));
+    cache.put(2, "short", std::chrono::milliseconds(376));
+    now = std::chrono::milliseconds(400);
+    EXPECT_EQ(cache.expire(), 1u);
+    EXPECT_EQ(*cache.get(1), "long");
+    now = std::chrono::milliseconds(1401);
+    EXPECT_EQ(cache.expire(), 1u);
+    EXPECT_FALSE(cache.get(1));
+}
+
+TEST(TtlCacheTest, putRefreshesTheExpiry) {
+    std::chrono::milliseconds now(0);
+    Cache cache(4, std::chrono::milliseconds(100), ManualClock{ &now });
+    cache.put(1, "old");
+    now = std::chrono::milliseconds(90);
+    cache.put(1, "new");
+    now = std::chrono::milliseconds(150);
+    EXPECT_EQ(cache.expire(), 0u);
+    EXPECT_EQ(*cache.get(1), "new");
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_FALSE(cache.erase(1));
+}
+
+TEST(TtlCacheTest, fullCacheEvictsTheEntryExpiringNext) {
+    std::chrono::milliseconds now(0);
+    Cache cache(3, std::chrono::milliseconds(640), ManualClock{ &now });
+    cache.put(1, "1", std::chrono::milliseconds(300));
+    cache.put(2, "2", std::chrono::milliseconds(100));
+    cache.put(3, "3", std::chrono::milliseconds(200));
+    cache.put(4, "4");
+    EXPECT_EQ(cache.evictions(), 1u);
+    EXPECT_FALSE(cache.get(2));
+    EXPECT_TRUE(cache.get(1));
+    EXPECT_TRUE(cache.get(3));
+    EXPECT_TRUE(cache.get(4));
+
+    EXPECT_THROW(Cache(0, std::chrono::milliseconds(1), ManualClock{ &now }), std::invalid_argument);
+    EXPECT_THROW(Cache(1, std::chrono::milliseconds(0), ManualClock{ &now }), std::invalid_argument);
+}
+
+TEST(TtlCacheTest, putRejectsNonPositiveTtl) {
+    std::chrono::milliseconds now(1000);
+    Cache cache(4, std::chrono::milliseconds(100), ManualClock{ &now });
+    cache.put(1, "one");
+    EXPECT_THROW(cache.put(1, "zero", std::chrono::milliseconds(0)), std::invalid_argument);
+    EXPECT_THROW(cache.put(2, "past", std::chrono::milliseconds(-50)), std::invalid_argument);
+    EXPECT_EQ(*cache.get(1), "one");
+    EXPECT_FALSE(cache.get(2));
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(TtlCacheTest, throwingValueKeepsTheFreeNode) {
+    std::chrono::milliseconds now(1000);
+    TtlCache<int, test::Fragile, ManualClock> cache(
+        2, std::chrono::milliseconds(100), ManualClock{ &now });
+    cache.put(1, 10, std::chrono::milliseconds(50));
+    EXPECT_THROW(cache.put(2, -1), std::runtime_error);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_FALSE(cache.get(2));
+    // The failed entry never reached the wheel and its node is taken by the next put()
+    cache.put(2, 20);
+    EXPECT_EQ(cache.evictions(), 0u);
+    now += std::chrono::milliseconds(50);
+    EXPECT_FALSE(cache.get(1));
+    EXPECT_EQ(cache.get(2)->value, 20);
+    now += std::chrono::milliseconds(50);
+    EXPECT_FALSE(cache.get(2));
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(TtlCacheTest, steadyClock) {
+    TtlCache<int, int> cache(8, std::chrono::seconds(60));
+    cache.put(1, 10);
+    EXPECT_EQ(*cache.get(1), 10);
+    EXPECT_EQ(cache.ttl(), std::chrono::seconds(60));
+}
@@ -0,0 +1,82 @@
+#include "lib-optional/work_stealing_deque.hpp"
+
+#include <gmock/gmock.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace libOptional;
+
+TEST(WorkStealingDequeTest, popIsLifoStealIsFifo) {
+    WorkStealingDeque<int> deque(4);
+    EXPECT_FALSE(deque.pop());
+    EXPECT_FALSE(deque.steal());
+    for (int i = 0; i < 5; ++i) {
+        deque.push(i);
+    }
+    EXPECT_EQ(deque.sizeApprox(), 5u);
+    EXPECT_EQ(*deque.pop(), 4);
+    EXPECT_EQ(*deque.steal(), 0);
+    EXPECT_EQ(*deque.steal(), 1);
+    EXPECT_EQ(*deque.pop(), 3);
+    EXPECT_EQ(*deque.pop(), 2);
+    EXPECT_FALSE(deque.pop());
+    EXPECT_FALSE(deque.steal());
+    EXPECT_TRUE(deque.emptyApprox());
+}
+
+TEST(WorkStealingDequeTest, grows) {
+    WorkStealingDeque<std::size_t> deque(2);
+    EXPECT_EQ(deque.capacity(), 2u);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        deque.push(i);
+        if (i % 3 == 0) {
+            EXPECT_EQ(*deque.steal(), i / 3);
+        }
+    }
+    EXPECT_GE(deque.capacity(), 512u);
+    EXPECT_EQ(*deque.pop(), 999u);
+}
+
+TEST(WorkStealingDequeTest, everyElementIsTakenOnce) {
+    const int count = 50000;
+    WorkStealingDeque<int> deque(8);
+    std::vector<std::atomic<int>> taken(count);
+    for (std::atomic<int>& flag : taken) {
+        flag = 0;
+    }
+    std::atomic<bool> done{ false };
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; ++i) {
+        thieves.emplace_back([&] {
+            while (!done.load()) {
+                if (Optional<int> value = deque.steal()) {
+                    ++taken[*value];
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int i = 0; i < count; ++i) {
+        deque.push(i);
+        if (i % 2 == 0) {
+            if (Optional<int> value = deque.pop()) {
+                ++taken[*value];
+            }
+        }
+    }
+    while (Optional<int> value = deque.pop()) {
+        ++taken[*value];
+    }
+    while (!deque.emptyApprox()) {
+        std::this_thread::yield();
+    }
+    done = true;
+    for (std::thread& thief : thieves) {
+        thief.join();
+    }
+    for (int i = 0; i < count; ++i) {
+        ASSERT_EQ(taken[i].load(), 1) << i;
+    }
+}